@@ -24,6 +24,7 @@
 #include "physics/ChBody.h"
 #include "physics/ChContactContainerBase.h"
 #include "physics/ChProximityContainerBase.h"
+#include "parallel/ChOpenMP.h"
 #include "LinearMath/btPoolAllocator.h"
 #include "BulletCollision/CollisionShapes/btSphereShape.h"
 #include "BulletCollision/CollisionShapes/btCylinderShape.h"
@@ -258,70 +259,104 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainerBase* mcontactcon
     // This should remove all old contacts (or at least rewind the index)
     mcontactcontainer->BeginAddContact();
 
+    int numManifolds = bt_collision_world->getDispatcher()->getNumManifolds();
+
+    // The manifolds are split in contiguous chunks, one per thread, and each thread
+    // fills its own buffer of contacts: appending the buffers in order gives the same
+    // contacts, in the same order, of a serial loop. The custom callbacks, if any,
+    // might not be thread safe, so in such case a single thread is used.
+    bool parallel = (numManifolds > CH_CONTACTS_PARALLEL) && !this->broad_callback && !this->narrow_callback;
+    int nthreads = parallel ? CHOMPfunctions::GetMaxThreads() : 1;
+    if ((int)thread_contacts.size() < nthreads)
+        thread_contacts.resize(nthreads);
+    for (unsigned int it = 0; it < thread_contacts.size(); it++)
+        thread_contacts[it].clear();
+
+#pragma omp parallel num_threads(nthreads) if (parallel)
+    {
+        int ithread = CHOMPfunctions::GetThreadNum();
+        int nchunks = CHOMPfunctions::GetNumThreads();
+        int begin = (int)(((long long)numManifolds * ithread) / nchunks);
+        int end = (int)(((long long)numManifolds * (ithread + 1)) / nchunks);
+        for (int i = begin; i < end; i++)
+            ReportManifold(bt_collision_world->getDispatcher()->getManifoldByIndexInternal(i),
+                           thread_contacts[ithread]);
+    }
+
+    // Add all the contacts to the container, in one pass
+    if (nthreads == 1) {
+        mcontactcontainer->AddContacts(thread_contacts[0]);
+    } else {
+        contacts.clear();
+        for (int it = 0; it < nthreads; it++)
+            contacts.insert(contacts.end(), thread_contacts[it].begin(), thread_contacts[it].end());
+        mcontactcontainer->AddContacts(contacts);
+    }
+
+    mcontactcontainer->EndAddContact();
+}
+
+void ChCollisionSystemBullet::ReportManifold(btPersistentManifold* contactManifold,
+                                             std::vector<ChCollisionInfo>& mcontacts) {
     ChCollisionInfo icontact;
 
-    int numManifolds = bt_collision_world->getDispatcher()->getNumManifolds();
-    for (int i = 0; i < numManifolds; i++) {
-        btPersistentManifold* contactManifold = bt_collision_world->getDispatcher()->getManifoldByIndexInternal(i);
-        btCollisionObject* obA = static_cast<btCollisionObject*>(contactManifold->getBody0());
-        btCollisionObject* obB = static_cast<btCollisionObject*>(contactManifold->getBody1());
-        contactManifold->refreshContactPoints(obA->getWorldTransform(), obB->getWorldTransform());
+    btCollisionObject* obA = static_cast<btCollisionObject*>(contactManifold->getBody0());
+    btCollisionObject* obB = static_cast<btCollisionObject*>(contactManifold->getBody1());
+    contactManifold->refreshContactPoints(obA->getWorldTransform(), obB->getWorldTransform());
 
-        icontact.modelA = (ChCollisionModel*)obA->getUserPointer();
-        icontact.modelB = (ChCollisionModel*)obB->getUserPointer();
+    icontact.modelA = (ChCollisionModel*)obA->getUserPointer();
+    icontact.modelB = (ChCollisionModel*)obB->getUserPointer();
 
-        double envelopeA = icontact.modelA->GetEnvelope();
-        double envelopeB = icontact.modelB->GetEnvelope();
+    double envelopeA = icontact.modelA->GetEnvelope();
+    double envelopeB = icontact.modelB->GetEnvelope();
 
-        double marginA = icontact.modelA->GetSafeMargin();
-        double marginB = icontact.modelB->GetSafeMargin();
+    double marginA = icontact.modelA->GetSafeMargin();
+    double marginB = icontact.modelB->GetSafeMargin();
 
-        // Execute custom broadphase callback, if any
-        bool do_narrow_contactgeneration = true;
-        if (this->broad_callback)
-            do_narrow_contactgeneration = this->broad_callback->BroadCallback(icontact.modelA, icontact.modelB);
+    // Execute custom broadphase callback, if any
+    bool do_narrow_contactgeneration = true;
+    if (this->broad_callback)
+        do_narrow_contactgeneration = this->broad_callback->BroadCallback(icontact.modelA, icontact.modelB);
 
-        if (do_narrow_contactgeneration) {
-            int numContacts = contactManifold->getNumContacts();
+    if (do_narrow_contactgeneration) {
+        int numContacts = contactManifold->getNumContacts();
 
-            for (int j = 0; j < numContacts; j++) {
-                btManifoldPoint& pt = contactManifold->getContactPoint(j);
+        for (int j = 0; j < numContacts; j++) {
+            btManifoldPoint& pt = contactManifold->getContactPoint(j);
 
-                if (pt.getDistance() <
-                    marginA + marginB)  // to discard "too far" constraints (the Bullet engine also has its threshold)
-                {
-                    btVector3 ptA = pt.getPositionWorldOnA();
-                    btVector3 ptB = pt.getPositionWorldOnB();
+            if (pt.getDistance() <
+                marginA + marginB)  // to discard "too far" constraints (the Bullet engine also has its threshold)
+            {
+                btVector3 ptA = pt.getPositionWorldOnA();
+                btVector3 ptB = pt.getPositionWorldOnB();
 
-                    icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
-                    icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
+                icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
+                icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
 
-                    icontact.vN.Set(-pt.m_normalWorldOnB.getX(), -pt.m_normalWorldOnB.getY(),
-                                    -pt.m_normalWorldOnB.getZ());
-                    icontact.vN.Normalize();
+                icontact.vN.Set(-pt.m_normalWorldOnB.getX(), -pt.m_normalWorldOnB.getY(),
+                                -pt.m_normalWorldOnB.getZ());
+                icontact.vN.Normalize();
 
-                    double ptdist = pt.getDistance();
+                double ptdist = pt.getDistance();
 
-                    icontact.vpA = icontact.vpA - icontact.vN * envelopeA;
-                    icontact.vpB = icontact.vpB + icontact.vN * envelopeB;
-                    icontact.distance = ptdist + envelopeA + envelopeB;
+                icontact.vpA = icontact.vpA - icontact.vN * envelopeA;
+                icontact.vpB = icontact.vpB + icontact.vN * envelopeB;
+                icontact.distance = ptdist + envelopeA + envelopeB;
 
-                    icontact.reaction_cache = pt.reactions_cache;
+                icontact.reaction_cache = pt.reactions_cache;
 
-                    // Execute some user custom callback, if any
-                    if (this->narrow_callback)
-                        this->narrow_callback->NarrowCallback(icontact);
+                // Execute some user custom callback, if any
+                if (this->narrow_callback)
+                    this->narrow_callback->NarrowCallback(icontact);
 
-                    // Add to contact container
-                    mcontactcontainer->AddContact(icontact);
-                }
+                // Add to the buffer of contacts
+                mcontacts.push_back(icontact);
             }
         }
-
-        // you can un-comment out this line, and then all points are removed
-        // contactManifold->clearManifold();
     }
-    mcontactcontainer->EndAddContact();
+
+    // you can un-comment out this line, and then all points are removed
+    // contactManifold->clearManifold();
 }
 
 void ChCollisionSystemBullet::ReportProximities(ChProximityContainerBase* mproximitycontainer) {
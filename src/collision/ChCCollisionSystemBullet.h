@@ -27,8 +27,11 @@
 // ------------------------------------------------
 ///////////////////////////////////////////////////
 
+#include <vector>
+
 #include "core/ChApiCE.h"
 #include "collision/ChCCollisionSystem.h"
+#include "collision/ChCCollisionInfo.h"
 #include "collision/bullet/btBulletCollisionCommon.h"
 
 namespace chrono {
@@ -70,8 +73,10 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     /// ChContactContainerBase. For instance ChSystem, after each Run()
     /// collision detection, calls this method multiple times for all contact containers in the system,
     /// The basic behavior of the implementation is the following: collision system
-    /// will call in sequence the functions BeginAddContact(), AddContact() (x n times),
+    /// will call in sequence the functions BeginAddContact(), AddContacts(),
     /// EndAddContact() of the contact container.
+    /// With many contact manifolds, these are processed in parallel, unless
+    /// some custom broadphase or narrowphase callback is set.
     virtual void ReportContacts(ChContactContainerBase* mcontactcontainer);
 
     /// After the Run() has completed, you can call this function to
@@ -99,6 +104,12 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     btCollisionDispatcher* bt_dispatcher;
     btBroadphaseInterface* bt_broadphase;
     btCollisionWorld* bt_collision_world;
+
+    std::vector<std::vector<ChCollisionInfo> > thread_contacts;  // contacts found by each thread
+    std::vector<ChCollisionInfo> contacts;                        // contacts of all threads
+
+    // Append to mcontacts the points of a contact manifold
+    void ReportManifold(btPersistentManifold* contactManifold, std::vector<ChCollisionInfo>& mcontacts);
 };
 
 }  // END_OF_NAMESPACE____
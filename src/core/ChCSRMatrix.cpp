@@ -0,0 +1,246 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#include <algorithm>
+
+#include "core/ChCSRMatrix.h"
+
+namespace chrono {
+
+// Order of the pending triplets, by row and then by column
+struct ChCSRTripletLess {
+    template <class T>
+    bool operator()(const T& a, const T& b) const {
+        return a.row < b.row || (a.row == b.row && a.col < b.col);
+    }
+};
+
+ChCSRMatrix::ChCSRMatrix() {
+    Reset(0, 0);
+}
+
+ChCSRMatrix::ChCSRMatrix(int row, int col) {
+    Reset(row, col);
+}
+
+void ChCSRMatrix::Reset(int row, int col) {
+    assert(row >= 0 && col >= 0);
+    rows = row;
+    columns = col;
+    row_index.assign(row + 1, 0);
+    col_index.clear();
+    values.clear();
+    triplets.clear();
+}
+
+void ChCSRMatrix::ResetBlocks(int row, int col) {
+    if (row != rows || col != columns) {
+        Reset(row, col);
+        return;
+    }
+    Compress();
+    std::fill(values.begin(), values.end(), 0.0);
+}
+
+int ChCSRMatrix::GetNNZ() {
+    Compress();
+    return (int)values.size();
+}
+
+int ChCSRMatrix::FindElement(int row, int col) const {
+    std::vector<int>::const_iterator first = col_index.begin() + row_index[row];
+    std::vector<int>::const_iterator last = col_index.begin() + row_index[row + 1];
+    std::vector<int>::const_iterator found = std::lower_bound(first, last, col);
+    if (found == last || *found != col)
+        return -1;
+    return (int)(found - col_index.begin());
+}
+
+void ChCSRMatrix::SetElement(int row, int col, double elem) {
+    assert(row >= 0 && row < rows && col >= 0 && col < columns);
+
+    // Changing a stored element is only safe if no pending triplet may refer to it
+    if (triplets.empty()) {
+        int index = FindElement(row, col);
+        if (index >= 0) {
+            values[index] = elem;
+            return;
+        }
+        if (elem == 0)
+            return;
+    }
+
+    Triplet mtriplet = {row, col, elem, false};
+    triplets.push_back(mtriplet);
+}
+
+void ChCSRMatrix::AddElement(int row, int col, double elem) {
+    assert(row >= 0 && row < rows && col >= 0 && col < columns);
+
+    if (triplets.empty()) {
+        int index = FindElement(row, col);
+        if (index >= 0) {
+            values[index] += elem;
+            return;
+        }
+    }
+
+    Triplet mtriplet = {row, col, elem, true};
+    triplets.push_back(mtriplet);
+}
+
+double ChCSRMatrix::GetElement(int row, int col) {
+    assert(row >= 0 && row < rows && col >= 0 && col < columns);
+    Compress();
+    int index = FindElement(row, col);
+    return index >= 0 ? values[index] : 0;
+}
+
+void ChCSRMatrix::Compress() {
+    if (triplets.empty())
+        return;
+
+    // the triplets of a same element keep the order they were set in
+    std::stable_sort(triplets.begin(), triplets.end(), ChCSRTripletLess());
+
+    std::vector<int> new_row_index(rows + 1);
+    std::vector<int> new_col_index;
+    std::vector<double> new_values;
+    new_col_index.reserve(values.size() + triplets.size());
+    new_values.reserve(values.size() + triplets.size());
+
+    // merge, row by row, the stored elements with the triplets
+    size_t t = 0;
+    for (int i = 0; i < rows; i++) {
+        new_row_index[i] = (int)new_values.size();
+        int k = row_index[i];
+        int kend = row_index[i + 1];
+        while (k < kend || (t < triplets.size() && triplets[t].row == i)) {
+            bool stored = k < kend;
+            bool pending = t < triplets.size() && triplets[t].row == i;
+            int col = (stored && (!pending || col_index[k] <= triplets[t].col)) ? col_index[k] : triplets[t].col;
+            double val = 0;
+            if (stored && col_index[k] == col) {
+                val = values[k];
+                k++;
+            }
+            for (; t < triplets.size() && triplets[t].row == i && triplets[t].col == col; t++) {
+                val = triplets[t].add ? val + triplets[t].val : triplets[t].val;
+            }
+            new_col_index.push_back(col);
+            new_values.push_back(val);
+        }
+    }
+    new_row_index[rows] = (int)new_values.size();
+
+    row_index.swap(new_row_index);
+    col_index.swap(new_col_index);
+    values.swap(new_values);
+    triplets.clear();
+}
+
+void ChCSRMatrix::MatrMultiply(const ChMatrix<>& x, ChMatrix<>& y) {
+    assert(x.GetRows() == columns && x.GetColumns() == 1);
+    Compress();
+    y.Reset(rows, 1);
+
+#pragma omp parallel for if (rows > CH_OMP_MATRLIGHT)
+    for (int i = 0; i < rows; i++) {
+        double sum = 0;
+        for (int k = row_index[i]; k < row_index[i + 1]; k++)
+            sum += values[k] * x.ElementN(col_index[k]);
+        y.ElementN(i) = sum;
+    }
+}
+
+void ChCSRMatrix::MatrTMultiply(const ChMatrix<>& x, ChMatrix<>& y) {
+    assert(x.GetRows() == rows && x.GetColumns() == 1);
+    Compress();
+    y.Reset(columns, 1);
+
+    for (int i = 0; i < rows; i++) {
+        double xi = x.ElementN(i);
+        if (!xi)
+            continue;
+        for (int k = row_index[i]; k < row_index[i + 1]; k++)
+            y.ElementN(col_index[k]) += values[k] * xi;
+    }
+}
+
+void ChCSRMatrix::Transpose(ChCSRMatrix& mtransp) {
+    assert(&mtransp != this);
+    Compress();
+    mtransp.Reset(columns, rows);
+
+    // count the nonzeros of each column, then scatter the rows in order,
+    // so that the columns of the transpose stay sorted
+    std::vector<int>& trow_index = mtransp.row_index;
+    for (size_t k = 0; k < col_index.size(); k++)
+        trow_index[col_index[k] + 1]++;
+    for (int j = 0; j < columns; j++)
+        trow_index[j + 1] += trow_index[j];
+
+    mtransp.col_index.resize(values.size());
+    mtransp.values.resize(values.size());
+    std::vector<int> next(trow_index.begin(), trow_index.end() - 1);
+    for (int i = 0; i < rows; i++) {
+        for (int k = row_index[i]; k < row_index[i + 1]; k++) {
+            int dest = next[col_index[k]]++;
+            mtransp.col_index[dest] = i;
+            mtransp.values[dest] = values[k];
+        }
+    }
+}
+
+void ChCSRMatrix::CopyFromMatrix(ChMatrix<>* matra) {
+    Reset(matra->GetRows(), matra->GetColumns());
+    PasteMatrix(matra, 0, 0);
+    Compress();
+}
+
+void ChCSRMatrix::CopyFromMatrix(ChSparseMatrix* matra) {
+    Reset(matra->GetRows(), matra->GetColumns());
+    for (int i = 0; i < matra->GetRows(); i++) {
+        row_index[i] = (int)values.size();
+        for (ChMelement* el = matra->GetElarrayMel(i); el != NULL; el = el->next) {
+            if (el->val) {
+                col_index.push_back(el->col);
+                values.push_back(el->val);
+            }
+        }
+    }
+    row_index[rows] = (int)values.size();
+}
+
+void ChCSRMatrix::CopyToMatrix(ChMatrix<>* matra) {
+    Compress();
+    matra->Reset(rows, columns);
+    for (int i = 0; i < rows; i++) {
+        for (int k = row_index[i]; k < row_index[i + 1]; k++)
+            matra->SetElement(i, col_index[k], values[k]);
+    }
+}
+
+void ChCSRMatrix::StreamOUTsparseMatlabFormat(ChStreamOutAscii& mstream) {
+    Compress();
+    for (int i = 0; i < rows; i++) {
+        for (int k = row_index[i]; k < row_index[i + 1]; k++) {
+            bool last = (i + 1 == rows && col_index[k] + 1 == columns);
+            if (values[k] && !last)
+                mstream << i + 1 << " " << col_index[k] + 1 << " " << values[k] << "\n";
+        }
+    }
+    // the last element is always written, so that Matlab gets the size of the matrix
+    if (rows > 0 && columns > 0)
+        mstream << rows << " " << columns << " " << GetElement(rows - 1, columns - 1) << "\n";
+}
+
+}  // END_OF_NAMESPACE____
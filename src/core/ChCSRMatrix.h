@@ -0,0 +1,145 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHCSRMATRIX_H
+#define CHCSRMATRIX_H
+
+#include <vector>
+
+#include "core/ChSpmatrix.h"
+
+namespace chrono {
+
+//////////////////////////////////////////////////
+// COMPRESSED SPARSE ROW MATRIX CLASS
+//
+/// This class defines a sparse matrix in compressed sparse
+/// row (CSR) format: the nonzeros of each row are stored
+/// contiguously, sorted by column, in an array of values and
+/// an array of column indexes, and a third array holds the
+/// offset of the first nonzero of each row.
+///
+/// The matrix is assembled from (row, column, value) triplets.
+/// Setting or adding an element that is not stored yet appends
+/// a triplet to a list, the list is sorted and merged into the
+/// compressed arrays by Compress(), which is called automatically
+/// as soon as the matrix is read. Setting an element that is
+/// already stored only changes its value, so a matrix with a
+/// fixed sparsity pattern can be refilled after ResetBlocks()
+/// without any allocation.
+///
+/// The transpose of a CSR matrix is the same matrix in compressed
+/// sparse column (CSC) format, see Transpose().
+///
+
+class ChApi ChCSRMatrix : public ChSparseMatrixBase {
+  private:
+    // A pending element, not merged yet into the compressed arrays
+    struct Triplet {
+        int row;
+        int col;
+        double val;
+        bool add;  // add to the value instead of setting it
+    };
+
+    int rows;
+    int columns;
+
+    std::vector<int> row_index;  // offset of the first nonzero of each row, rows+1 elements
+    std::vector<int> col_index;  // column of each nonzero
+    std::vector<double> values;  // value of each nonzero
+
+    std::vector<Triplet> triplets;  // elements set or added since the last Compress()
+
+    // index of the nonzero at (row, col) in the compressed arrays, -1 if not stored
+    int FindElement(int row, int col) const;
+
+  public:
+    //
+    // CONSTRUCTORS
+    //
+
+    /// Creates an empty 0x0 matrix.
+    ChCSRMatrix();
+
+    /// Creates a null matrix with given size.
+    ChCSRMatrix(int row, int col);
+
+    ~ChCSRMatrix() {}
+
+    int GetRows() const { return rows; }
+    int GetColumns() const { return columns; }
+
+    /// Number of stored elements (this may include explicitly set zeros).
+    int GetNNZ();
+
+    /// Reset to null matrix and (if needed) changes the size.
+    virtual void Reset(int row, int col);
+
+    /// If the size changes, is like Reset(), otherwise just sets to
+    /// zero the stored elements and keeps the sparsity pattern.
+    void ResetBlocks(int row, int col);
+
+    virtual void SetElement(int row, int col, double elem);
+    virtual double GetElement(int row, int col);
+    virtual void AddElement(int row, int col, double elem);
+
+    /// Merge the pending triplets into the compressed arrays.
+    /// Triplets with the same row and column are applied in the
+    /// order they were set or added.
+    void Compress();
+
+    /// Reserve space for the given number of pending triplets.
+    void Reserve(int nnz) { triplets.reserve(nnz); }
+
+    /// Access to the compressed arrays, for example to pass
+    /// the matrix to an external sparse solver.
+    const std::vector<int>& GetRowIndex() {
+        Compress();
+        return row_index;
+    }
+    const std::vector<int>& GetColIndex() {
+        Compress();
+        return col_index;
+    }
+    const std::vector<double>& GetValues() {
+        Compress();
+        return values;
+    }
+
+    /// Computes the product y = A*x, where A is this matrix. The
+    /// result is resized if needed.
+    void MatrMultiply(const ChMatrix<>& x, ChMatrix<>& y);
+
+    /// Computes the product y = A'*x, where A is this matrix. The
+    /// result is resized if needed.
+    void MatrTMultiply(const ChMatrix<>& x, ChMatrix<>& y);
+
+    /// Stores the transpose of this matrix in mtransp, that is
+    /// this matrix in CSC format.
+    void Transpose(ChCSRMatrix& mtransp);
+
+    void CopyFromMatrix(ChMatrix<>* matra);
+    void CopyFromMatrix(ChSparseMatrix* matra);
+    void CopyToMatrix(ChMatrix<>* matra);
+
+    /// Method to allow serializing transient data into in ascii stream (es a file)
+    /// as a Matlab sparse matrix format ( each row in file has three elements:
+    ///     row,    column,    value
+    /// Note: the row and column indexes start from 1, not 0 as in C language.
+    /// Same output as ChSparseMatrix::StreamOUTsparseMatlabFormat(), but only
+    /// the stored elements are visited.
+    void StreamOUTsparseMatlabFormat(ChStreamOutAscii& mstream);
+};
+
+}  // END_OF_NAMESPACE____
+
+#endif
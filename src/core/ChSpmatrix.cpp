@@ -29,6 +29,100 @@
 
 namespace chrono {
 
+// Default implementations of the ChSparseMatrixBase interface, one element at a time
+
+void ChSparseMatrixBase::PasteMatrix(ChMatrix<>* matra, int insrow, int inscol) {
+    for (int i = 0; i < matra->GetRows(); i++) {
+        for (int j = 0; j < matra->GetColumns(); j++) {
+            double val = matra->GetElement(i, j);
+            if (val)
+                SetElement(i + insrow, j + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteTranspMatrix(ChMatrix<>* matra, int insrow, int inscol) {
+    for (int i = 0; i < matra->GetRows(); i++) {
+        for (int j = 0; j < matra->GetColumns(); j++) {
+            double val = matra->GetElement(i, j);
+            if (val)
+                SetElement(j + insrow, i + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteMatrixFloat(ChMatrix<float>* matra, int insrow, int inscol) {
+    for (int i = 0; i < matra->GetRows(); i++) {
+        for (int j = 0; j < matra->GetColumns(); j++) {
+            double val = matra->GetElement(i, j);
+            if (val)
+                SetElement(i + insrow, j + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteTranspMatrixFloat(ChMatrix<float>* matra, int insrow, int inscol) {
+    for (int i = 0; i < matra->GetRows(); i++) {
+        for (int j = 0; j < matra->GetColumns(); j++) {
+            double val = matra->GetElement(i, j);
+            if (val)
+                SetElement(j + insrow, i + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteClippedMatrix(ChMatrix<>* matra,
+                                            int cliprow,
+                                            int clipcol,
+                                            int nrows,
+                                            int ncolumns,
+                                            int insrow,
+                                            int inscol) {
+    for (int i = 0; i < nrows; i++) {
+        for (int j = 0; j < ncolumns; j++) {
+            double val = matra->GetElement(i + cliprow, j + clipcol);
+            if (val)
+                SetElement(i + insrow, j + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteSumClippedMatrix(ChMatrix<>* matra,
+                                               int cliprow,
+                                               int clipcol,
+                                               int nrows,
+                                               int ncolumns,
+                                               int insrow,
+                                               int inscol) {
+    for (int i = 0; i < nrows; i++) {
+        for (int j = 0; j < ncolumns; j++) {
+            double val = matra->GetElement(i + cliprow, j + clipcol);
+            if (val)
+                AddElement(i + insrow, j + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteSumMatrix(ChMatrix<>* matra, int insrow, int inscol) {
+    for (int i = 0; i < matra->GetRows(); i++) {
+        for (int j = 0; j < matra->GetColumns(); j++) {
+            double val = matra->GetElement(i, j);
+            if (val)
+                AddElement(i + insrow, j + inscol, val);
+        }
+    }
+}
+
+void ChSparseMatrixBase::PasteSumTranspMatrix(ChMatrix<>* matra, int insrow, int inscol) {
+    for (int i = 0; i < matra->GetRows(); i++) {
+        for (int j = 0; j < matra->GetColumns(); j++) {
+            double val = matra->GetElement(i, j);
+            if (val)
+                AddElement(j + insrow, i + inscol, val);
+        }
+    }
+}
+
 void ChSparseMatrix::Build(int row, int col, double fullness) {
     rows = row;
     columns = col;
@@ -94,6 +94,48 @@ class ChUnilateralData {
     // double	friction;
 };
 
+//////////////////////////////////////////////////
+// SPARSE MATRIX INTERFACE
+//
+/// Interface of the sparse matrices that can be filled by
+/// ChLcpSystemDescriptor::ConvertToMatrixForm() and by the
+/// Build_M(), Build_Cq() and Build_K() functions of the
+/// LCP variables, constraints and stiffness blocks.
+///
+/// Only Reset(), SetElement() and GetElement() must be
+/// implemented, the default Paste..() functions go through
+/// them one element at a time. As in ChSparseMatrix, the
+/// Paste..() functions skip the zero elements of the source.
+///
+
+class ChApi ChSparseMatrixBase {
+  public:
+    virtual ~ChSparseMatrixBase() {}
+
+    /// Reset to null matrix and (if needed) changes the size.
+    virtual void Reset(int row, int col) = 0;
+
+    /// Set the value of an element, storing it if needed.
+    virtual void SetElement(int row, int col, double elem) = 0;
+
+    /// Get the value of an element, zero if not stored.
+    virtual double GetElement(int row, int col) = 0;
+
+    /// Add a value to an element.
+    virtual void AddElement(int row, int col, double elem) { SetElement(row, col, GetElement(row, col) + elem); }
+
+    virtual void PasteMatrix(ChMatrix<>* matra, int insrow, int inscol);
+    virtual void PasteTranspMatrix(ChMatrix<>* matra, int insrow, int inscol);
+    virtual void PasteMatrixFloat(ChMatrix<float>* matra, int insrow, int inscol);
+    virtual void PasteTranspMatrixFloat(ChMatrix<float>* matra, int insrow, int inscol);
+    virtual void
+    PasteClippedMatrix(ChMatrix<>* matra, int cliprow, int clipcol, int nrows, int ncolumns, int insrow, int inscol);
+    virtual void
+    PasteSumClippedMatrix(ChMatrix<>* matra, int cliprow, int clipcol, int nrows, int ncolumns, int insrow, int inscol);
+    virtual void PasteSumMatrix(ChMatrix<>* matra, int insrow, int inscol);
+    virtual void PasteSumTranspMatrix(ChMatrix<>* matra, int insrow, int inscol);
+};
+
 //////////////////////////////////////////////////
 // SPARSE MATRIX CLASS
 //
@@ -109,8 +151,11 @@ class ChUnilateralData {
 /// (here, only few of them are reimplemented, more will
 /// come later in futire releases.).
 ///
+/// See ChCSRMatrix for a compressed row storage that is
+/// faster to build and to traverse when the matrix is large.
+///
 
-class ChApi ChSparseMatrix : public ChMatrix<double> {
+class ChApi ChSparseMatrix : public ChMatrix<double>, public ChSparseMatrixBase {
   private:
     ChMelement** elarray;  // array of 1st column elements
 
@@ -128,6 +173,8 @@ class ChApi ChSparseMatrix : public ChMatrix<double> {
     double GetElarrayN(int num) { return (*(elarray + num))->val; };
     void SetElarrayN(double val, int num) { (*(elarray + num))->val = val; };
 
+    friend class ChCSRMatrix;
+
   public:
     //
     // CONSTRUCTORS
@@ -387,8 +387,9 @@ int main(int argc, char* argv[]) {
                 const ChState& x,                ///< current state, x part
                 const ChStateDelta& v,           ///< current state, v part
                 const double T,                  ///< current time T
-                bool force_state_scatter = true  ///< if false, x,v and T are not scattered to the system, assuming that
-                /// someone has done StateScatter just before
+                bool force_state_scatter = true,  ///< if false, x,v and T are not scattered to the system, assuming
+                /// that someone has done StateScatter just before
+                bool force_setup = true  ///< if false, the matrix of the last call may be reused
                 ) {
                 if (force_state_scatter)
                     this->StateScatter(x, v, T);
@@ -577,8 +578,9 @@ int main(int argc, char* argv[]) {
                 const ChState& x,                ///< current state, x part
                 const ChStateDelta& v,           ///< current state, v part
                 const double T,                  ///< current time T
-                bool force_state_scatter = true  ///< if false, x,v and T are not scattered to the system, assuming that
-                /// someone has done StateScatter just before
+                bool force_state_scatter = true,  ///< if false, x,v and T are not scattered to the system, assuming
+                /// that someone has done StateScatter just before
+                bool force_setup = true  ///< if false, the matrix of the last call may be reused
                 ) {
                 if (force_state_scatter)
                     this->StateScatter(x, v, T);
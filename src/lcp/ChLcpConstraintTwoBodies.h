@@ -191,13 +191,13 @@ class ChApi ChLcpConstraintTwoBodies : public ChLcpConstraintTwo {
     /// on the 'insrow' column, so that the sparse matrix is kept symmetric.
     /// This is used only by the ChLcpSimplex solver (iterative solvers
     /// don't need to know jacobians explicitly)
-    virtual void Build_Cq(ChSparseMatrix& storage, int insrow) {
+    virtual void Build_Cq(ChSparseMatrixBase& storage, int insrow) {
         if (variables_a->IsActive())
             storage.PasteMatrix(&Cq_a, insrow, variables_a->GetOffset());
         if (variables_b->IsActive())
             storage.PasteMatrix(&Cq_b, insrow, variables_b->GetOffset());
     }
-    virtual void Build_CqT(ChSparseMatrix& storage, int inscol) {
+    virtual void Build_CqT(ChSparseMatrixBase& storage, int inscol) {
         if (variables_a->IsActive())
             storage.PasteTranspMatrix(&Cq_a, variables_a->GetOffset(), inscol);
         if (variables_b->IsActive())
@@ -128,7 +128,7 @@ class ChApi ChLcpKblockGeneric : public ChLcpKblock {
     /// a global 'storage' matrix, at the offsets of variables.
     /// Most solvers do not need this: the sparse 'storage' matrix is used for testing, for
     /// direct solvers, for dumping full matrix to Matlab for checks, etc.
-    virtual void Build_K(ChSparseMatrix& storage, bool add = true);
+    virtual void Build_K(ChSparseMatrixBase& storage, bool add = true);
 };
 
 }  // END_OF_NAMESPACE____
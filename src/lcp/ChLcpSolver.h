@@ -86,6 +86,21 @@ class ChApi ChLcpSolver {
     virtual double Solve(ChLcpSystemDescriptor& sysd  ///< system description with constraints and variables
                          ) = 0;
 
+    /// Performs the solution of the problem using again the matrix of the
+    /// last call to Solve() (ex. its factorization, or a preconditioner):
+    /// only the known terms f and b are taken from the system description.
+    /// This is useful in modified Newton iterations. By default, this
+    /// simply calls Solve().
+    virtual double SolveReusingFactorization(ChLcpSystemDescriptor& sysd  ///< system description
+                                             ) {
+        return Solve(sysd);
+    }
+
+    /// Tell if SolveReusingFactorization() really reuses the matrix of the
+    /// last solution. Only in this case the caller can avoid to load again
+    /// the jacobians and the stiffness matrices in the system description.
+    virtual bool CanReuseFactorization() { return false; }
+
     //
     // Utility functions
     //
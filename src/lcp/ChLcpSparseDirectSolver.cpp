@@ -0,0 +1,373 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChLcpSparseDirectSolver.cpp
+//
+//    file for CHRONO HYPEROCTANT LCP solver
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+
+#include "ChLcpSparseDirectSolver.h"
+#include "core/ChLog.h"
+
+namespace chrono {
+
+// Order of the nodes of the KKT graph, by increasing number of neighbors
+struct ChLcpDegreeLess {
+    const std::vector<int>& degree;
+    ChLcpDegreeLess(const std::vector<int>& mdegree) : degree(mdegree) {}
+    bool operator()(int a, int b) const { return degree[a] < degree[b]; }
+};
+
+// Append to queue the nodes of the connected component of 'start', in
+// Cuthill-McKee order (breadth first, visiting the neighbors of each node by
+// increasing degree). Returns the position in queue of the first node of the
+// last level.
+static size_t CuthillMcKee(int start,
+                           const std::vector<int>& row_index,
+                           const std::vector<int>& col_index,
+                           const std::vector<int>& degree,
+                           std::vector<int>& mark,
+                           int stamp,
+                           std::vector<int>& queue) {
+    size_t first = queue.size();
+    size_t last_level = first;
+    queue.push_back(start);
+    mark[start] = stamp;
+    size_t level_end = queue.size();
+
+    for (size_t head = first; head < queue.size(); head++) {
+        if (head == level_end) {
+            last_level = head;
+            level_end = queue.size();
+        }
+        int i = queue[head];
+        size_t begin = queue.size();
+        for (int k = row_index[i]; k < row_index[i + 1]; k++) {
+            int j = col_index[k];
+            if (mark[j] != stamp) {
+                mark[j] = stamp;
+                queue.push_back(j);
+            }
+        }
+        std::stable_sort(queue.begin() + begin, queue.end(), ChLcpDegreeLess(degree));
+    }
+
+    return last_level;
+}
+
+ChLcpSparseDirectSolver::ChLcpSparseDirectSolver() {
+    pattern_nq = -1;
+    min_pivot = 1e-14;
+    num_symbolic = 0;
+    num_numeric = 0;
+    num_perturbed_pivots = 0;
+}
+
+double ChLcpSparseDirectSolver::Solve(ChLcpSystemDescriptor& sysd  ///< system description with constraints and variables
+                                      ) {
+    std::vector<ChLcpConstraint*>& mconstraints = sysd.GetConstraintsList();
+    std::vector<ChLcpVariables*>& mvariables = sysd.GetVariablesList();
+    std::vector<ChLcpKblock*>& mstiffness = sysd.GetKblocksList();
+
+    // also updates the offsets of variables and constraints
+    int nq = sysd.CountActiveVariables();
+    int nc = sysd.CountActiveConstraints();
+    int nx = nq + nc;
+
+    // Assemble the KKT matrix. If the size did not change the previous
+    // sparsity pattern is kept, and its elements are only overwritten.
+    Z.ResetBlocks(nx, nx);
+
+    for (unsigned int iv = 0; iv < mvariables.size(); iv++) {
+        if (mvariables[iv]->IsActive())
+            mvariables[iv]->Build_M(Z, mvariables[iv]->GetOffset(), mvariables[iv]->GetOffset());
+    }
+
+    for (unsigned int ik = 0; ik < mstiffness.size(); ik++) {
+        mstiffness[ik]->Build_K(Z, true);
+    }
+
+    for (unsigned int ic = 0; ic < mconstraints.size(); ic++) {
+        if (mconstraints[ic]->IsActive()) {
+            int s_c = nq + mconstraints[ic]->GetOffset();
+            mconstraints[ic]->Build_Cq(Z, s_c);
+            mconstraints[ic]->Build_CqT(Z, s_c);
+            Z.SetElement(s_c, s_c, -mconstraints[ic]->Get_cfm_i());  // E = -cfm
+        }
+    }
+
+    Z.Compress();
+
+    // The ordering and the elimination tree only depend on the sparsity pattern
+    if (!SymbolicIsValid(nq)) {
+        ComputeOrdering(nq);
+        SymbolicFactorization();
+        pattern_row_index = Z.GetRowIndex();
+        pattern_col_index = Z.GetColIndex();
+        pattern_nq = nq;
+        num_symbolic++;
+    }
+
+    NumericFactorization(nq);
+
+    SolveUnknowns(sysd);
+
+    if (verbose)
+        GetLog() << "ChLcpSparseDirectSolver: n.unknowns=" << nx << "  nnz(Z)=" << Z.GetNNZ()
+                 << "  nnz(L)=" << GetNumNonzerosL() << "  symbolic factorizations=" << num_symbolic
+                 << "  perturbed pivots=" << num_perturbed_pivots << "\n";
+
+    return 0;
+}
+
+double ChLcpSparseDirectSolver::SolveReusingFactorization(ChLcpSystemDescriptor& sysd  ///< system description
+                                                          ) {
+    int nx = sysd.CountActiveVariables() + sysd.CountActiveConstraints();
+    if (num_numeric == 0 || nx != (int)D.size())
+        return Solve(sysd);
+
+    SolveUnknowns(sysd);
+
+    return 0;
+}
+
+void ChLcpSparseDirectSolver::SolveUnknowns(ChLcpSystemDescriptor& sysd) {
+    // Solve for the unknowns x = {q; -l}, with known term d = {f; -b}
+    ChMatrixDynamic<> d;
+    sysd.BuildDiVector(d);
+
+    int nx = d.GetRows();
+    std::vector<double> x(nx);
+    for (int i = 0; i < nx; i++)
+        x[i] = d(i);
+
+    SolveFactorized(x);
+
+    for (int i = 0; i < nx; i++)
+        d(i) = x[i];
+    sysd.FromVectorToUnknowns(d);
+}
+
+bool ChLcpSparseDirectSolver::SymbolicIsValid(int nq) {
+    return nq == pattern_nq && Z.GetRowIndex() == pattern_row_index && Z.GetColIndex() == pattern_col_index;
+}
+
+void ChLcpSparseDirectSolver::ComputeOrdering(int nq) {
+    const std::vector<int>& row_index = Z.GetRowIndex();
+    const std::vector<int>& col_index = Z.GetColIndex();
+    int n = Z.GetRows();
+
+    std::vector<int> degree(n);
+    std::vector<int> by_degree(n);
+    for (int i = 0; i < n; i++) {
+        degree[i] = row_index[i + 1] - row_index[i];
+        by_degree[i] = i;
+    }
+    std::stable_sort(by_degree.begin(), by_degree.end(), ChLcpDegreeLess(degree));
+
+    // Reverse Cuthill-McKee ordering of each connected component, starting
+    // from a pseudo-peripheral node: the node of minimum degree in the last
+    // level of a first breadth first visit from a node of minimum degree.
+    std::vector<int> order;
+    std::vector<int> queue;
+    std::vector<int> mark(n, -1);
+    std::vector<char> ordered(n, 0);
+    order.reserve(n);
+    int stamp = 0;
+
+    for (int s = 0; s < n; s++) {
+        int start = by_degree[s];
+        if (ordered[start])
+            continue;
+
+        queue.clear();
+        size_t last_level = CuthillMcKee(start, row_index, col_index, degree, mark, stamp++, queue);
+        start = queue[last_level];
+        for (size_t k = last_level + 1; k < queue.size(); k++) {
+            if (degree[queue[k]] < degree[start])
+                start = queue[k];
+        }
+
+        queue.clear();
+        CuthillMcKee(start, row_index, col_index, degree, mark, stamp++, queue);
+        for (size_t k = 0; k < queue.size(); k++) {
+            ordered[queue[k]] = 1;
+            order.push_back(queue[k]);
+        }
+    }
+    std::reverse(order.begin(), order.end());
+
+    // Without pivoting a constraint must be eliminated after the variables it
+    // acts on, otherwise its pivot is null: each constraint is moved right after
+    // the last of its variables.
+    std::vector<int> remaining(n, 0);
+    for (int i = 0; i < nq; i++) {
+        for (int k = row_index[i]; k < row_index[i + 1]; k++) {
+            if (col_index[k] >= nq)
+                remaining[col_index[k]]++;
+        }
+    }
+
+    std::vector<char> placed(n, 0);
+    perm.clear();
+    perm.reserve(n);
+    for (int o = 0; o < n; o++) {
+        int i = order[o];
+        if (i >= nq) {
+            if (remaining[i] == 0 && !placed[i]) {
+                perm.push_back(i);
+                placed[i] = 1;
+            }
+            continue;
+        }
+        perm.push_back(i);
+        placed[i] = 1;
+        for (int k = row_index[i]; k < row_index[i + 1]; k++) {
+            int j = col_index[k];
+            if (j >= nq && --remaining[j] == 0 && !placed[j]) {
+                perm.push_back(j);
+                placed[j] = 1;
+            }
+        }
+    }
+
+    perm_inv.resize(n);
+    for (int k = 0; k < n; k++)
+        perm_inv[perm[k]] = k;
+}
+
+void ChLcpSparseDirectSolver::SymbolicFactorization() {
+    const std::vector<int>& row_index = Z.GetRowIndex();
+    const std::vector<int>& col_index = Z.GetColIndex();
+    int n = Z.GetRows();
+
+    // Elimination tree and number of nonzeros in each column of L, for the
+    // permuted matrix P*Z*P' (see T.A.Davis, "Algorithm 849: a concise sparse
+    // Cholesky factorization package")
+    parent.assign(n, -1);
+    Lp.assign(n + 1, 0);
+    std::vector<int> flag(n);
+    std::vector<int> lnz(n, 0);
+
+    for (int k = 0; k < n; k++) {
+        flag[k] = k;
+        int kk = perm[k];
+        for (int p = row_index[kk]; p < row_index[kk + 1]; p++) {
+            int i = perm_inv[col_index[p]];
+            if (i < k) {
+                for (; flag[i] != k; i = parent[i]) {
+                    if (parent[i] == -1)
+                        parent[i] = k;
+                    lnz[i]++;
+                    flag[i] = k;
+                }
+            }
+        }
+    }
+
+    for (int k = 0; k < n; k++)
+        Lp[k + 1] = Lp[k] + lnz[k];
+
+    Li.resize(Lp[n]);
+    Lx.resize(Lp[n]);
+    D.resize(n);
+}
+
+void ChLcpSparseDirectSolver::NumericFactorization(int nq) {
+    const std::vector<int>& row_index = Z.GetRowIndex();
+    const std::vector<int>& col_index = Z.GetColIndex();
+    const std::vector<double>& values = Z.GetValues();
+    int n = Z.GetRows();
+
+    std::vector<double> y(n, 0.0);
+    std::vector<int> pattern(n);
+    std::vector<int> flag(n);
+    std::vector<int> lnz(n);
+    num_perturbed_pivots = 0;
+
+    for (int k = 0; k < n; k++) {
+        // nonzero pattern of the k-th row of L, from the elimination tree
+        int top = n;
+        flag[k] = k;
+        lnz[k] = 0;
+        int kk = perm[k];
+        for (int p = row_index[kk]; p < row_index[kk + 1]; p++) {
+            int i = perm_inv[col_index[p]];
+            if (i <= k) {
+                y[i] += values[p];
+                int len;
+                for (len = 0; flag[i] != k; i = parent[i]) {
+                    pattern[len++] = i;
+                    flag[i] = k;
+                }
+                while (len > 0)
+                    pattern[--top] = pattern[--len];
+            }
+        }
+
+        // sparse triangular solve for the k-th row of L
+        D[k] = y[k];
+        y[k] = 0;
+        for (; top < n; top++) {
+            int i = pattern[top];
+            double yi = y[i];
+            y[i] = 0;
+            int p2 = Lp[i] + lnz[i];
+            for (int p = Lp[i]; p < p2; p++)
+                y[Li[p]] -= Lx[p] * yi;
+            double l_ki = yi / D[i];
+            D[k] -= l_ki * yi;
+            Li[p2] = k;
+            Lx[p2] = l_ki;
+            lnz[i]++;
+        }
+
+        // pivots of the variables are expected positive, those of the constraints negative
+        if (fabs(D[k]) < min_pivot) {
+            D[k] = (perm[k] < nq) ? min_pivot : -min_pivot;
+            num_perturbed_pivots++;
+        }
+    }
+
+    num_numeric++;
+}
+
+void ChLcpSparseDirectSolver::SolveFactorized(std::vector<double>& x) {
+    int n = (int)x.size();
+    std::vector<double> y(n);
+    for (int k = 0; k < n; k++)
+        y[k] = x[perm[k]];
+
+    for (int j = 0; j < n; j++) {
+        for (int p = Lp[j]; p < Lp[j + 1]; p++)
+            y[Li[p]] -= Lx[p] * y[j];
+    }
+    for (int j = 0; j < n; j++)
+        y[j] /= D[j];
+    for (int j = n - 1; j >= 0; j--) {
+        for (int p = Lp[j]; p < Lp[j + 1]; p++)
+            y[j] -= Lx[p] * y[Li[p]];
+    }
+
+    for (int k = 0; k < n; k++)
+        x[perm[k]] = y[k];
+}
+
+}  // END_OF_NAMESPACE____
@@ -0,0 +1,149 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHLCPSPARSEDIRECTSOLVER_H
+#define CHLCPSPARSEDIRECTSOLVER_H
+
+//////////////////////////////////////////////////
+//
+//   ChLcpSparseDirectSolver.h
+//
+//    A direct solver for linear problems (only
+//   bilateral constraints), based on a sparse
+//   LDL' factorization of the KKT matrix.
+//
+//   HEADER file for CHRONO HYPEROCTANT LCP solver
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <vector>
+
+#include "ChLcpDirectSolver.h"
+#include "core/ChCSRMatrix.h"
+
+namespace chrono {
+
+///    A direct solver for the linear problems that
+///   arise when all the constraints are bilateral,
+///   ex. in the Newton iterations of the implicit
+///   timesteppers (HHT, Newmark, Euler implicit) used
+///   with FEA. The full KKT system
+///
+///    | M+K  Cq'|*| q|- | f|= |0|
+///    | Cq   E  | |-l|  |-b|  |0|
+///
+///   (E = -cfm) is assembled in a sparse matrix, reordered
+///   to reduce the fill-in (reverse Cuthill-McKee, with each
+///   constraint eliminated after the variables it acts on)
+///   and factorized as L*D*L'. The ordering and the
+///   elimination tree (the symbolic factorization) are
+///   kept and reused as long as the sparsity pattern of the
+///   KKT matrix does not change, so the successive Newton
+///   iterations only redo the numeric factorization.
+///    Unilateral constraints are handled as if they were
+///   bilateral, so use an iterative solver for problems
+///   with contacts. Stiffness blocks (ChLcpKblock) are
+///   supported. Redundant constraints give null pivots,
+///   which are replaced by small values (see SetMinPivot()),
+///   give them some compliance (cfm) when possible.
+
+class ChApi ChLcpSparseDirectSolver : public ChLcpDirectSolver {
+  protected:
+    //
+    // DATA
+    //
+
+    ChCSRMatrix Z;  // the KKT matrix, both triangles
+
+    // symbolic factorization, and the KKT sparsity pattern it was computed for
+    std::vector<int> pattern_row_index;
+    std::vector<int> pattern_col_index;
+    int pattern_nq;
+    std::vector<int> perm;      // perm[k] is the row of Z eliminated at step k
+    std::vector<int> perm_inv;  // inverse of perm
+    std::vector<int> parent;    // elimination tree
+    std::vector<int> Lp;        // offset of each column of L
+
+    // numeric factorization
+    std::vector<int> Li;
+    std::vector<double> Lx;
+    std::vector<double> D;
+
+    double min_pivot;
+    int num_symbolic;
+    int num_numeric;
+    int num_perturbed_pivots;
+
+    bool SymbolicIsValid(int nq);
+    void ComputeOrdering(int nq);
+    void SymbolicFactorization();
+    void NumericFactorization(int nq);
+    void SolveFactorized(std::vector<double>& x);
+    void SolveUnknowns(ChLcpSystemDescriptor& sysd);
+
+  public:
+    //
+    // CONSTRUCTORS
+    //
+
+    ChLcpSparseDirectSolver();
+
+    virtual ~ChLcpSparseDirectSolver() {}
+
+    //
+    // FUNCTIONS
+    //
+
+    /// Performs the solution of the problem, by factorizing the KKT
+    /// matrix. The symbolic factorization is reused from the previous
+    /// call if the sparsity pattern did not change.
+    /// \return  always zero, the solution is exact up to round-off.
+    virtual double Solve(ChLcpSystemDescriptor& sysd  ///< system description with constraints and variables
+                         );
+
+    /// Performs the solution of the problem with the last factorization,
+    /// with the new known terms of the system description. The caller must
+    /// ensure that the KKT matrix did not change, or changed so little that
+    /// the old factorization is still a good approximation (ex. in modified
+    /// Newton iterations). If the size of the problem changed, or if there
+    /// is no factorization yet, this is the same as Solve().
+    virtual double SolveReusingFactorization(ChLcpSystemDescriptor& sysd  ///< system description
+                                             );
+
+    /// This solver can reuse its factorization.
+    virtual bool CanReuseFactorization() { return true; }
+
+    /// Pivots smaller than this (in absolute value) are replaced by
+    /// this value, with the sign expected for a variable (positive)
+    /// or for a constraint (negative). Default 1e-14.
+    void SetMinPivot(double mpivot) { min_pivot = mpivot; }
+    double GetMinPivot() { return min_pivot; }
+
+    /// Discard the symbolic factorization, so that it is computed
+    /// again at the next Solve().
+    void ResetSymbolicFactorization() { pattern_row_index.clear(); }
+
+    /// Number of symbolic factorizations (orderings) computed so far.
+    int GetNumSymbolicFactorizations() { return num_symbolic; }
+    /// Number of numeric factorizations computed so far.
+    int GetNumNumericFactorizations() { return num_numeric; }
+    /// Number of pivots replaced during the last factorization.
+    int GetNumPerturbedPivots() { return num_perturbed_pivots; }
+    /// Number of nonzeros of the L factor (without the unit diagonal).
+    int GetNumNonzerosL() { return Lp.empty() ? 0 : Lp.back(); }
+};
+
+}  // END_OF_NAMESPACE____
+
+#endif  // END of ChLcpSparseDirectSolver.h
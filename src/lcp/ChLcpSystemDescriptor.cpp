@@ -23,6 +23,7 @@
 ///////////////////////////////////////////////////
 
 #include "ChLcpSystemDescriptor.h"
+#include "core/ChCSRMatrix.h"
 #include "ChLcpConstraintTwoFrictionT.h"
 #include "ChLcpConstraintTwoRollingN.h"
 #include "ChLcpConstraintTwoRollingT.h"
@@ -114,9 +115,9 @@ void ChLcpSystemDescriptor::UpdateCountsAndOffsets() {
     freeze_count = true;
 }
 
-void ChLcpSystemDescriptor::ConvertToMatrixForm(ChSparseMatrix* Cq,
-                                                ChSparseMatrix* M,
-                                                ChSparseMatrix* E,
+void ChLcpSystemDescriptor::ConvertToMatrixForm(ChSparseMatrixBase* Cq,
+                                                ChSparseMatrixBase* M,
+                                                ChSparseMatrixBase* E,
                                                 ChMatrix<>* Fvector,
                                                 ChMatrix<>* Bvector,
                                                 ChMatrix<>* Frict,
@@ -205,8 +206,8 @@ void ChLcpSystemDescriptor::ConvertToMatrixForm(ChSparseMatrix* Cq,
     }
 }
 
-void ChLcpSystemDescriptor::BuildMatrices(ChSparseMatrix* Cq,
-                                          ChSparseMatrix* M,
+void ChLcpSystemDescriptor::BuildMatrices(ChSparseMatrixBase* Cq,
+                                          ChSparseMatrixBase* M,
                                           bool only_bilaterals,
                                           bool skip_contacts_uv) {
     this->ConvertToMatrixForm(Cq, M, 0, 0, 0, 0, only_bilaterals, skip_contacts_uv);
@@ -222,9 +223,9 @@ void ChLcpSystemDescriptor::DumpLastMatrices(const char* path) {
     char filename[300];
     try {
         const char* numformat = "%.12g";
-        chrono::ChSparseMatrix mdM;
-        chrono::ChSparseMatrix mdCq;
-        chrono::ChSparseMatrix mdE;
+        chrono::ChCSRMatrix mdM;
+        chrono::ChCSRMatrix mdCq;
+        chrono::ChCSRMatrix mdE;
         chrono::ChMatrixDynamic<double> mdf;
         chrono::ChMatrixDynamic<double> mdb;
         chrono::ChMatrixDynamic<double> mdfric;
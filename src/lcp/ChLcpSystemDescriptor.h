@@ -337,12 +337,13 @@ class ChApi ChLcpSystemDescriptor {
     /// using these matrices, for performance), for example you will load these matrices in Matlab.
     /// Optionally, tangential (u,v) contact jacobians may be skipped, or only bilaterals can be considered
     /// The matrices and vectors are automatically resized if needed.
-    virtual void ConvertToMatrixForm(ChSparseMatrix* Cq,   ///< fill this system jacobian matrix, if not null
-                                     ChSparseMatrix* M,    ///< fill this system mass matrix, if not null
-                                     ChSparseMatrix* E,    ///< fill this system 'compliance' matrix , if not null
-                                     ChMatrix<>* Fvector,  ///< fill this vector as the known term 'f', if not null
-                                     ChMatrix<>* Bvector,  ///< fill this vector as the known term 'b', if not null
-                                     ChMatrix<>* Frict,    ///< fill as a vector with friction coefficients (=-1 for
+    /// Any ChSparseMatrixBase can be filled, for large problems a ChCSRMatrix is much faster than a ChSparseMatrix.
+    virtual void ConvertToMatrixForm(ChSparseMatrixBase* Cq,  ///< fill this system jacobian matrix, if not null
+                                     ChSparseMatrixBase* M,   ///< fill this system mass matrix, if not null
+                                     ChSparseMatrixBase* E,   ///< fill this system 'compliance' matrix , if not null
+                                     ChMatrix<>* Fvector,     ///< fill this vector as the known term 'f', if not null
+                                     ChMatrix<>* Bvector,     ///< fill this vector as the known term 'b', if not null
+                                     ChMatrix<>* Frict,       ///< fill as a vector with friction coefficients (=-1 for
                                      /// tangent comp.; =-2 for bilaterals), if not null
                                      bool only_bilaterals = false,
                                      bool skip_contacts_uv = false);
@@ -356,8 +357,8 @@ class ChApi ChLcpSystemDescriptor {
     virtual void DumpLastMatrices(const char* path = "");
 
     /// OBSOLETE. Kept only for backward compability. Use rather: ConvertToMatrixForm
-    virtual void BuildMatrices(ChSparseMatrix* Cq,
-                               ChSparseMatrix* M,
+    virtual void BuildMatrices(ChSparseMatrixBase* Cq,
+                               ChSparseMatrixBase* M,
                                bool only_bilaterals = false,
                                bool skip_contacts_uv = false);
     /// OBSOLETE. Kept only for backward compability. Use rather: ConvertToMatrixForm, or BuildFbVector or BuildBiVector
@@ -202,7 +202,7 @@ class ChApi ChLcpVariables {
     /// Most iterative solvers don't need to know this matrix explicitly.
     /// *** This function MUST BE OVERRIDDEN by specialized
     /// inherited classes
-    virtual void Build_M(ChSparseMatrix& storage, int insrow, int inscol) = 0;
+    virtual void Build_M(ChSparseMatrixBase& storage, int insrow, int inscol) = 0;
 
     /// Set offset in global q vector (set automatically by ChLcpSystemDescriptor)
     void SetOffset(int moff) { offset = moff; }
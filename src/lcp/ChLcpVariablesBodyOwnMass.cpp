@@ -161,7 +161,7 @@ void ChLcpVariablesBodyOwnMass::DiagonalAdd(ChMatrix<double>& result) const {
 /// it in 'storage' sparse matrix, at given column/row offset.
 /// Note, most iterative solvers don't need to know mass matrix explicitly.
 /// Optimised: doesn't fill unneeded elements except mass and 3x3 inertia.
-void ChLcpVariablesBodyOwnMass::Build_M(ChSparseMatrix& storage, int insrow, int inscol) {
+void ChLcpVariablesBodyOwnMass::Build_M(ChSparseMatrixBase& storage, int insrow, int inscol) {
     storage.SetElement(insrow + 0, inscol + 0, mass);
     storage.SetElement(insrow + 1, inscol + 1, mass);
     storage.SetElement(insrow + 2, inscol + 2, mass);
@@ -102,7 +102,7 @@ class ChApi ChLcpVariablesShaft : public ChLcpVariables {
     /// it in 'storage' sparse matrix, at given column/row offset.
     /// Note, most iterative solvers don't need to know mass matrix explicitly.
     /// Optimised: doesn't fill unneeded elements except mass.
-    void Build_M(ChSparseMatrix& storage, int insrow, int inscol);
+    void Build_M(ChSparseMatrixBase& storage, int insrow, int inscol);
 
     //
     // SERIALIZATION
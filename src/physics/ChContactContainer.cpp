@@ -119,58 +119,56 @@ void ChContactContainer::EndAddContact() {
     }
 }
 
-void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact) {
-    // Fetch the frames of that contact and other infos
-
-    ChFrame<>* frameA = 0;
-    ChFrame<>* frameB = 0;
+bool ChContactContainer::FetchContactPair(const collision::ChCollisionInfo& mcontact, ChContactPair& mpair) {
+    mpair.frameA = 0;
+    mpair.frameB = 0;
+    mpair.varA = 0;
+    mpair.varB = 0;
     bool inactiveA = false;
     bool inactiveB = false;
-    ChLcpVariablesBody* varA = 0;
-    ChLcpVariablesBody* varB = 0;
-    ChSharedPtr<ChMaterialSurface> mmatA;
-    ChSharedPtr<ChMaterialSurface> mmatB;
+    ChMaterialSurface* mmatA = 0;
+    ChMaterialSurface* mmatB = 0;
 
     if (ChModelBulletBody* mmboA = dynamic_cast<ChModelBulletBody*>(mcontact.modelA)) {
-        frameA = mmboA->GetBody();
-        varA = &mmboA->GetBody()->VariablesBody();
+        mpair.frameA = mmboA->GetBody();
+        mpair.varA = &mmboA->GetBody()->VariablesBody();
         inactiveA = !mmboA->GetBody()->IsActive();
-        mmatA = mmboA->GetBody()->GetMaterialSurface();
+        mmatA = dynamic_cast<ChMaterialSurface*>(mmboA->GetBody()->GetMaterialSurfaceBase().get_ptr());
     }
     if (ChModelBulletParticle* mmpaA = dynamic_cast<ChModelBulletParticle*>(mcontact.modelA)) {
-        frameA = &(mmpaA->GetParticles()->GetParticle(mmpaA->GetParticleId()));
-        varA = (ChLcpVariablesBody*)&(mmpaA->GetParticles()->GetParticle(mmpaA->GetParticleId())).Variables();
+        mpair.frameA = &(mmpaA->GetParticles()->GetParticle(mmpaA->GetParticleId()));
+        mpair.varA = (ChLcpVariablesBody*)&(mmpaA->GetParticles()->GetParticle(mmpaA->GetParticleId())).Variables();
         if (ChParticlesClones* mpclone = dynamic_cast<ChParticlesClones*>(mmpaA->GetParticles())) {
-            mmatA = mpclone->GetMaterialSurface();
+            mmatA = mpclone->GetMaterialSurface().get_ptr();
         }
     }
 
     if (ChModelBulletBody* mmboB = dynamic_cast<ChModelBulletBody*>(mcontact.modelB)) {
-        frameB = mmboB->GetBody();
-        varB = &mmboB->GetBody()->VariablesBody();
+        mpair.frameB = mmboB->GetBody();
+        mpair.varB = &mmboB->GetBody()->VariablesBody();
         inactiveB = !mmboB->GetBody()->IsActive();
-        mmatB = mmboB->GetBody()->GetMaterialSurface();
+        mmatB = dynamic_cast<ChMaterialSurface*>(mmboB->GetBody()->GetMaterialSurfaceBase().get_ptr());
     }
     if (ChModelBulletParticle* mmpaB = dynamic_cast<ChModelBulletParticle*>(mcontact.modelB)) {
-        frameB = &(mmpaB->GetParticles()->GetParticle(mmpaB->GetParticleId()));
-        varB = (ChLcpVariablesBody*)&(mmpaB->GetParticles()->GetParticle(mmpaB->GetParticleId())).Variables();
+        mpair.frameB = &(mmpaB->GetParticles()->GetParticle(mmpaB->GetParticleId()));
+        mpair.varB = (ChLcpVariablesBody*)&(mmpaB->GetParticles()->GetParticle(mmpaB->GetParticleId())).Variables();
         if (ChParticlesClones* mpclone = dynamic_cast<ChParticlesClones*>(mmpaB->GetParticles())) {
-            mmatB = mpclone->GetMaterialSurface();
+            mmatB = mpclone->GetMaterialSurface().get_ptr();
         }
     }
 
-    if (!(frameA && frameB))
-        return;
+    if (!(mpair.frameA && mpair.frameB))
+        return false;
 
-    assert(varA);
-    assert(varB);
+    assert(mpair.varA);
+    assert(mpair.varB);
 
     if ((inactiveA && inactiveB))
-        return;
+        return false;
 
     // Compute default material-couple values.
 
-    ChMaterialCouple mat;
+    ChMaterialCouple& mat = mpair.mat;
 
     mat.static_friction = (float)ChMin(mmatA->static_friction, mmatB->static_friction);
     mat.rolling_friction = (float)ChMin(mmatA->rolling_friction, mmatB->rolling_friction);
@@ -183,21 +181,23 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
     mat.complianceRoll = (float)(mmatA->complianceRoll + mmatB->complianceRoll);
     mat.complianceSpin = (float)(mmatA->complianceSpin + mmatB->complianceSpin);
 
-    // Launch the contact callback, if any, to set custom friction & material
-    // properties, if implemented by the user:
-
-    if (this->add_contact_callback) {
-        this->add_contact_callback->ContactCallback(mcontact, mat);
-    }
+    return true;
+}
 
-    // %%%%%%% Create and add a ChContact object (or ChContactRolling if there is spinn. or roll.friction) %%%%%%%
+ChContact* ChContactContainer::InsertContact(const collision::ChCollisionInfo& mcontact,
+                                             ChContactPair& mpair,
+                                             bool defer_reset) {
+    ChFrame<>* frameA = mpair.frameA;
+    ChFrame<>* frameB = mpair.frameB;
+    ChLcpVariablesBody* varA = mpair.varA;
+    ChLcpVariablesBody* varB = mpair.varB;
+    ChMaterialCouple& mat = mpair.mat;
+    ChContact* reused = 0;
 
     if ((mat.rolling_friction == 0) && (mat.spinning_friction == 0)) {
         if (lastcontact != contactlist.end()) {
             // reuse old contacts
-            (*lastcontact)
-                ->Reset(mcontact.modelA, mcontact.modelB, varA, varB, frameA, frameB, mcontact.vpA, mcontact.vpB,
-                        mcontact.vN, mcontact.distance, mcontact.reaction_cache, mat);
+            reused = *lastcontact;
             lastcontact++;
         } else {
             // add new contact
@@ -210,9 +210,7 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
     } else {
         if (lastcontact_roll != contactlist_roll.end()) {
             // reuse old rolling contacts
-            (*lastcontact_roll)
-                ->Reset(mcontact.modelA, mcontact.modelB, varA, varB, frameA, frameB, mcontact.vpA, mcontact.vpB,
-                        mcontact.vN, mcontact.distance, mcontact.reaction_cache, mat);
+            reused = *lastcontact_roll;
             lastcontact_roll++;
         } else {
             // add new contact
@@ -224,6 +222,66 @@ void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact)
         }
         n_added_roll++;
     }
+
+    if (reused && !defer_reset) {
+        reused->Reset(mcontact.modelA, mcontact.modelB, varA, varB, frameA, frameB, mcontact.vpA, mcontact.vpB,
+                      mcontact.vN, mcontact.distance, mcontact.reaction_cache, mat);
+        return 0;
+    }
+    return reused;
+}
+
+void ChContactContainer::AddContact(const collision::ChCollisionInfo& mcontact) {
+    // Fetch the frames of that contact and other infos
+
+    ChContactPair mpair;
+    if (!FetchContactPair(mcontact, mpair))
+        return;
+
+    // Launch the contact callback, if any, to set custom friction & material
+    // properties, if implemented by the user:
+
+    if (this->add_contact_callback) {
+        this->add_contact_callback->ContactCallback(mcontact, mpair.mat);
+    }
+
+    // Create and add a ChContact object (or ChContactRolling if there is spinn. or roll.friction)
+
+    InsertContact(mcontact, mpair, false);
+}
+
+void ChContactContainer::AddContacts(const std::vector<collision::ChCollisionInfo>& mcontacts) {
+    int ncontacts = (int)mcontacts.size();
+    std::vector<ChContactPair> mpairs(ncontacts);
+    std::vector<char> valid(ncontacts);
+    std::vector<ChContact*> reused(ncontacts, (ChContact*)0);
+
+    // 1- fetch frames, variables and materials, in parallel
+#pragma omp parallel for schedule(static) if (ncontacts > CH_CONTACTS_PARALLEL)
+    for (int i = 0; i < ncontacts; i++)
+        valid[i] = FetchContactPair(mcontacts[i], mpairs[i]);
+
+    // 2- user callback and insertion in the lists, in the order of the contacts; the
+    //    old contact objects that are reused are initialized later
+    for (int i = 0; i < ncontacts; i++) {
+        if (!valid[i])
+            continue;
+        if (this->add_contact_callback)
+            this->add_contact_callback->ContactCallback(mcontacts[i], mpairs[i].mat);
+        reused[i] = InsertContact(mcontacts[i], mpairs[i], true);
+    }
+
+    // 3- initialize the reused contact objects (jacobians etc.), in parallel
+#pragma omp parallel for schedule(static) if (ncontacts > CH_CONTACTS_PARALLEL)
+    for (int i = 0; i < ncontacts; i++) {
+        if (!reused[i])
+            continue;
+        const collision::ChCollisionInfo& mcontact = mcontacts[i];
+        ChContactPair& mpair = mpairs[i];
+        reused[i]->Reset(mcontact.modelA, mcontact.modelB, mpair.varA, mpair.varB, mpair.frameA, mpair.frameB,
+                         mcontact.vpA, mcontact.vpB, mcontact.vN, mcontact.distance, mcontact.reaction_cache,
+                         mpair.mat);
+    }
 }
 
 void ChContactContainer::ReportAllContacts(ChReportContactCallback* mcallback) {
@@ -36,6 +36,16 @@
 
 namespace chrono {
 
+/// Frames, variables and default material of the two objects
+/// touching in a contact, as fetched from their collision models.
+struct ChContactPair {
+    ChFrame<>* frameA;
+    ChFrame<>* frameB;
+    ChLcpVariablesBody* varA;
+    ChLcpVariablesBody* varB;
+    ChMaterialCouple mat;
+};
+
 ///
 /// Class representing a container of many contacts,
 /// implemented as a typical linked list of ChContact
@@ -65,6 +75,11 @@ class ChApi ChContactContainer : public ChContactContainerBase {
 
     std::list<ChContactRolling*>::iterator lastcontact_roll;
 
+    // Put the contact in the list (or in the list of rolling contacts), reusing
+    // an old contact object if possible. If defer_reset is true, a reused
+    // object is returned and it must be initialized later with Reset().
+    ChContact* InsertContact(const collision::ChCollisionInfo& mcontact, ChContactPair& mpair, bool defer_reset);
+
   public:
     //
     // CONSTRUCTORS
@@ -83,6 +98,12 @@ class ChApi ChContactContainer : public ChContactContainerBase {
     /// Return the contact List
     virtual std::list<ChContact*>& GetContactList() { return contactlist; }
 
+    /// Fetch the frames and the variables of the objects touching in a
+    /// contact, and the default material-couple values. Returns false if
+    /// the contact must be discarded. Only bare pointers are used (no
+    /// reference counting), so it can be called by parallel threads.
+    static bool FetchContactPair(const collision::ChCollisionInfo& mcontact, ChContactPair& mpair);
+
     /// Remove (delete) all contained contact data.
     virtual void RemoveAllContacts();
 
@@ -96,6 +117,12 @@ class ChApi ChContactContainer : public ChContactContainerBase {
     /// Add a contact between two frames.
     virtual void AddContact(const collision::ChCollisionInfo& mcontact);
 
+    /// Add many contacts at once. The bodies and the materials of the
+    /// contacts are fetched in parallel, and also the reused contact
+    /// objects are initialized in parallel. The custom callback, if
+    /// any, is called serially in the order of the contacts.
+    virtual void AddContacts(const std::vector<collision::ChCollisionInfo>& mcontacts);
+
     /// The collision system will call BeginAddContact() after adding
     /// all contacts (for example with AddContact() or similar). This optimized version
     /// purges the end of the list of contacts that were not reused (if any).
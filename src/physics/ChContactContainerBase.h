@@ -30,6 +30,11 @@
 #include "physics/ChContact.h"
 #include "physics/ChMaterialCouple.h"
 #include "collision/ChCCollisionInfo.h"
+#include <vector>
+
+/// Minimum number of contacts (or of contact manifolds) to process
+/// them in parallel, below this the overhead of threads is not worth.
+#define CH_CONTACTS_PARALLEL 500
 
 namespace chrono {
 
@@ -132,6 +137,15 @@ class ChApi ChContactContainerBase : public ChPhysicsItem {
     /// specialized add-functions are found.
     virtual void AddContact(const collision::ChCollisionInfo& mcontact) = 0;
 
+    /// Add many contacts at once, in the given order. The collision system
+    /// can call this instead of many AddContact(), between BeginAddContact()
+    /// and EndAddContact(). By default it calls AddContact() for each
+    /// contact, but children classes can process them in parallel.
+    virtual void AddContacts(const std::vector<collision::ChCollisionInfo>& mcontacts) {
+        for (unsigned int i = 0; i < mcontacts.size(); ++i)
+            AddContact(mcontacts[i]);
+    }
+
     /// The collision system will call EndAddContact() after adding
     /// all contacts (for example with AddContact() or similar). By default
     /// it does nothing.
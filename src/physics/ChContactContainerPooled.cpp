@@ -0,0 +1,275 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   ChContactContainerPooled.cpp
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include "physics/ChContactContainerPooled.h"
+#include "physics/ChSystem.h"
+
+namespace chrono {
+
+using namespace collision;
+
+// Register into the object factory, to enable run-time
+// dynamic creation and persistence
+ChClassRegister<ChContactContainerPooled> a_registration_ChContactContainerPooled;
+
+ChContactContainerPooled::ChContactContainerPooled() {
+}
+
+ChContactContainerPooled::~ChContactContainerPooled() {
+    contacts.Clear();
+    contacts_roll.Clear();
+}
+
+void ChContactContainerPooled::Update(double mytime, bool update_assets) {
+    // Inherit time changes of parent class, basically doing nothing :)
+    ChContactContainerBase::Update(mytime, update_assets);
+}
+
+void ChContactContainerPooled::RemoveAllContacts() {
+    contacts.Clear();
+    contacts_roll.Clear();
+}
+
+void ChContactContainerPooled::BeginAddContact() {
+    contacts.Rewind();
+    contacts_roll.Rewind();
+}
+
+void ChContactContainerPooled::AddContact(const collision::ChCollisionInfo& mcontact) {
+    // Fetch the frames of that contact and other infos
+
+    ChContactPair mpair;
+    if (!ChContactContainer::FetchContactPair(mcontact, mpair))
+        return;
+
+    // Launch the contact callback, if any, to set custom friction & material
+    // properties, if implemented by the user:
+
+    if (this->add_contact_callback) {
+        this->add_contact_callback->ContactCallback(mcontact, mpair.mat);
+    }
+
+    // Take a ChContact object from the pool (or ChContactRolling if there is spinn. or roll.friction)
+
+    ChContact* mc;
+    if ((mpair.mat.rolling_friction == 0) && (mpair.mat.spinning_friction == 0))
+        mc = &contacts.Next();
+    else
+        mc = &contacts_roll.Next();
+
+    mc->Reset(mcontact.modelA, mcontact.modelB, mpair.varA, mpair.varB, mpair.frameA, mpair.frameB, mcontact.vpA,
+              mcontact.vpB, mcontact.vN, mcontact.distance, mcontact.reaction_cache, mpair.mat);
+}
+
+void ChContactContainerPooled::AddContacts(const std::vector<collision::ChCollisionInfo>& mcontacts) {
+    int ncontacts = (int)mcontacts.size();
+    std::vector<ChContactPair> mpairs(ncontacts);
+    std::vector<char> valid(ncontacts);
+    std::vector<ChContact*> slots(ncontacts, (ChContact*)0);
+
+    // 1- fetch frames, variables and materials, in parallel
+#pragma omp parallel for schedule(static) if (ncontacts > CH_CONTACTS_PARALLEL)
+    for (int i = 0; i < ncontacts; i++)
+        valid[i] = ChContactContainer::FetchContactPair(mcontacts[i], mpairs[i]);
+
+    // 2- user callback and choice of the slots in the pools, in the order of the contacts
+    for (int i = 0; i < ncontacts; i++) {
+        if (!valid[i])
+            continue;
+        if (this->add_contact_callback)
+            this->add_contact_callback->ContactCallback(mcontacts[i], mpairs[i].mat);
+        if ((mpairs[i].mat.rolling_friction == 0) && (mpairs[i].mat.spinning_friction == 0))
+            slots[i] = &contacts.Next();
+        else
+            slots[i] = &contacts_roll.Next();
+    }
+
+    // 3- initialize the contact objects (jacobians etc.), in parallel
+#pragma omp parallel for schedule(static) if (ncontacts > CH_CONTACTS_PARALLEL)
+    for (int i = 0; i < ncontacts; i++) {
+        if (!slots[i])
+            continue;
+        const collision::ChCollisionInfo& mcontact = mcontacts[i];
+        ChContactPair& mpair = mpairs[i];
+        slots[i]->Reset(mcontact.modelA, mcontact.modelB, mpair.varA, mpair.varB, mpair.frameA, mpair.frameB,
+                        mcontact.vpA, mcontact.vpB, mcontact.vN, mcontact.distance, mcontact.reaction_cache,
+                        mpair.mat);
+    }
+}
+
+void ChContactContainerPooled::ReportAllContacts(ChReportContactCallback* mcallback) {
+    for (int i = 0; i < contacts.GetNused(); i++) {
+        ChContact& mc = contacts[i];
+        bool proceed = mcallback->ReportContactCallback(mc.GetContactP1(), mc.GetContactP2(), *mc.GetContactPlane(),
+                                                        mc.GetContactDistance(), (float)mc.GetFriction(),
+                                                        mc.GetContactForce(),
+                                                        VNULL,  // no react torques
+                                                        mc.GetModelA(), mc.GetModelB());
+        if (!proceed)
+            break;
+    }
+
+    for (int i = 0; i < contacts_roll.GetNused(); i++) {
+        ChContactRolling& mc = contacts_roll[i];
+        bool proceed = mcallback->ReportContactCallback(mc.GetContactP1(), mc.GetContactP2(), *mc.GetContactPlane(),
+                                                        mc.GetContactDistance(), (float)mc.GetFriction(),
+                                                        mc.GetContactForce(), mc.GetContactTorque(), mc.GetModelA(),
+                                                        mc.GetModelB());
+        if (!proceed)
+            break;
+    }
+}
+
+////////// STATE INTERFACE ////
+
+// The multipliers of the i-th contact are at offset 3*i, the ones of
+// the rolling contacts follow, 6 for each.
+
+void ChContactContainerPooled::IntStateGatherReactions(const unsigned int off_L, ChVectorDynamic<>& L) {
+    int nc = contacts.GetNused();
+    for (int i = 0; i < nc; i++)
+        contacts[i].ContIntStateGatherReactions(off_L + 3 * i, L);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ContIntStateGatherReactions(off_L + 3 * nc + 6 * i, L);
+}
+
+void ChContactContainerPooled::IntStateScatterReactions(const unsigned int off_L, const ChVectorDynamic<>& L) {
+    int nc = contacts.GetNused();
+    for (int i = 0; i < nc; i++)
+        contacts[i].ContIntStateScatterReactions(off_L + 3 * i, L);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ContIntStateScatterReactions(off_L + 3 * nc + 6 * i, L);
+}
+
+void ChContactContainerPooled::IntLoadResidual_CqL(const unsigned int off_L,    ///< offset in L multipliers
+                                                   ChVectorDynamic<>& R,        ///< result: R += c*Cq'*L
+                                                   const ChVectorDynamic<>& L,  ///< the L vector
+                                                   const double c               ///< a scaling factor
+                                                   ) {
+    int nc = contacts.GetNused();
+    for (int i = 0; i < nc; i++)
+        contacts[i].ContIntLoadResidual_CqL(off_L + 3 * i, R, L, c);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ContIntLoadResidual_CqL(off_L + 3 * nc + 6 * i, R, L, c);
+}
+
+void ChContactContainerPooled::IntLoadConstraint_C(const unsigned int off,  ///< offset in Qc residual
+                                                   ChVectorDynamic<>& Qc,   ///< result: the Qc residual, Qc += c*C
+                                                   const double c,          ///< a scaling factor
+                                                   bool do_clamp,           ///< apply clamping to c*C?
+                                                   double recovery_clamp    ///< value for min/max clamping of c*C
+                                                   ) {
+    int nc = contacts.GetNused();
+    for (int i = 0; i < nc; i++)
+        contacts[i].ContIntLoadConstraint_C(off + 3 * i, Qc, c, do_clamp, recovery_clamp);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ContIntLoadConstraint_C(off + 3 * nc + 6 * i, Qc, c, do_clamp, recovery_clamp);
+}
+
+void ChContactContainerPooled::IntToLCP(const unsigned int off_v,  ///< offset in v, R
+                                        const ChStateDelta& v,
+                                        const ChVectorDynamic<>& R,
+                                        const unsigned int off_L,  ///< offset in L, Qc
+                                        const ChVectorDynamic<>& L,
+                                        const ChVectorDynamic<>& Qc) {
+    int nc = contacts.GetNused();
+    for (int i = 0; i < nc; i++)
+        contacts[i].ContIntToLCP(off_L + 3 * i, L, Qc);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ContIntToLCP(off_L + 3 * nc + 6 * i, L, Qc);
+}
+
+void ChContactContainerPooled::IntFromLCP(const unsigned int off_v,  ///< offset in v
+                                          ChStateDelta& v,
+                                          const unsigned int off_L,  ///< offset in L
+                                          ChVectorDynamic<>& L) {
+    int nc = contacts.GetNused();
+    for (int i = 0; i < nc; i++)
+        contacts[i].ContIntFromLCP(off_L + 3 * i, L);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ContIntFromLCP(off_L + 3 * nc + 6 * i, L);
+}
+
+////////// LCP INTERFACES ////
+
+void ChContactContainerPooled::InjectConstraints(ChLcpSystemDescriptor& mdescriptor) {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].InjectConstraints(mdescriptor);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].InjectConstraints(mdescriptor);
+}
+
+void ChContactContainerPooled::ConstraintsBiReset() {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsBiReset();
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsBiReset();
+}
+
+void ChContactContainerPooled::ConstraintsBiLoad_C(double factor, double recovery_clamp, bool do_clamp) {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsBiLoad_C(factor, recovery_clamp, do_clamp);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsBiLoad_C(factor, recovery_clamp, do_clamp);
+}
+
+void ChContactContainerPooled::ConstraintsLoadJacobians() {
+    // already loaded when ChContact objects are reset
+}
+
+void ChContactContainerPooled::ConstraintsFetch_react(double factor) {
+    // From constraints to react vector:
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsFetch_react(factor);
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsFetch_react(factor);
+}
+
+// Following functions are for exploiting the contact persistence
+
+void ChContactContainerPooled::ConstraintsLiLoadSuggestedSpeedSolution() {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsLiLoadSuggestedSpeedSolution();
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsLiLoadSuggestedSpeedSolution();
+}
+
+void ChContactContainerPooled::ConstraintsLiLoadSuggestedPositionSolution() {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsLiLoadSuggestedPositionSolution();
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsLiLoadSuggestedPositionSolution();
+}
+
+void ChContactContainerPooled::ConstraintsLiFetchSuggestedSpeedSolution() {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsLiFetchSuggestedSpeedSolution();
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsLiFetchSuggestedSpeedSolution();
+}
+
+void ChContactContainerPooled::ConstraintsLiFetchSuggestedPositionSolution() {
+    for (int i = 0; i < contacts.GetNused(); i++)
+        contacts[i].ConstraintsLiFetchSuggestedPositionSolution();
+    for (int i = 0; i < contacts_roll.GetNused(); i++)
+        contacts_roll[i].ConstraintsLiFetchSuggestedPositionSolution();
+}
+
+}  // END_OF_NAMESPACE____
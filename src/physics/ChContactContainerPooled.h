@@ -0,0 +1,210 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+#ifndef CHCONTACTCONTAINERPOOLED_H
+#define CHCONTACTCONTAINERPOOLED_H
+
+///////////////////////////////////////////////////
+//
+//   ChContactContainerPooled.h
+//
+//   Class for container of many contacts, stored
+//   in pools of ChContact objects that are recycled
+//   at each step, without allocations.
+//
+//   HEADER file for CHRONO,
+//	 Multibody dynamics engine
+//
+// ------------------------------------------------
+//             www.deltaknowledge.com
+// ------------------------------------------------
+///////////////////////////////////////////////////
+
+#include <vector>
+
+#include "physics/ChContactContainer.h"
+
+namespace chrono {
+
+/// A pool of objects, allocated in contiguous blocks of fixed size.
+/// The objects never move once created, so the pointers to them (ex.
+/// in the LCP system descriptor, or between the constraints of a
+/// contact) stay valid. After Rewind(), the same objects are given
+/// again by Next(), in the same order, without allocations.
+
+template <class T>
+class ChContactPool {
+  private:
+    enum { BLOCK_BITS = 10, BLOCK_SIZE = 1 << BLOCK_BITS };  // blocks of 1024 objects
+
+    std::vector<T*> blocks;
+    int nused;
+
+    // not copyable
+    ChContactPool(const ChContactPool&);
+    ChContactPool& operator=(const ChContactPool&);
+
+  public:
+    ChContactPool() : nused(0) {}
+    ~ChContactPool() { Clear(); }
+
+    /// Number of objects given by Next() since the last Rewind().
+    int GetNused() const { return nused; }
+
+    /// Number of allocated objects.
+    int GetCapacity() const { return (int)blocks.size() * BLOCK_SIZE; }
+
+    /// Access the i-th object.
+    T& operator[](int i) { return blocks[i >> BLOCK_BITS][i & (BLOCK_SIZE - 1)]; }
+
+    /// Get the next object, recycling an old one if possible.
+    T& Next() {
+        if (nused == GetCapacity())
+            blocks.push_back(new T[BLOCK_SIZE]);
+        return (*this)[nused++];
+    }
+
+    /// Start giving again the objects from the first one.
+    void Rewind() { nused = 0; }
+
+    /// Delete all the objects.
+    void Clear() {
+        for (unsigned int i = 0; i < blocks.size(); i++)
+            delete[] blocks[i];
+        blocks.clear();
+        nused = 0;
+    }
+};
+
+///
+/// Class representing a container of many contacts between
+/// 6DOF bodies, as ChContactContainer, but the ChContact and
+/// ChContactRolling objects are stored in pools of contiguous
+/// blocks instead of linked lists. The contact objects are
+/// recycled at each step, so there is no allocation once the
+/// pools are large enough, and the i-th contact can be accessed
+/// directly by its index. Use it in place of the default
+/// container with ChSystem::ChangeContactContainer().
+///
+
+class ChApi ChContactContainerPooled : public ChContactContainerBase {
+    CH_RTTI(ChContactContainerPooled, ChContactContainerBase);
+
+  protected:
+    //
+    // DATA
+    //
+
+    ChContactPool<ChContact> contacts;
+
+    ChContactPool<ChContactRolling> contacts_roll;
+
+  public:
+    //
+    // CONSTRUCTORS
+    //
+
+    ChContactContainerPooled();
+
+    virtual ~ChContactContainerPooled();
+
+    //
+    // FUNCTIONS
+    //
+    /// Tell the number of added contacts
+    virtual int GetNcontacts() { return contacts.GetNused() + contacts_roll.GetNused(); }
+
+    /// Number of contacts without rolling friction.
+    int GetNcontactsSliding() { return contacts.GetNused(); }
+    /// Access the i-th contact without rolling friction.
+    ChContact& GetContact(int i) { return contacts[i]; }
+
+    /// Number of contacts with rolling or spinning friction.
+    int GetNcontactsRolling() { return contacts_roll.GetNused(); }
+    /// Access the i-th contact with rolling or spinning friction.
+    ChContactRolling& GetContactRolling(int i) { return contacts_roll[i]; }
+
+    /// Remove all the contacts, and free the memory of the pools.
+    virtual void RemoveAllContacts();
+
+    /// The collision system will call BeginAddContact() before adding
+    /// all contacts (for example with AddContact() or similar). This rewinds
+    /// the pools, so that the old contact objects are reused.
+    virtual void BeginAddContact();
+
+    /// Add a contact between two frames.
+    virtual void AddContact(const collision::ChCollisionInfo& mcontact);
+
+    /// Add many contacts at once. The bodies and the materials of the
+    /// contacts are fetched in parallel, and the contact objects are
+    /// initialized in parallel. The custom callback, if any, is called
+    /// serially in the order of the contacts.
+    virtual void AddContacts(const std::vector<collision::ChCollisionInfo>& mcontacts);
+
+    /// The collision system will call EndAddContact() after adding
+    /// all contacts. Nothing to do here: the unused contact objects
+    /// stay in the pools, for the next steps.
+    virtual void EndAddContact() {}
+
+    /// Scans all the contacts and for each contact exacutes the ReportContactCallback()
+    /// function of the user object inherited from ChReportContactCallback.
+    virtual void ReportAllContacts(ChReportContactCallback* mcallback);
+
+    /// Tell the number of scalar bilateral constraints (actually, friction
+    /// constraints aren't exactly as unilaterals, but count them too)
+    virtual int GetDOC_d() { return (contacts.GetNused() * 3) + (contacts_roll.GetNused() * 6); }
+
+    /// In detail, it computes jacobians, violations, etc. and stores
+    /// results in inner structures of contacts.
+    virtual void Update(double mtime, bool update_assets = true);
+
+    //
+    // STATE FUNCTIONS
+    //
+
+    // (override/implement interfaces for global state vectors, see ChPhysicsItem for comments.)
+    virtual void IntStateGatherReactions(const unsigned int off_L, ChVectorDynamic<>& L);
+    virtual void IntStateScatterReactions(const unsigned int off_L, const ChVectorDynamic<>& L);
+    virtual void IntLoadResidual_CqL(const unsigned int off_L,
+                                     ChVectorDynamic<>& R,
+                                     const ChVectorDynamic<>& L,
+                                     const double c);
+    virtual void IntLoadConstraint_C(const unsigned int off,
+                                     ChVectorDynamic<>& Qc,
+                                     const double c,
+                                     bool do_clamp,
+                                     double recovery_clamp);
+    virtual void IntToLCP(const unsigned int off_v,
+                          const ChStateDelta& v,
+                          const ChVectorDynamic<>& R,
+                          const unsigned int off_L,
+                          const ChVectorDynamic<>& L,
+                          const ChVectorDynamic<>& Qc);
+    virtual void IntFromLCP(const unsigned int off_v, ChStateDelta& v, const unsigned int off_L, ChVectorDynamic<>& L);
+
+    //
+    // LCP INTERFACE
+    //
+
+    virtual void InjectConstraints(ChLcpSystemDescriptor& mdescriptor);
+    virtual void ConstraintsBiReset();
+    virtual void ConstraintsBiLoad_C(double factor = 1., double recovery_clamp = 0.1, bool do_clamp = false);
+    virtual void ConstraintsLoadJacobians();
+    virtual void ConstraintsLiLoadSuggestedSpeedSolution();
+    virtual void ConstraintsLiLoadSuggestedPositionSolution();
+    virtual void ConstraintsLiFetchSuggestedSpeedSolution();
+    virtual void ConstraintsLiFetchSuggestedPositionSolution();
+    virtual void ConstraintsFetch_react(double factor = 1.);
+};
+
+}  // END_OF_NAMESPACE____
+
+#endif
@@ -35,6 +35,7 @@
 
 #include "lcp/ChLcpSystemDescriptor.h"
 #include "lcp/ChLcpSimplexSolver.h"
+#include "lcp/ChLcpSparseDirectSolver.h"
 #include "lcp/ChLcpIterativeSOR.h"
 #include "lcp/ChLcpIterativeSymmSOR.h"
 #include "lcp/ChLcpIterativeSORmultithread.h"
@@ -499,6 +500,10 @@ void ChSystem::SetLcpSolverType(eCh_lcpSolver mval) {
             LCP_solver_speed = new ChLcpIterativeMINRES();
             LCP_solver_stab = new ChLcpIterativeMINRES();
             break;
+        case LCP_DIRECT_SPARSE:
+            LCP_solver_speed = new ChLcpSparseDirectSolver();
+            LCP_solver_stab = new ChLcpSparseDirectSolver();
+            break;
         default:
             LCP_solver_speed = new ChLcpIterativeSymmSOR();
             LCP_solver_stab = new ChLcpIterativeSymmSOR();
@@ -1811,12 +1816,17 @@ void ChSystem::StateSolveCorrection(ChStateDelta& Dv,             ///< result: c
                                     const ChState& x,             ///< current state, x part
                                     const ChStateDelta& v,        ///< current state, v part
                                     const double T,               ///< current time T
-                                    bool force_state_scatter  ///< if false, x,v and T are not scattered to the system,
+                                    bool force_state_scatter,  ///< if false, x,v and T are not scattered to the system,
                                     /// assuming that someone has done StateScatter just before
+                                    bool force_setup  ///< if false, the matrix of the last call may be reused
                                     ) {
     if (force_state_scatter)
         this->StateScatter(x, v, T);
 
+    // The G matrix is not needed if the LCP solver reuses its last factorization. The jacobians
+    // are always loaded, because the residuals of the next iteration are computed with them.
+    bool reuse = !force_setup && GetLcpSolverSpeed()->CanReuseFactorization();
+
     // R and Qc vectors  --> LCP sparse solver structures  (also sets L and Dv to warmstart)
 
     for (unsigned int ip = 0; ip < bodylist.size(); ++ip)  // ITERATE on bodies
@@ -1854,7 +1864,7 @@ void ChSystem::StateSolveCorrection(ChStateDelta& Dv,             ///< result: c
 
         PHpointer->ConstraintsLoadJacobians();
 
-        if (c_a || c_v || c_x)
+        if ((c_a || c_v || c_x) && !reuse)
             PHpointer->KRMmatricesLoad(-c_x, -c_v, c_a);
     }
 
@@ -1896,7 +1906,10 @@ void ChSystem::StateSolveCorrection(ChStateDelta& Dv,             ///< result: c
 
     timer_lcp.start();
 
-    GetLcpSolverSpeed()->Solve(*this->LCP_descriptor);
+    if (reuse)
+        GetLcpSolverSpeed()->SolveReusingFactorization(*this->LCP_descriptor);
+    else
+        GetLcpSolverSpeed()->Solve(*this->LCP_descriptor);
 
     timer_lcp.stop();
 
@@ -240,6 +240,7 @@ class ChApi ChSystem : public ChObj, public ChIntegrableIIorderEasy {
         LCP_ITERATIVE_APGD,
         LCP_DEM,
         LCP_ITERATIVE_MINRES,
+        LCP_DIRECT_SPARSE,  // only bilateral constraints, ex. FEA with implicit timesteppers
     };
 
     /// Choose the LCP solver type, to be used for the simultaneous
@@ -716,6 +717,9 @@ class ChApi ChSystem : public ChObj, public ChIntegrableIIorderEasy {
     ///  |Du| = [ G   Cq' ]^-1 * | R |
     ///  |DL|   [ Cq  0   ]      | Qc|
     /// for residual R and  G = [ c_a*M + c_v*dF/dv + c_x*dF/dx ]
+    /// If force_setup is false and the LCP solver can reuse its last
+    /// factorization, the G matrix (ex. the FEA tangent stiffness) is not
+    /// loaded again.
     virtual void StateSolveCorrection(ChStateDelta& Dv,             ///< result: computed Dv
                                       ChVectorDynamic<>& L,         ///< result: computed lagrangian multipliers, if any
                                       const ChVectorDynamic<>& R,   ///< the R residual
@@ -726,9 +730,10 @@ class ChApi ChSystem : public ChObj, public ChIntegrableIIorderEasy {
                                       const ChState& x,             ///< current state, x part
                                       const ChStateDelta& v,        ///< current state, v part
                                       const double T,               ///< current time T
-                                      bool force_state_scatter = true  ///< if false, x,v and T are not scattered to the
-                                      /// system, assuming that someone has done
+                                      bool force_state_scatter = true,  ///< if false, x,v and T are not scattered to
+                                      /// the system, assuming that someone has done
                                       /// StateScatter just before
+                                      bool force_setup = true  ///< if false, the matrix of the last call may be reused
                                       );
 
     /// Increment a vector R with the term c*F:
@@ -304,6 +304,9 @@ class ChApi ChIntegrableIIorder : public ChIntegrable {
     /// where R is a given residual, dF/dv and dF/dx, dF/dv are jacobians (that are also
     /// -R and -K, damping and stiffness (tangent) matrices in many mechanical problems, note the minus sign!).
     /// It is up to the child class how to solve such linear system.
+    /// If force_setup is false, the matrix of the previous call can be used
+    /// again (ex. its factorization is reused in modified Newton iterations),
+    /// and only the residuals R and Qc are new.
     virtual void StateSolveCorrection(ChStateDelta& Dv,             ///< result: computed Dv
                                       ChVectorDynamic<>& L,         ///< result: computed lagrangian multipliers, if any
                                       const ChVectorDynamic<>& R,   ///< the R residual
@@ -314,9 +317,10 @@ class ChApi ChIntegrableIIorder : public ChIntegrable {
                                       const ChState& x,             ///< current state, x part
                                       const ChStateDelta& v,        ///< current state, v part
                                       const double T,               ///< current time T
-                                      bool force_state_scatter = true  ///< if false, x,v and T are not scattered to the
-                                      /// system, assuming that someone has done
+                                      bool force_state_scatter = true,  ///< if false, x,v and T are not scattered to
+                                      /// the system, assuming that someone has done
                                       /// StateScatter just before
+                                      bool force_setup = true  ///< if false, the matrix of the last call may be reused
                                       ) {
         throw ChException("StateSolveCorrection() not implemented, implicit integrators cannot be used. ");
     };
@@ -711,6 +711,16 @@ void ChTimestepperHHT::Advance(const double dt  ///< timestep to advance
     // (alpha/(1+alpha))(f_old +Cq*l_old)]
     // [ Cq                                      0   ] [ Dl       ] = [ 1/(beta*dt^2)*C ]
 
+    // The matrix of the last setup, also from a previous step, depends on dt
+    // and on the number of coordinates and constraints.
+    if (dt != setup_dt || mintegrable->GetNcoords_v() != setup_nv || mintegrable->GetNconstr() != setup_nc)
+        setup_valid = false;
+
+    num_iterations = 0;
+    num_setups = 0;
+    bool reused = false;
+    double Rnorm_old = 0;
+
     for (int i = 0; i < this->GetMaxiters(); ++i) {
         mintegrable->StateScatter(Xnew, Vnew, T + dt);  // state -> system
         R = Rold;
@@ -723,18 +733,34 @@ void ChTimestepperHHT::Advance(const double dt  ///< timestep to advance
         if (verbose)
             GetLog() << " HHT iteration=" << i << "  |R|=" << R.NormTwo() << "  |Qc|=" << Qc.NormTwo() << "\n";
 
-        if ((R.NormInf() < this->GetTolerance()) && (Qc.NormInf() < this->GetTolerance()))
+        double Rnorm = ChMax(R.NormInf(), Qc.NormInf());
+        if (Rnorm < this->GetTolerance())
             break;
 
+        // In modified Newton iterations, the old matrix is kept while the residual decreases fast enough
+        bool setup = !modified_newton || !setup_valid || (reused && Rnorm > max_convergence_rate * Rnorm_old);
+
         mintegrable->StateSolveCorrection(
             Da, Dl, R, Qc,
             (1.0 / (1.0 + alpha)),  // factor for  M (was 1 in Negrut paper ?!)
             -dt * gamma,            // factor for  dF/dv
             -dt * dt * beta,        // factor for  dF/dx
             Xnew, Vnew, T + dt,
-            false  // do not StateScatter update to Xnew Vnew T+dt before computing correction
+            false,  // do not StateScatter update to Xnew Vnew T+dt before computing correction
+            setup   // if false, the matrix of the last setup can be reused
             );
 
+        if (setup) {
+            setup_valid = true;
+            setup_dt = dt;
+            setup_nv = mintegrable->GetNcoords_v();
+            setup_nc = mintegrable->GetNconstr();
+            num_setups++;
+        }
+        reused = !setup;
+        Rnorm_old = Rnorm;
+        num_iterations++;
+
         L += Dl;  // Note it is not -= Dl because we assume StateSolveCorrection flips sign of Dl
         Anew += Da;
 
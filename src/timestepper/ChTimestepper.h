@@ -428,11 +428,28 @@ class ChApi ChTimestepperHHT : public ChTimestepperIIorder, public ChImplicitIte
     ChVectorDynamic<> Rold;
     ChVectorDynamic<> Qc;
 
+    bool modified_newton;
+    double max_convergence_rate;
+    bool setup_valid;  // the matrix of the last setup can be reused
+    double setup_dt;
+    int setup_nv;
+    int setup_nc;
+    int num_iterations;
+    int num_setups;
+
   public:
     /// Constructors (default empty)
     ChTimestepperHHT(ChIntegrableIIorder& mintegrable)
         : ChTimestepperIIorder(mintegrable), ChImplicitIterativeTimestepper() {
         SetAlpha(-0.2);  // default: some dissipation
+        modified_newton = false;
+        max_convergence_rate = 0.3;
+        setup_valid = false;
+        setup_dt = 0;
+        setup_nv = 0;
+        setup_nc = 0;
+        num_iterations = 0;
+        num_setups = 0;
     };
 
     /// Set the numerical damping parameter.
@@ -452,6 +469,36 @@ class ChApi ChTimestepperHHT : public ChTimestepperIIorder, public ChImplicitIte
 
     double GetAlpha() { return alpha; }
 
+    /// Turn on/off the modified Newton method. If on, the matrix of the
+    /// Newton iterations (the jacobian) is not assembled and factorized
+    /// at each iteration: the last one is reused, also in the following
+    /// timesteps, as long as the residual decreases fast enough (see
+    /// SetMaxConvergenceRate()) and the timestep and the number of
+    /// coordinates and constraints do not change. This saves most of the
+    /// factorizations in stiff problems (FEA, vehicles), but more iterations
+    /// might be needed, so consider increasing SetMaxiters(). It is
+    /// effective only with LCP solvers that can reuse their factorization,
+    /// ex. ChLcpSparseDirectSolver. Default: off.
+    void SetModifiedNewton(bool mmod) {
+        modified_newton = mmod;
+        setup_valid = false;
+    }
+    bool GetModifiedNewton() { return modified_newton; }
+
+    /// In modified Newton iterations, the matrix is set up again if the
+    /// norm of the residual is not reduced at least by this factor from
+    /// the previous iteration. Default 0.3.
+    void SetMaxConvergenceRate(double mrate) { max_convergence_rate = mrate; }
+    double GetMaxConvergenceRate() { return max_convergence_rate; }
+
+    /// Number of Newton iterations performed in the last timestep.
+    int GetNumIterations() { return num_iterations; }
+
+    /// Number of times the matrix of the Newton iterations was set up
+    /// (assembled and factorized) in the last timestep. It is the same as
+    /// GetNumIterations() unless the modified Newton method is used.
+    int GetNumSetups() { return num_setups; }
+
     /// Performs an integration timestep
     virtual void Advance(const double dt  ///< timestep to advance
                          );
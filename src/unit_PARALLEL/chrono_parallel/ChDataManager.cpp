@@ -148,3 +148,56 @@ int ChParallelDataManager::ExportCurrentSystem(std::string output_dir) {
 
   return 0;
 }
+
+// Move the contents of a vector to new storage. The host system of thrust is
+// OpenMP, so the new storage is initialized by a parallel loop and each page is
+// first touched by the same thread that copies (and later processes) it.
+template <typename T>
+static void FirstTouchVector(host_vector<T>& data) {
+  const int size = data.size();
+  host_vector<T> touched(size);
+
+#pragma omp parallel for
+  for (int i = 0; i < size; i++) {
+    touched[i] = data[i];
+  }
+  data.swap(touched);
+}
+
+void ChParallelDataManager::FirstTouch() {
+  // Per body data
+  FirstTouchVector(host_data.pos_rigid);
+  FirstTouchVector(host_data.rot_rigid);
+  FirstTouchVector(host_data.vel_rigid);
+  FirstTouchVector(host_data.omg_rigid);
+  FirstTouchVector(host_data.active_rigid);
+  FirstTouchVector(host_data.collide_rigid);
+  FirstTouchVector(host_data.mass_rigid);
+  FirstTouchVector(host_data.sleep_timer);
+  FirstTouchVector(host_data.sleep_island);
+  // Per body material data (DVI or DEM, the other ones are empty)
+  FirstTouchVector(host_data.fric_data);
+  FirstTouchVector(host_data.cohesion_data);
+  FirstTouchVector(host_data.compliance_data);
+  FirstTouchVector(host_data.elastic_moduli);
+  FirstTouchVector(host_data.mu);
+  FirstTouchVector(host_data.cr);
+  FirstTouchVector(host_data.dem_coeffs);
+  // Per shape data
+  FirstTouchVector(host_data.ObA_rigid);
+  FirstTouchVector(host_data.ObB_rigid);
+  FirstTouchVector(host_data.ObC_rigid);
+  FirstTouchVector(host_data.ObR_rigid);
+  FirstTouchVector(host_data.fam_rigid);
+  FirstTouchVector(host_data.typ_rigid);
+  FirstTouchVector(host_data.margin_rigid);
+  FirstTouchVector(host_data.id_rigid);
+  FirstTouchVector(host_data.aabb_min_rigid);
+  FirstTouchVector(host_data.aabb_max_rigid);
+}
+
+void ChParallelDataManager::SetPhaseThreads(THREADPHASE phase) {
+  if (settings.phase_thread_tuning && measures.threads.num_threads[phase] > 0) {
+    CHOMPfunctions::SetNumThreads(measures.threads.num_threads[phase]);
+  }
+}
@@ -59,9 +59,6 @@ typedef blaze::DenseSubvector<DynamicVector<real> > SubVectorType;
 typedef blaze::SparseSubmatrix<const CompressedMatrix<real> > ConstSubMatrixType;
 typedef blaze::DenseSubvector<const DynamicVector<real> > ConstSubVectorType;
 
-// The maximum number of shear history contacts per smaller body (DEM)
-#define max_shear 20
-
 struct host_container {
   // Collision data
   host_vector<real3> ObA_rigid;       // Position of shape
@@ -99,8 +96,12 @@ struct host_container {
   host_vector<real3> ct_body_torque;  // Total contact torque on these bodies
 
   // Contact shear history (DEM)
-  host_vector<int3> shear_neigh;  // Neighbor list of contacting bodies and shapes
-  host_vector<real3> shear_disp;  // Accumulated shear displacement for each neighbor
+  // Open addressing hash table keyed by shape pair, with linear probing. The
+  // first half of the table is addressed by the hash, the second half holds
+  // the entries that overflow past the end of the first half.
+  host_vector<long long> shear_pair;  // Shape pair of each slot, -1 for empty slots
+  host_vector<int> shear_occurrence;  // Index of the contact among the contacts of the same pair
+  host_vector<real3> shear_disp;      // Accumulated shear displacement of each slot
 
   // Mapping from all bodies in the system to bodies involved in a contact.
   // For bodies that are currently not in contact, the mapping entry is -1.
@@ -121,9 +122,14 @@ struct host_container {
   // Object data
   host_vector<real3> pos_rigid;
   host_vector<real4> rot_rigid;
+  host_vector<real3> vel_rigid;  // Linear velocity (absolute frame)
+  host_vector<real3> omg_rigid;  // Angular velocity (body frame)
   host_vector<bool> active_rigid;
   host_vector<bool> collide_rigid;
   host_vector<real> mass_rigid;
+  host_vector<real> sleep_timer;  // Time each body has been resting, used to put bodies to sleep
+  host_vector<uint> sleep_island; // Island of each sleeping body, the stable id of a body of the island
+  host_vector<uint> uid_rigid;    // Stable id of each body (its insertion order), kept when bodies are renumbered
 
   host_vector<real3> pos_fluid;
   host_vector<real3> vel_fluid;
@@ -242,6 +248,13 @@ class CH_PARALLEL_API ChParallelDataManager {
   // Convenience function that outputs all of the data associated for a system
   // This is useful when debugging
   int ExportCurrentSystem(std::string output_dir);
+  // Copy the per body and per shape arrays to new storage using a static
+  // parallel loop so that each memory page is first touched by the thread that
+  // processes it, see settings.numa_first_touch
+  void FirstTouch();
+  // Set the number of OpenMP threads for a phase of the step, does nothing
+  // unless settings.phase_thread_tuning picked a number for this phase
+  void SetPhaseThreads(THREADPHASE phase);
 };
 }
 
@@ -32,11 +32,17 @@ struct collision_measures {
     max_bounding_point = 0;
     global_origin = 0;
     bin_size_vec = 0;
+    rebinned_shapes = 0;
+    grid_levels = 1;
+    pairs_reused = 0;
   }
   real3 min_bounding_point;  // The minimal global bounding point
   real3 max_bounding_point;  // The maximum global bounding point
   real3 global_origin;       // The global zero point
   real3 bin_size_vec;        // Vector holding bin sizes for each dimension
+  uint rebinned_shapes;      // Number of shapes (re)inserted into the grid during the last broadphase
+  uint grid_levels;          // Number of levels used by the hierarchical grid
+  uint pairs_reused;         // Number of steps the current list of pairs was reused for, 0 if the broadphase ran
 };
 // solver_measures, like the name implies is the structure that contains all
 // measures associated with the parallel solver.
@@ -45,18 +51,52 @@ struct solver_measures {
     total_iteration = 0;
     residual = 0;
     objective_value = 0;
+    warm_started_contacts = 0;
+    num_colors = 0;
   }
-  int total_iteration;   // The total number of iterations performed, this variable accumulates
-  real residual;         // Current residual for the solver
-  real objective_value;  // Current objective value for the solver
+  int total_iteration;         // The total number of iterations performed, this variable accumulates
+  real residual;               // Current residual for the solver
+  real objective_value;        // Current objective value for the solver
+  uint warm_started_contacts;  // Number of contacts that were matched with a contact from the previous step
+  uint num_colors;             // Number of contact colors used by the Gauss-Seidel solver
 
   // These three variables are used to store the convergence history of the solver
   custom_vector<real> maxd_hist, maxdeltalambda_hist;
 };
 
+// sleep_measures, like the name implies is the structure that contains all
+// measures associated with sleeping bodies.
+struct sleep_measures {
+  sleep_measures() {
+    num_islands = 0;
+    num_sleeping = 0;
+  }
+  uint num_islands;   // Number of islands of bodies that are not fixed found during the last step
+  uint num_sleeping;  // Number of bodies sleeping at the end of the last step
+};
+
+// thread_measures, like the name implies is the structure that contains all
+// measures associated with the per phase thread tuning.
+struct thread_measures {
+  thread_measures() {
+    for (int i = 0; i < NUM_THREAD_PHASES; i++) {
+      num_threads[i] = 0;
+      phase_time[i] = 0;
+      settled[i] = false;
+    }
+    num_changes = 0;
+  }
+  int num_threads[NUM_THREAD_PHASES];    // Number of threads currently used by each phase, 0 if not tuned yet
+  double phase_time[NUM_THREAD_PHASES];  // Average time of each phase over the last tuning window
+  bool settled[NUM_THREAD_PHASES];       // True if the phase found its best number of threads
+  uint num_changes;                      // Number of times a phase accepted a new number of threads
+};
+
 struct measures_container {
   collision_measures collision;
   solver_measures solver;
+  sleep_measures sleep;
+  thread_measures threads;
 };
 }
 
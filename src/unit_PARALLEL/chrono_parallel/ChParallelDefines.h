@@ -34,6 +34,10 @@
 #include <thrust/execution_policy.h>
 #include <thrust/system/cpp/execution_policy.h>
 #include <thrust/system/omp/execution_policy.h>
+#include <thrust/remove.h>
+#include <thrust/functional.h>
+#include <thrust/gather.h>
+#include <thrust/host_vector.h>
 
 #ifdef _MSC_VER
 #define thrust_parallel thrust::cpp::par
@@ -112,8 +116,19 @@ static std::ostream null_stream(&null_buffer);
 #define Thrust_Min(x) x[thrust::min_element(x.begin(), x.end()) - x.begin()]
 #define Thrust_Total(x) thrust::reduce(x.begin(), x.end())
 #define Thrust_Unique(x) thrust::unique(x.begin(), x.end()) - x.begin();
+// Erase the entries of x whose flag in y is set, the order of the others is kept
+#define Thrust_Compact(x, y) \
+  x.erase(thrust::remove_if(x.begin(), x.end(), y.begin(), thrust::identity<uint>()), x.end())
 #define DBG(x) printf(x);
 
+// Reorder x so that its i-th entry is the entry y[i] of the original vector
+template <typename T>
+inline void Thrust_Permute(custom_vector<T>& x, const custom_vector<int>& y) {
+  custom_vector<T> temp(y.size());
+  thrust::gather(thrust_parallel, y.begin(), y.end(), x.begin(), temp.begin());
+  x.swap(temp);
+}
+
 enum SOLVERTYPE {
   STEEPEST_DESCENT,
   GRADIENT_DESCENT,
@@ -132,8 +147,12 @@ enum SOLVERTYPE {
 
 enum SOLVERMODE { NORMAL, SLIDING, SPINNING, BILATERAL };
 
+enum JACOBIANSTORAGE { JACOBIAN_CSR, JACOBIAN_BLOCK, JACOBIAN_MATRIX_FREE };
+
 enum COLLISIONSYSTEMTYPE { COLLSYS_PARALLEL, COLLSYS_BULLET_PARALLEL };
 
+enum BROADPHASETYPE { BROADPHASE_GRID, BROADPHASE_SAP, BROADPHASE_HIERARCHICAL_GRID };
+
 enum NARROWPHASETYPE {
   NARROWPHASE_MPR,
   NARROWPHASE_GJK,
@@ -146,6 +165,17 @@ enum NARROWPHASETYPE {
 // type of system is used.
 enum SYSTEMTYPE { SYSTEM_DVI, SYSTEM_DEM };
 
+// How the OpenMP threads are pinned to processors. COMPACT fills the cores of
+// one socket before moving to the next, SCATTER spreads the threads evenly
+// over the sockets.
+enum THREADAFFINITY { AFFINITY_NONE, AFFINITY_COMPACT, AFFINITY_SCATTER };
+
+// Space filling curve used to sort the bodies by position
+enum SPACEFILLINGCURVE { CURVE_MORTON, CURVE_HILBERT };
+
+// Phases of a step that get their own number of threads from the thread tuning
+enum THREADPHASE { PHASE_UPDATE, PHASE_BROADPHASE, PHASE_NARROWPHASE, PHASE_SOLVER, NUM_THREAD_PHASES };
+
 enum BILATERALTYPE { BODY_BODY, SHAFT_SHAFT, SHAFT_SHAFT_SHAFT, SHAFT_BODY, SHAFT_SHAFT_BODY, UNKNOWN };
 
 // DEM contact force model
@@ -44,9 +44,14 @@ struct collision_settings {
     // NOTE!!! this really depends on the architecture that you run on and how
     // many cores you are using.
     bins_per_axis = I3(20, 20, 20);
+    broadphase_algorithm = BROADPHASE_GRID;
     narrowphase_algorithm = NARROWPHASE_HYBRID_MPR;
     grid_density = 5;
     fixed_bins = true;
+    incremental_broadphase = false;
+    grid_padding = 1;
+    single_pass_broadphase = false;
+    pair_reuse_skin = 0;
   }
 
   real3 min_bounding_point, max_bounding_point;
@@ -68,6 +73,14 @@ struct collision_settings {
   // the broadphase stage the extents of the simulation are computed and then
   // sliced according to the variable.
   int3 bins_per_axis;
+  // The broadphase can either use a uniform grid (the default), sweep and
+  // prune or a hierarchical grid. The uniform grid is faster when all shapes
+  // have similar sizes while sweep and prune does not suffer when a few very
+  // large shapes (terrain, ground boxes) are mixed with many small ones. The
+  // hierarchical grid uses bins_per_axis for its finest level and stores each
+  // shape in the level where it spans at most two bins per axis, so large
+  // shapes no longer overlap thousands of bins.
+  BROADPHASETYPE broadphase_algorithm;
   // There are multiple narrowphase algorithms implemented in the collision
   // detection code. The narrowphase_algorithm parameter can be used to change
   // the type of narrowphase used at runtime.
@@ -75,6 +88,30 @@ struct collision_settings {
   real grid_density;
   //use fixed number of bins instead of tuning them
   bool fixed_bins;
+  // When enabled the grid broadphase keeps its sorted bin lists between steps and
+  // only re-bins the shapes whose range of grid cells changed. The grid itself
+  // is only rebuilt when the number of shapes changes, when bins_per_axis is
+  // modified or when the shapes leave the region covered by the current grid.
+  // This is beneficial when most objects move less than a bin per step.
+  bool incremental_broadphase;
+  // Margin added on each side of the bounding box when the incremental
+  // broadphase builds its grid, as a fraction of the bin size. The shapes can
+  // move by this much past the bounding box before the grid is rebuilt.
+  real grid_padding;
+  // By default the grid broadphase tests every bin twice, once to count the
+  // pairs and once to store them, and then removes the pairs found in several
+  // bins. In single pass mode every thread appends the pairs to its own buffer
+  // and a pair is only reported by one of the bins it spans. Not used by the
+  // hierarchical grid.
+  bool single_pass_broadphase;
+  // When larger than zero the bounding boxes used by the broadphase are grown
+  // by half of this distance on every side and the list of pairs found by the
+  // broadphase is reused, Verlet list style, until one of the bounding boxes
+  // has moved by more than half of this distance. In between only the
+  // narrowphase is run. Unlike the collision envelope this distance does not
+  // change the contacts that are generated, a larger value means that the
+  // broadphase runs less often but that the narrowphase tests more pairs.
+  real pair_reuse_skin;
 };
 // solver_settings, like the name implies is the structure that contains all
 // settings associated with the parallel solver.
@@ -98,6 +135,8 @@ struct solver_settings {
     presolve = false;
     compute_N = false;
     use_full_inertia_tensor = true;
+    warm_start = false;
+    jacobian_storage = JACOBIAN_CSR;
     max_iteration = 100;
     max_iteration_normal = 0;
     max_iteration_sliding = 100;
@@ -158,6 +197,23 @@ struct solver_settings {
   bool test_objective;
   real cohesion_epsilon;
   bool use_full_inertia_tensor;
+  // When enabled the DVI solver starts from the impulses computed in the
+  // previous step for every contact between the same pair of shapes, instead
+  // of starting from zero. This reduces the number of iterations needed when
+  // the contact set changes little between steps (stacking, settled piles).
+  bool warm_start;
+  // Storage used for the contact jacobians. JACOBIAN_CSR assembles D_n, D_t,
+  // D_s, their transposes and the M_inv*D products as sparse matrices.
+  // JACOBIAN_BLOCK only stores the dense per contact blocks (the normal and
+  // tangent directions and the angular terms of each body), the body of each
+  // block is known from the contact, and products with D and D^T are computed
+  // from the blocks. JACOBIAN_MATRIX_FREE stores nothing and recomputes the
+  // blocks from the contact normals and points in every product, trading
+  // extra flops for the smallest memory footprint. Bilaterals are always
+  // assembled. Only the iterative solvers based on ShurProduct (APGD, CG,
+  // MINRES, ...) support the block and matrix free storage, with Jacobi,
+  // Gauss-Seidel and PDIP the storage is switched back to JACOBIAN_CSR.
+  JACOBIANSTORAGE jacobian_storage;
 
   // Contact force model for DEM
   CONTACTFORCEMODEL contact_force_model;
@@ -199,6 +255,33 @@ struct solver_settings {
   real tolerance_objective;
 };
 
+// sleep_settings, like the name implies is the structure that contains all
+// settings associated with putting resting bodies to sleep. Sleeping bodies are
+// inactive, they are not integrated and contacts between two sleeping bodies
+// are not generated. The thresholds here are used instead of the ones stored
+// in every ChBody.
+struct sleep_settings {
+  sleep_settings() {
+    use_sleeping = false;
+    min_speed = 1e-3;
+    min_wvel = 1e-3;
+    sleep_time = 0.5;
+  }
+
+  // Bodies are grouped in islands, the groups of bodies connected by contacts
+  // or links (fixed bodies do not connect islands). An island is put to sleep
+  // when all of its bodies have been resting for sleep_time. A sleeping island
+  // that ends up in the same island as a moving body is woken up as a whole,
+  // and so is an island that loses a body or its fixed support to RemoveBody().
+  bool use_sleeping;
+  // A body is resting while its linear and angular speeds (largest component)
+  // are below these thresholds
+  real min_speed;
+  real min_wvel;
+  // Time a body must rest before it can be put to sleep
+  real sleep_time;
+};
+
 struct settings_container {
   settings_container() {
     // The default minimum number of threads is 1, set this to your max threads
@@ -215,14 +298,24 @@ struct settings_container {
     // I don't really check to see if max_threads is > than min_threads
     // not sure if that is a huge issue
     perform_thread_tuning = ((min_threads == max_threads) ? false : true);
+    phase_thread_tuning = false;
+    tuning_window = 10;
+    tuning_hold = 500;
     system_type = SYSTEM_DVI;
     step_size = .01;
+    host_body_state = false;
+    numa_first_touch = false;
+    thread_affinity = AFFINITY_NONE;
+    reorder_frequency = 0;
+    reorder_curve = CURVE_HILBERT;
   }
 
   // The settings for the collision detection
   collision_settings collision;
   // The settings for the solver
   solver_settings solver;
+  // The settings for sleeping bodies
+  sleep_settings sleep;
   // System level settings
   // If set to true chrono parallel will automatically check to see if increasing
   // the number of threads will improve performance. If performance is improved
@@ -235,12 +328,48 @@ struct settings_container {
   int min_threads;
   // This is the number of threads that the simulation will not exceed
   int max_threads;
+  // When enabled the thread tuning picks a number of threads for each phase of
+  // the step (update, broadphase, narrowphase and solver) instead of a single
+  // one. Each phase is timed over tuning_window steps and tries two more or two
+  // less threads, a trial is kept only if the phase becomes at least 5% faster.
+  // A phase stops exploring for tuning_hold steps once both directions failed.
+  // Only used when perform_thread_tuning is set.
+  bool phase_thread_tuning;
+  int tuning_window;
+  int tuning_hold;
   // The timestep of the simulation. This value is copied from chrono currently,
   // setting it has no effect.
   real step_size;
   // The system type defines if the system is solving the DVI frictional contact
   // problem or a DEM penalty based
   SYSTEMTYPE system_type;
+  // When enabled the positions, rotations and velocities of the rigid bodies
+  // live in the data manager and are integrated there, the ChBody objects are
+  // not read or written during a step. The state of a body is copied from the
+  // ChBody when it is added, later changes made through the ChBody are ignored.
+  // Call ChSystemParallel::SyncBodies() before reading the state of the
+  // bodies, the bodies attached to links are kept up to date automatically.
+  // The applied forces are the body force accumulators, the script forces and
+  // gravity, ChForce objects attached to bodies are not evaluated. Requires the
+  // parallel collision system.
+  bool host_body_state;
+  // When enabled the body and shape arrays in the data manager are copied to
+  // new storage by a static parallel loop whenever the number of bodies or the
+  // number of threads changes. On NUMA machines the memory pages then live on
+  // the socket of the thread that processes them in the other parallel loops.
+  bool numa_first_touch;
+  // Pin the OpenMP threads to processors, the threads are pinned again when the
+  // policy or the number of threads changes. With AFFINITY_NONE, and when the
+  // system is deleted, the threads get back the processors the process had
+  // before the pinning. Only supported on Linux, ignored elsewhere.
+  THREADAFFINITY thread_affinity;
+  // Every reorder_frequency steps the bodies and their shapes are sorted along
+  // a space filling curve so that bodies close in space are also close in
+  // memory, 0 disables the reordering. The bodies are renumbered, GetId() gives
+  // the current index and ChSystemParallel::GetBodyIndex() maps the stable id
+  // of a body to it. Requires the parallel collision system.
+  int reorder_frequency;
+  SPACEFILLINGCURVE reorder_curve;
 };
 }
 
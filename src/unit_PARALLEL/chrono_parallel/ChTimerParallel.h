@@ -12,13 +12,20 @@
 // Authors: Hammad Mazhar
 // =============================================================================
 //
-// Description: Parallel timer class that uses a map to query and add timers
+// Description: Parallel timer class that uses a map to query and add timers.
+// Timers can also be accessed through integer handles, and the timer values
+// of each step can be recorded along with solver counters and exported.
 // =============================================================================
 
 #ifndef CHTIMERPARALLEL_H
 #define CHTIMERPARALLEL_H
 
 #include <map>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
 
 #include "core/ChTimer.h"
 
@@ -71,79 +78,271 @@ struct TimerData {
   void stop() { timer.stop(); }
 };
 
+// Counters and timer values recorded at the end of a step
+struct TimerRecord {
+  int step;                  // Index of the step since the first record
+  double sim_time;           // Simulation time at the end of the step
+  uint num_bodies;           // Number of rigid bodies
+  uint num_contacts;         // Number of contacts of all types
+  int solver_iterations;     // Solver iterations performed in the step
+  double residual;           // Solver residual at the end of the step
+  double bytes_per_product;  // Bytes of assembled matrices read by one Shur product
+  std::vector<double> times; // Time of each timer, indexed by timer handle
+
+  TimerRecord() {
+    step = 0;
+    sim_time = 0;
+    num_bodies = num_contacts = 0;
+    solver_iterations = 0;
+    residual = bytes_per_product = 0;
+  }
+};
+
 class CH_PARALLEL_API ChTimerParallel {
  public:
   ChTimerParallel() {
     total_timers = 0;
     total_time = average_flops = average_bandwidth = 0;
+    record_head = record_count = total_records = 0;
   }
   ~ChTimerParallel() {}
 
-  void AddTimer(std::string name) {
-    TimerData temp;
-    timer_list[name] = temp;
+  // Add a timer and return its handle, the handle of an existing timer with
+  // the same name is returned if there is one. Handles stay valid for the
+  // lifetime of the timer object and avoid the lookup by name in start/stop.
+  int AddTimer(std::string name) {
+    std::map<std::string, int>::iterator it = timer_index.find(name);
+    if (it != timer_index.end()) {
+      return it->second;
+    }
+    int handle = timers.size();
+    timer_index[name] = handle;
+    timers.push_back(TimerData());
+    timer_names.push_back(name);
     total_timers++;
+    return handle;
+  }
+
+  // Returns the handle of a timer, -1 if there is no timer with that name
+  int GetHandle(std::string name) const {
+    std::map<std::string, int>::const_iterator it = timer_index.find(name);
+    return it == timer_index.end() ? -1 : it->second;
   }
 
   void Reset() {
-    for (std::map<std::string, TimerData>::iterator it = timer_list.begin(); it != timer_list.end(); it++) {
-      it->second.Reset();
+    for (int i = 0; i < timers.size(); i++) {
+      timers[i].Reset();
     }
   }
   void SetFlop(std::string name, double f) {
-    timer_list[name].flop = f;
-    timer_list[name].compute_stats = true;
+    TimerData& data = timers[AddTimer(name)];
+    data.flop = f;
+    data.compute_stats = true;
   }
 
   void SetMemory(std::string name, double m) {
-    timer_list[name].memory_ops = m;
-    timer_list[name].compute_stats = true;
+    TimerData& data = timers[AddTimer(name)];
+    data.memory_ops = m;
+    data.compute_stats = true;
   }
 
-  void start(std::string name) { timer_list[name].start(); }
+  void start(int handle) { timers[handle].start(); }
+  void stop(int handle) { timers[handle].stop(); }
 
-  void stop(std::string name) { timer_list[name].stop(); }
+  void start(std::string name) { timers[AddTimer(name)].start(); }
+  void stop(std::string name) { timers[AddTimer(name)].stop(); }
 
   // Returns the time associated with a specific timer
+  double GetTime(int handle) { return timers[handle].timer(); }
   double GetTime(std::string name) {
-    if (timer_list.count(name) == 0) {
+    int handle = GetHandle(name);
+    if (handle < 0) {
       return 0;
     }
-    return timer_list[name].timer();
+    return timers[handle].timer();
   }
 
   // Returns the number of times a specific timer was called
   int GetRuns(std::string name) {
-    if (timer_list.count(name) == 0) {
+    int handle = GetHandle(name);
+    if (handle < 0) {
       return 0;
     }
-    return timer_list[name].runs;
+    return timers[handle].runs;
   }
   void PrintReport() {
     total_time = average_flops = average_bandwidth = 0;
     std::cout << "Timer Report:" << std::endl;
     std::cout << "------------" << std::endl;
-    for (std::map<std::string, TimerData>::iterator it = timer_list.begin(); it != timer_list.end(); it++) {
-      it->second.Compute();
-      std::cout << "Name:\t" << it->first << "\t" << it->second.timer();
-      if (it->second.compute_stats) {
-        std::cout << "\t" << it->second.flop_rate << "\t" << it->second.bandwidth;
-        average_flops += it->second.flop_rate;
-        average_bandwidth += it->second.bandwidth;
+    for (std::map<std::string, int>::iterator it = timer_index.begin(); it != timer_index.end(); it++) {
+      TimerData& data = timers[it->second];
+      data.Compute();
+      std::cout << "Name:\t" << it->first << "\t" << data.timer();
+      if (data.compute_stats) {
+        std::cout << "\t" << data.flop_rate << "\t" << data.bandwidth;
+        average_flops += data.flop_rate;
+        average_bandwidth += data.bandwidth;
       }
       std::cout << std::endl;
-      total_time += it->second.timer();
+      total_time += data.timer();
     }
     std::cout << "------------" << std::endl;
     // cout << total_time << " " << average_flops / total_timers << " " << average_bandwidth / total_timers << endl;
   }
 
+  // Per step records ===========================================================
+  // The records are kept in a ring buffer, once it is full the oldest record
+  // is overwritten. A capacity of zero (the default) disables recording.
+  void SetRecordCapacity(uint capacity) {
+    records.clear();
+    records.resize(capacity);
+    record_head = record_count = total_records = 0;
+  }
+  uint GetRecordCapacity() const { return records.size(); }
+  uint GetNumRecords() const { return record_count; }
+
+  // Returns a record, 0 is the oldest record still in the buffer
+  const TimerRecord& GetRecord(uint i) const {
+    return records[(record_head + records.size() - record_count + i) % records.size()];
+  }
+
+  // Store the counters of the current step along with the value of every timer
+  void Record(const TimerRecord& counters) {
+    if (records.size() == 0) {
+      return;
+    }
+    TimerRecord& record = records[record_head];
+    record.step = total_records++;
+    record.sim_time = counters.sim_time;
+    record.num_bodies = counters.num_bodies;
+    record.num_contacts = counters.num_contacts;
+    record.solver_iterations = counters.solver_iterations;
+    record.residual = counters.residual;
+    record.bytes_per_product = counters.bytes_per_product;
+    record.times.resize(timers.size());
+    for (int i = 0; i < timers.size(); i++) {
+      record.times[i] = timers[i].timer();
+    }
+    record_head = (record_head + 1) % records.size();
+    record_count = std::min(record_count + 1, (uint)records.size());
+  }
+
+  // Write the records in the buffer as a JSON object with one entry per step
+  bool ExportJSON(const std::string& filename) const {
+    std::ofstream file(filename.c_str());
+    if (!file.is_open()) {
+      return false;
+    }
+    file << "{\n  \"records\": [\n";
+    for (uint i = 0; i < record_count; i++) {
+      const TimerRecord& record = GetRecord(i);
+      file << "    {\"step\": " << record.step << ", \"sim_time\": ";
+      WriteJSONNumber(file, record.sim_time);
+      file << ", \"num_bodies\": " << record.num_bodies << ", \"num_contacts\": " << record.num_contacts
+           << ", \"solver_iterations\": " << record.solver_iterations << ", \"residual\": ";
+      WriteJSONNumber(file, record.residual);
+      file << ", \"bytes_per_product\": ";
+      WriteJSONNumber(file, record.bytes_per_product);
+      file << ", \"timers\": {";
+      for (int t = 0; t < timer_names.size(); t++) {
+        file << (t > 0 ? ", " : "");
+        WriteJSONString(file, timer_names[t]);
+        file << ": ";
+        WriteJSONNumber(file, GetRecordTime(record, t));
+      }
+      file << "}}" << (i + 1 < record_count ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return true;
+  }
+
+  // Write the records in the buffer as comma separated values, one line per
+  // step with one column per timer
+  bool ExportCSV(const std::string& filename) const {
+    std::ofstream file(filename.c_str());
+    if (!file.is_open()) {
+      return false;
+    }
+    file << "step,sim_time,num_bodies,num_contacts,solver_iterations,residual,bytes_per_product";
+    for (int t = 0; t < timer_names.size(); t++) {
+      file << "," << timer_names[t];
+    }
+    file << "\n";
+    for (uint i = 0; i < record_count; i++) {
+      const TimerRecord& record = GetRecord(i);
+      file << record.step << "," << record.sim_time << "," << record.num_bodies << "," << record.num_contacts << ","
+           << record.solver_iterations << "," << record.residual << "," << record.bytes_per_product;
+      for (int t = 0; t < timer_names.size(); t++) {
+        file << "," << GetRecordTime(record, t);
+      }
+      file << "\n";
+    }
+    return true;
+  }
+
   double total_time;
   double average_flops;
   double average_bandwidth;
   int total_timers;
-  std::map<std::string, TimerData> timer_list;
-  std::map<std::string, TimerData>::iterator it;
+
+ private:
+  // Timers added after a record was stored have no value in that record
+  static double GetRecordTime(const TimerRecord& record, int handle) {
+    return handle < record.times.size() ? record.times[handle] : 0;
+  }
+
+  // Write a string as a quoted JSON string, escaping quotes, backslashes and
+  // control characters
+  static void WriteJSONString(std::ostream& out, const std::string& value) {
+    out << "\"";
+    for (int i = 0; i < value.size(); i++) {
+      char c = value[i];
+      switch (c) {
+        case '"':
+          out << "\\\"";
+          break;
+        case '\\':
+          out << "\\\\";
+          break;
+        case '\n':
+          out << "\\n";
+          break;
+        case '\r':
+          out << "\\r";
+          break;
+        case '\t':
+          out << "\\t";
+          break;
+        default:
+          if ((unsigned char)c < 0x20) {
+            char code[8];
+            sprintf(code, "\\u%04x", (unsigned char)c);
+            out << code;
+          } else {
+            out << c;
+          }
+      }
+    }
+    out << "\"";
+  }
+
+  // JSON has no NaN or infinity, such values are written as null
+  static void WriteJSONNumber(std::ostream& out, double value) {
+    if (value - value == 0) {
+      out << value;
+    } else {
+      out << "null";
+    }
+  }
+
+  std::vector<TimerData> timers;           // Timers indexed by handle
+  std::vector<std::string> timer_names;    // Name of each timer, indexed by handle
+  std::map<std::string, int> timer_index;  // Handle of each timer by name
+
+  std::vector<TimerRecord> records;
+  uint record_head;    // Position of the next record in the ring buffer
+  uint record_count;   // Number of valid records in the ring buffer
+  int total_records;   // Number of records stored since the capacity was set
 };
 }
 
@@ -142,7 +142,7 @@ static void ComputeAABBConvex(const real3* convex_points,
 ChCAABBGenerator::ChCAABBGenerator() {
 }
 
-void ChCAABBGenerator::GenerateAABB() {
+void ChCAABBGenerator::GenerateAABB(real skin) {
   const host_vector<shape_type>& obj_data_T = data_manager->host_data.typ_rigid;
   const host_vector<uint>& obj_data_ID = data_manager->host_data.id_rigid;
   const host_vector<real3>& obj_data_A = data_manager->host_data.ObA_rigid;
@@ -198,8 +198,8 @@ void ChCAABBGenerator::GenerateAABB() {
       continue;
     }
 
-    aabb_min_rigid[index] = temp_min;
-    aabb_max_rigid[index] = temp_max;
+    aabb_min_rigid[index] = temp_min - skin;
+    aabb_max_rigid[index] = temp_max + skin;
   }
 
   LOG(TRACE) << "AABB END";
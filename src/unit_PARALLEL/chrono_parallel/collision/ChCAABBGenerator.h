@@ -31,7 +31,9 @@ class CH_PARALLEL_API ChCAABBGenerator {
   // functions
   ChCAABBGenerator();
 
-  void GenerateAABB();
+  // Compute the bounding box of every shape, grown on every side by the given
+  // distance in addition to the collision envelope
+  void GenerateAABB(real skin = 0);
 
   ChParallelDataManager* data_manager;
 };
@@ -3,8 +3,12 @@
 #include <chrono_parallel/collision/ChCBroadphase.h>
 #include "chrono_parallel/collision/ChCBroadphaseUtils.h"
 
+#include <thrust/copy.h>
 #include <thrust/transform.h>
+#include <thrust/merge.h>
 #include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/zip_iterator.h>
 
 
 using thrust::transform;
@@ -48,10 +52,298 @@ inline void function_Store_AABB_BIN_Intersection(const uint index,
   }
 }
 
+// Function to compute the range of bins an AABB spans, clamped to the grid=================================
+// The range is only stored if it differs from the one used in the previous step
+inline void function_Compute_AABB_BIN_Range(const uint index,
+                                            const int3& bins_per_axis,
+                                            const real3& inv_bin_size_vec,
+                                            const host_vector<real3>& aabb_min_data,
+                                            const host_vector<real3>& aabb_max_data,
+                                            host_vector<int3>& bin_range_min,
+                                            host_vector<int3>& bin_range_max,
+                                            host_vector<bool>& shape_rebin) {
+  int3 last_bin = I3(bins_per_axis.x - 1, bins_per_axis.y - 1, bins_per_axis.z - 1);
+  int3 gmin = clamp(HashMin(aabb_min_data[index], inv_bin_size_vec), I3(0, 0, 0), last_bin);
+  int3 gmax = clamp(HashMax(aabb_max_data[index], inv_bin_size_vec), I3(0, 0, 0), last_bin);
+
+  shape_rebin[index] = (gmin != bin_range_min[index] || gmax != bin_range_max[index]);
+
+  if (shape_rebin[index]) {
+    bin_range_min[index] = gmin;
+    bin_range_max[index] = gmax;
+  }
+}
+
+// Function to count the bins intersected by a re-binned AABB==============================================
+inline void function_Count_Rebinned_BIN_Intersection(const uint index,
+                                                     const host_vector<uint>& rebinned_shapes,
+                                                     const host_vector<int3>& bin_range_min,
+                                                     const host_vector<int3>& bin_range_max,
+                                                     host_vector<uint>& bins_intersected) {
+  uint shape = rebinned_shapes[index];
+  int3 gmin = bin_range_min[shape];
+  int3 gmax = bin_range_max[shape];
+  bins_intersected[index] = (gmax.x - gmin.x + 1) * (gmax.y - gmin.y + 1) * (gmax.z - gmin.z + 1);
+}
+
+// Function to store the bins intersected by a re-binned AABB==============================================
+inline void function_Store_Rebinned_BIN_Intersection(const uint index,
+                                                     const int3& bins_per_axis,
+                                                     const host_vector<uint>& rebinned_shapes,
+                                                     const host_vector<int3>& bin_range_min,
+                                                     const host_vector<int3>& bin_range_max,
+                                                     const host_vector<uint>& bins_intersected,
+                                                     host_vector<uint>& bin_number,
+                                                     host_vector<uint>& aabb_number) {
+  uint count = 0, i, j, k;
+  uint shape = rebinned_shapes[index];
+  int3 gmin = bin_range_min[shape];
+  int3 gmax = bin_range_max[shape];
+  uint mInd = bins_intersected[index];
+  for (i = gmin.x; i <= gmax.x; i++) {
+    for (j = gmin.y; j <= gmax.y; j++) {
+      for (k = gmin.z; k <= gmax.z; k++) {
+        bin_number[mInd + count] = Hash_Index(I3(i, j, k), bins_per_axis);
+        aabb_number[mInd + count] = shape;
+        count++;
+      }
+    }
+  }
+}
+
+// Function to compute the level of the hierarchical grid an AABB belongs to===============================
+// An AABB is stored in the finest level where it spans at most two bins per axis
+inline void function_Compute_AABB_Level(const uint index,
+                                        const uint num_levels,
+                                        const real3& bin_size_vec,
+                                        const host_vector<real3>& aabb_min_data,
+                                        const host_vector<real3>& aabb_max_data,
+                                        host_vector<uint>& shape_level) {
+  real3 extent = aabb_max_data[index] - aabb_min_data[index];
+  real3 level_size = bin_size_vec;
+  uint level = 0;
+  while (level + 1 < num_levels && (extent.x > level_size.x || extent.y > level_size.y || extent.z > level_size.z)) {
+    level_size = level_size * 2.0;
+    level++;
+  }
+  shape_level[index] = level;
+}
+
+// Function to compute the range of bins an AABB spans at a level of the hierarchical grid=================
+inline void function_Compute_Level_BIN_Range(const real3& Amin,
+                                             const real3& Amax,
+                                             const uint level,
+                                             const real3& inv_bin_size_vec,
+                                             const int3& level_bins,
+                                             int3& gmin,
+                                             int3& gmax) {
+  real3 inv_level_size = inv_bin_size_vec / real(1 << level);
+  int3 last_bin = I3(level_bins.x - 1, level_bins.y - 1, level_bins.z - 1);
+  gmin = clamp(HashMin(Amin, inv_level_size), I3(0, 0, 0), last_bin);
+  gmax = clamp(HashMax(Amax, inv_level_size), I3(0, 0, 0), last_bin);
+}
+
+// Function to count the bins an AABB intersects in its own level==========================================
+inline void function_Count_AABB_Level_BIN_Intersection(const uint index,
+                                                       const real3& inv_bin_size_vec,
+                                                       const std::vector<int3>& level_bins,
+                                                       const host_vector<real3>& aabb_min_data,
+                                                       const host_vector<real3>& aabb_max_data,
+                                                       const host_vector<uint>& shape_level,
+                                                       host_vector<uint>& bins_intersected) {
+  int3 gmin, gmax;
+  uint level = shape_level[index];
+  function_Compute_Level_BIN_Range(aabb_min_data[index], aabb_max_data[index], level, inv_bin_size_vec,
+                                   level_bins[level], gmin, gmax);
+  bins_intersected[index] = (gmax.x - gmin.x + 1) * (gmax.y - gmin.y + 1) * (gmax.z - gmin.z + 1);
+}
+
+// Function to store the bins an AABB intersects in its own level==========================================
+// The bin numbers of each level are offset so that they are unique over all levels
+inline void function_Store_AABB_Level_BIN_Intersection(const uint index,
+                                                       const real3& inv_bin_size_vec,
+                                                       const std::vector<int3>& level_bins,
+                                                       const std::vector<uint>& level_offset,
+                                                       const host_vector<real3>& aabb_min_data,
+                                                       const host_vector<real3>& aabb_max_data,
+                                                       const host_vector<uint>& shape_level,
+                                                       const host_vector<uint>& bins_intersected,
+                                                       host_vector<uint>& bin_number,
+                                                       host_vector<uint>& aabb_number) {
+  uint count = 0, i, j, k;
+  int3 gmin, gmax;
+  uint level = shape_level[index];
+  function_Compute_Level_BIN_Range(aabb_min_data[index], aabb_max_data[index], level, inv_bin_size_vec,
+                                   level_bins[level], gmin, gmax);
+  uint mInd = bins_intersected[index];
+  for (i = gmin.x; i <= gmax.x; i++) {
+    for (j = gmin.y; j <= gmax.y; j++) {
+      for (k = gmin.z; k <= gmax.z; k++) {
+        bin_number[mInd + count] = level_offset[level] + Hash_Index(I3(i, j, k), level_bins[level]);
+        aabb_number[mInd + count] = index;
+        count++;
+      }
+    }
+  }
+}
+
+// Function to count the intersections of an AABB with the AABBs stored in coarser levels==================
+inline void function_Count_AABB_Level_Intersection(const uint index,
+                                                   const real3& inv_bin_size_vec,
+                                                   const std::vector<int3>& level_bins,
+                                                   const std::vector<uint>& level_offset,
+                                                   const std::vector<uint>& level_count,
+                                                   const uint num_bins_active,
+                                                   const host_vector<uint>& bin_active,
+                                                   const host_vector<uint>& bin_start_index,
+                                                   const host_vector<uint>& aabb_number,
+                                                   const host_vector<real3>& aabb_min_data,
+                                                   const host_vector<real3>& aabb_max_data,
+                                                   const host_vector<uint>& shape_level,
+                                                   const host_vector<short2>& fam_data,
+                                                   const host_vector<bool>& body_active,
+                                                   const host_vector<uint>& body_id,
+                                                   host_vector<uint>& num_level_contact) {
+  const uint* bins_begin = bin_active.data();
+  const uint* bins_end = bin_active.data() + num_bins_active;
+  real3 Amin = aabb_min_data[index];
+  real3 Amax = aabb_max_data[index];
+  short2 famA = fam_data[index];
+  uint bodyA = body_id[index];
+  uint count = 0, i, j, k;
+
+  for (uint level = shape_level[index] + 1; level < level_bins.size(); level++) {
+    if (level_count[level] == 0)
+      continue;
+    int3 gmin, gmax;
+    function_Compute_Level_BIN_Range(Amin, Amax, level, inv_bin_size_vec, level_bins[level], gmin, gmax);
+    for (i = gmin.x; i <= gmax.x; i++) {
+      for (j = gmin.y; j <= gmax.y; j++) {
+        for (k = gmin.z; k <= gmax.z; k++) {
+          uint bin = level_offset[level] + Hash_Index(I3(i, j, k), level_bins[level]);
+          const uint* found = std::lower_bound(bins_begin, bins_end, bin);
+          if (found == bins_end || *found != bin)
+            continue;
+          uint b = found - bins_begin;
+          for (uint n = bin_start_index[b]; n < bin_start_index[b + 1]; n++) {
+            uint shapeB = aabb_number[n];
+            uint bodyB = body_id[shapeB];
+
+            if (bodyA == bodyB)
+              continue;
+            if (!body_active[bodyA] && !body_active[bodyB])
+              continue;
+            if (!collide(famA, fam_data[shapeB]))
+              continue;
+            if (!overlap(Amin, Amax, aabb_min_data[shapeB], aabb_max_data[shapeB]))
+              continue;
+            count++;
+          }
+        }
+      }
+    }
+  }
+
+  num_level_contact[index] = count;
+}
+
+// Function to store the intersections of an AABB with the AABBs stored in coarser levels==================
+inline void function_Store_AABB_Level_Intersection(const uint index,
+                                                   const uint offset,
+                                                   const real3& inv_bin_size_vec,
+                                                   const std::vector<int3>& level_bins,
+                                                   const std::vector<uint>& level_offset,
+                                                   const std::vector<uint>& level_count,
+                                                   const uint num_bins_active,
+                                                   const host_vector<uint>& bin_active,
+                                                   const host_vector<uint>& bin_start_index,
+                                                   const host_vector<uint>& aabb_number,
+                                                   const host_vector<real3>& aabb_min_data,
+                                                   const host_vector<real3>& aabb_max_data,
+                                                   const host_vector<uint>& shape_level,
+                                                   const host_vector<uint>& num_level_contact,
+                                                   const host_vector<short2>& fam_data,
+                                                   const host_vector<bool>& body_active,
+                                                   const host_vector<uint>& body_id,
+                                                   host_vector<long long>& potential_contacts) {
+  const uint* bins_begin = bin_active.data();
+  const uint* bins_end = bin_active.data() + num_bins_active;
+  real3 Amin = aabb_min_data[index];
+  real3 Amax = aabb_max_data[index];
+  short2 famA = fam_data[index];
+  uint bodyA = body_id[index];
+  uint start = offset + num_level_contact[index];
+  uint count = 0, i, j, k;
+
+  for (uint level = shape_level[index] + 1; level < level_bins.size(); level++) {
+    if (level_count[level] == 0)
+      continue;
+    int3 gmin, gmax;
+    function_Compute_Level_BIN_Range(Amin, Amax, level, inv_bin_size_vec, level_bins[level], gmin, gmax);
+    for (i = gmin.x; i <= gmax.x; i++) {
+      for (j = gmin.y; j <= gmax.y; j++) {
+        for (k = gmin.z; k <= gmax.z; k++) {
+          uint bin = level_offset[level] + Hash_Index(I3(i, j, k), level_bins[level]);
+          const uint* found = std::lower_bound(bins_begin, bins_end, bin);
+          if (found == bins_end || *found != bin)
+            continue;
+          uint b = found - bins_begin;
+          for (uint n = bin_start_index[b]; n < bin_start_index[b + 1]; n++) {
+            uint shapeB = aabb_number[n];
+            uint bodyB = body_id[shapeB];
+
+            if (bodyA == bodyB)
+              continue;
+            if (!body_active[bodyA] && !body_active[bodyB])
+              continue;
+            if (!collide(famA, fam_data[shapeB]))
+              continue;
+            if (!overlap(Amin, Amax, aabb_min_data[shapeB], aabb_max_data[shapeB]))
+              continue;
+
+            // the two indices of the shapes that make up the contact
+            if (index < shapeB) {
+              potential_contacts[start + count] = ((long long)index << 32 | (long long)shapeB);
+            } else {
+              potential_contacts[start + count] = ((long long)shapeB << 32 | (long long)index);
+            }
+            count++;
+          }
+        }
+      }
+    }
+  }
+}
+
+// Predicate used to remove the (bin, aabb) entries of re-binned shapes====================================
+struct function_Is_Rebinned {
+  function_Is_Rebinned(const bool* rebin) : shape_rebin(rebin) {}
+  bool operator()(const thrust::tuple<uint, uint>& entry) const { return shape_rebin[thrust::get<1>(entry)]; }
+  const bool* shape_rebin;
+};
+
+// Function to copy the AABBs of the (bin, aabb) entries into a structure of arrays=========================
+inline void function_Gather_AABB_SoA(const uint index,
+                                     const host_vector<real3>& aabb_min_data,
+                                     const host_vector<real3>& aabb_max_data,
+                                     const host_vector<uint>& aabb_number,
+                                     aabb_soa& bin_aabbs) {
+  uint shape = aabb_number[index];
+  real3 Amin = aabb_min_data[shape];
+  real3 Amax = aabb_max_data[shape];
+  bin_aabbs.min_x[index] = Amin.x;
+  bin_aabbs.min_y[index] = Amin.y;
+  bin_aabbs.min_z[index] = Amin.z;
+  bin_aabbs.max_x[index] = Amax.x;
+  bin_aabbs.max_y[index] = Amax.y;
+  bin_aabbs.max_z[index] = Amax.z;
+}
+
 // Function to count AABB AABB intersection=================================================================
+// The AABBs of a bin are stored contiguously in bin_aabbs so that each AABB is
+// tested against AABB_BLOCK_SIZE candidates at a time
 inline void function_Count_AABB_AABB_Intersection(const uint index,
-                                                  const host_vector<real3>& aabb_min_data,
-                                                  const host_vector<real3>& aabb_max_data,
+                                                  const aabb_soa& bin_aabbs,
                                                   const host_vector<uint>& bin_number,
                                                   const host_vector<uint>& aabb_number,
                                                   const host_vector<uint>& bin_start_index,
@@ -69,26 +361,30 @@ inline void function_Count_AABB_AABB_Intersection(const uint index,
   }
   for (uint i = start; i < end; i++) {
     uint shapeA = aabb_number[i];
-    real3 Amin = aabb_min_data[shapeA];
-    real3 Amax = aabb_max_data[shapeA];
+    real3 Amin = R3(bin_aabbs.min_x[i], bin_aabbs.min_y[i], bin_aabbs.min_z[i]);
+    real3 Amax = R3(bin_aabbs.max_x[i], bin_aabbs.max_y[i], bin_aabbs.max_z[i]);
     short2 famA = fam_data[shapeA];
     uint bodyA = body_id[shapeA];
 
-    for (uint k = i + 1; k < end; k++) {
-      uint shapeB = aabb_number[k];
-      uint bodyB = body_id[shapeB];
-
-      if (shapeA == shapeB)
-        continue;
-      if (bodyA == bodyB)
-        continue;
-      if (!body_active[bodyA] && !body_active[bodyB])
-        continue;
-      if (!collide(famA, fam_data[shapeB]))
-        continue;
-      if (!overlap(Amin, Amax, aabb_min_data[shapeB], aabb_max_data[shapeB]))
-        continue;
-      count++;
+    // The blocks are aligned, ignore the candidates before i + 1 and past the end of the bin
+    for (uint k = function_AABB_Block_Start(i + 1); k < end; k += AABB_BLOCK_SIZE) {
+      int mask = function_Overlap_AABB_Block(Amin, Amax, bin_aabbs, k) & function_AABB_Block_Range(k, i + 1, end);
+      for (uint j = 0; mask; j++, mask >>= 1) {
+        if (!(mask & 1))
+          continue;
+        uint shapeB = aabb_number[k + j];
+        uint bodyB = body_id[shapeB];
+
+        if (shapeA == shapeB)
+          continue;
+        if (bodyA == bodyB)
+          continue;
+        if (!body_active[bodyA] && !body_active[bodyB])
+          continue;
+        if (!collide(famA, fam_data[shapeB]))
+          continue;
+        count++;
+      }
     }
   }
 
@@ -97,8 +393,7 @@ inline void function_Count_AABB_AABB_Intersection(const uint index,
 
 // Function to store AABB-AABB intersections================================================================
 inline void function_Store_AABB_AABB_Intersection(const uint index,
-                                                  const host_vector<real3>& aabb_min_data,
-                                                  const host_vector<real3>& aabb_max_data,
+                                                  const aabb_soa& bin_aabbs,
                                                   const host_vector<uint>& bin_number,
                                                   const host_vector<uint>& aabb_number,
                                                   const host_vector<uint>& bin_start_index,
@@ -118,34 +413,102 @@ inline void function_Store_AABB_AABB_Intersection(const uint index,
 
   for (uint i = start; i < end; i++) {
     uint shapeA = aabb_number[i];
-    real3 Amin = aabb_min_data[shapeA];
-    real3 Amax = aabb_max_data[shapeA];
+    real3 Amin = R3(bin_aabbs.min_x[i], bin_aabbs.min_y[i], bin_aabbs.min_z[i]);
+    real3 Amax = R3(bin_aabbs.max_x[i], bin_aabbs.max_y[i], bin_aabbs.max_z[i]);
+    short2 famA = fam_data[shapeA];
+    uint bodyA = body_id[shapeA];
+
+    // The blocks are aligned, ignore the candidates before i + 1 and past the end of the bin
+    for (uint k = function_AABB_Block_Start(i + 1); k < end; k += AABB_BLOCK_SIZE) {
+      int mask = function_Overlap_AABB_Block(Amin, Amax, bin_aabbs, k) & function_AABB_Block_Range(k, i + 1, end);
+      for (uint j = 0; mask; j++, mask >>= 1) {
+        if (!(mask & 1))
+          continue;
+        uint shapeB = aabb_number[k + j];
+        uint bodyB = body_id[shapeB];
+
+        if (shapeA == shapeB)
+          continue;
+        if (bodyA == bodyB)
+          continue;
+        if (!body_active[bodyA] && !body_active[bodyB])
+          continue;
+        if (!collide(famA, fam_data[shapeB]))
+          continue;
+
+        // the two indices of the shapes that make up the contact
+        if (shapeA < shapeB) {
+          potential_contacts[offset + count] = ((long long)shapeA << 32 | (long long)shapeB);
+        } else {
+          potential_contacts[offset + count] = ((long long)shapeB << 32 | (long long)shapeA);
+        }
+        count++;
+      }
+    }
+  }
+}
+// Function to find and store the AABB-AABB intersections of a bin in one pass=============================
+// A pair of AABBs spanning several bins is only reported by the bin that holds
+// the lowest corner of the range of bins shared by the two AABBs
+inline void function_Find_AABB_AABB_Intersection(const uint index,
+                                                 const real3& inv_bin_size_vec,
+                                                 const int3& bins_per_axis,
+                                                 const aabb_soa& bin_aabbs,
+                                                 const host_vector<uint>& bin_active,
+                                                 const host_vector<uint>& aabb_number,
+                                                 const host_vector<uint>& bin_start_index,
+                                                 const host_vector<short2>& fam_data,
+                                                 const host_vector<bool>& body_active,
+                                                 const host_vector<uint>& body_id,
+                                                 host_vector<long long>& pairs) {
+  uint start = bin_start_index[index];
+  uint end = bin_start_index[index + 1];
+  // Terminate early if there is only one object in the bin
+  if (end - start == 1) {
+    return;
+  }
+  int3 bin = Hash_Decode(bin_active[index], bins_per_axis);
+  int3 last_bin = I3(bins_per_axis.x - 1, bins_per_axis.y - 1, bins_per_axis.z - 1);
+
+  for (uint i = start; i < end; i++) {
+    uint shapeA = aabb_number[i];
+    real3 Amin = R3(bin_aabbs.min_x[i], bin_aabbs.min_y[i], bin_aabbs.min_z[i]);
+    real3 Amax = R3(bin_aabbs.max_x[i], bin_aabbs.max_y[i], bin_aabbs.max_z[i]);
+    int3 gminA = clamp(HashMin(Amin, inv_bin_size_vec), I3(0, 0, 0), last_bin);
     short2 famA = fam_data[shapeA];
     uint bodyA = body_id[shapeA];
 
-    for (int k = i + 1; k < end; k++) {
-      uint shapeB = aabb_number[k];
-      uint bodyB = body_id[shapeB];
-
-      if (shapeA == shapeB)
-        continue;
-      if (bodyA == bodyB)
-        continue;
-      if (!body_active[bodyA] && !body_active[bodyB])
-        continue;
-      if (!collide(famA, fam_data[shapeB]))
-        continue;
-      if (!overlap(Amin, Amax, aabb_min_data[shapeB], aabb_max_data[shapeB]))
-        continue;
-
-      if (shapeB < shapeA) {
-        uint t = shapeA;
-        shapeA = shapeB;
-        shapeB = t;
+    // The blocks are aligned, ignore the candidates before i + 1 and past the end of the bin
+    for (uint k = function_AABB_Block_Start(i + 1); k < end; k += AABB_BLOCK_SIZE) {
+      int mask = function_Overlap_AABB_Block(Amin, Amax, bin_aabbs, k) & function_AABB_Block_Range(k, i + 1, end);
+      for (uint j = 0; mask; j++, mask >>= 1) {
+        if (!(mask & 1))
+          continue;
+        uint shapeB = aabb_number[k + j];
+        uint bodyB = body_id[shapeB];
+
+        if (shapeA == shapeB)
+          continue;
+        if (bodyA == bodyB)
+          continue;
+        if (!body_active[bodyA] && !body_active[bodyB])
+          continue;
+        if (!collide(famA, fam_data[shapeB]))
+          continue;
+
+        real3 Bmin = R3(bin_aabbs.min_x[k + j], bin_aabbs.min_y[k + j], bin_aabbs.min_z[k + j]);
+        int3 gminB = clamp(HashMin(Bmin, inv_bin_size_vec), I3(0, 0, 0), last_bin);
+        if (std::max(gminA.x, gminB.x) != bin.x || std::max(gminA.y, gminB.y) != bin.y ||
+            std::max(gminA.z, gminB.z) != bin.z)
+          continue;
+
+        // the two indices of the shapes that make up the contact
+        if (shapeA < shapeB) {
+          pairs.push_back((long long)shapeA << 32 | (long long)shapeB);
+        } else {
+          pairs.push_back((long long)shapeB << 32 | (long long)shapeA);
+        }
       }
-      // the two indices of the shapes that make up the contact
-      potential_contacts[offset + count] = ((long long)shapeA << 32 | (long long)shapeB);
-      count++;
     }
   }
 }
@@ -155,6 +518,14 @@ ChCBroadphase::ChCBroadphase() {
   num_bins_active = 0;
   number_of_bin_intersections = 0;
   data_manager = 0;
+  grid_valid = false;
+  grid_bins_per_axis = I3(0, 0, 0);
+  grid_min_point = R3(0);
+  grid_max_point = R3(0);
+}
+// =========================================================================================================
+void ChCBroadphase::Reset() {
+  grid_valid = false;
 }
 // =========================================================================================================
 // use spatial subdivision to detect the list of POSSIBLE collisions
@@ -170,6 +541,8 @@ void ChCBroadphase::DetectPossibleCollisions() {
   real3& global_origin = data_manager->measures.collision.global_origin;
   int3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
   const real density = data_manager->settings.collision.grid_density;
+  const bool incremental = data_manager->settings.collision.incremental_broadphase;
+  const bool hierarchical = data_manager->settings.collision.broadphase_algorithm == BROADPHASE_HIERARCHICAL_GRID;
   const host_vector<short2>& fam_data = data_manager->host_data.fam_rigid;
   const host_vector<bool>& obj_active = data_manager->host_data.active_rigid;
   const host_vector<uint>& obj_data_ID = data_manager->host_data.id_rigid;
@@ -187,13 +560,33 @@ void ChCBroadphase::DetectPossibleCollisions() {
   res = transform_reduce(thrust_parallel, aabb_max_rigid.begin(), aabb_max_rigid.end(), unary_op, res, binary_op);
   min_bounding_point = res.first;
   max_bounding_point = res.second;
-  global_origin = min_bounding_point;
-  real3 diagonal = max_bounding_point - min_bounding_point;
 
-  if (data_manager->settings.collision.fixed_bins == false) {
-    bins_per_axis = function_Compute_Grid_Resolution(num_shapes, diagonal, density);
+  // The incremental broadphase reuses the grid (origin, bin size) from the
+  // previous step for as long as it covers all of the shapes. The hierarchical
+  // grid is always rebuilt.
+  bool rebuild_grid = !(incremental && !hierarchical && GridIsValid(min_bounding_point, max_bounding_point));
+
+  if (rebuild_grid) {
+    real3 diagonal = max_bounding_point - min_bounding_point;
+
+    if (data_manager->settings.collision.fixed_bins == false) {
+      bins_per_axis = function_Compute_Grid_Resolution(num_shapes, diagonal, density);
+    }
+    grid_min_point = min_bounding_point;
+    grid_max_point = max_bounding_point;
+    grid_bins_per_axis = bins_per_axis;
+
+    // Pad the grid of the incremental broadphase so that it stays valid while
+    // the shapes move around the bounding box
+    if (incremental && !hierarchical) {
+      real3 bins = R3(bins_per_axis.x, bins_per_axis.y, bins_per_axis.z);
+      real3 margin = data_manager->settings.collision.grid_padding * diagonal / bins;
+      grid_min_point = grid_min_point - margin;
+      grid_max_point = grid_max_point + margin;
+    }
   }
-  bin_size_vec = diagonal / R3(bins_per_axis.x, bins_per_axis.y, bins_per_axis.z);
+  global_origin = grid_min_point;
+  bin_size_vec = (grid_max_point - grid_min_point) / R3(bins_per_axis.x, bins_per_axis.y, bins_per_axis.z);
   real3 inv_bin_size_vec = 1.0 / bin_size_vec;
 
   thrust::constant_iterator<real3> offset(global_origin);
@@ -204,6 +597,114 @@ void ChCBroadphase::DetectPossibleCollisions() {
   LOG(TRACE) << "Maximum bounding point: (" << res.second.x << ", " << res.second.y << ", " << res.second.z << ")";
   LOG(TRACE) << "Bin size vector: (" << bin_size_vec.x << ", " << bin_size_vec.y << ", " << bin_size_vec.z << ")";
 
+  if (hierarchical) {
+    grid_valid = false;
+    RebuildHierarchicalBins();
+  } else if (incremental) {
+    // Force every shape to be re-binned when the grid changed
+    grid_valid = grid_valid && !rebuild_grid;
+    UpdateBins();
+  } else {
+    grid_valid = false;
+    RebuildBins();
+  }
+
+  if (num_bins_active <= 0) {
+    number_of_contacts_possible = 0;
+    return;
+  }
+
+  bin_start_index.resize(num_bins_active + 1);
+  bin_start_index[num_bins_active] = 0;
+
+  LOG(TRACE) << bins_per_axis.x << " " << bins_per_axis.y << " " << bins_per_axis.z;
+  LOG(TRACE) << "Last active bin: " << num_bins_active;
+
+  Thrust_Exclusive_Scan(bin_start_index);
+
+  // Copy the AABBs in bin order, padded to a whole number of blocks so that the
+  // last block of candidates can be loaded without reading past the arrays
+  uint number_of_entries = bin_start_index[num_bins_active];
+  bin_aabbs.resize(number_of_entries);
+
+#pragma omp parallel for
+  for (int i = 0; i < number_of_entries; i++) {
+    function_Gather_AABB_SoA(i, aabb_min_rigid, aabb_max_rigid, aabb_number, bin_aabbs);
+  }
+
+  if (data_manager->settings.collision.single_pass_broadphase && !hierarchical) {
+    FindPairsSinglePass();
+    return;
+  }
+
+  num_contact.resize(num_bins_active + 1);
+  num_contact[num_bins_active] = 0;
+
+#pragma omp parallel for
+  for (int i = 0; i < num_bins_active; i++) {
+    function_Count_AABB_AABB_Intersection(i, bin_aabbs, bin_number, aabb_number, bin_start_index, fam_data, obj_active,
+                                          obj_data_ID, num_contact);
+  }
+
+  thrust::exclusive_scan(num_contact.begin(), num_contact.end(), num_contact.begin());
+  number_of_contacts_possible = num_contact.back();
+
+  // With the hierarchical grid, the AABBs must also be tested against the
+  // AABBs stored in the coarser levels
+  uint number_of_bin_contacts = number_of_contacts_possible;
+  if (hierarchical) {
+    num_level_contact.resize(num_shapes + 1);
+    num_level_contact[num_shapes] = 0;
+
+#pragma omp parallel for
+    for (int i = 0; i < num_shapes; i++) {
+      function_Count_AABB_Level_Intersection(i, inv_bin_size_vec, level_bins, level_offset, level_count,
+                                             num_bins_active, bin_active, bin_start_index, aabb_number,
+                                             aabb_min_rigid, aabb_max_rigid, shape_level, fam_data, obj_active,
+                                             obj_data_ID, num_level_contact);
+    }
+
+    Thrust_Exclusive_Scan(num_level_contact);
+    number_of_contacts_possible += num_level_contact.back();
+  }
+
+  contact_pairs.resize(number_of_contacts_possible);
+  LOG(TRACE) << "Number of possible collisions: " << number_of_contacts_possible;
+
+#pragma omp parallel for
+  for (int index = 0; index < num_bins_active; index++) {
+    function_Store_AABB_AABB_Intersection(index, bin_aabbs, bin_number, aabb_number, bin_start_index, num_contact,
+                                          fam_data, obj_active, obj_data_ID, contact_pairs);
+  }
+
+  if (hierarchical) {
+#pragma omp parallel for
+    for (int i = 0; i < num_shapes; i++) {
+      function_Store_AABB_Level_Intersection(i, number_of_bin_contacts, inv_bin_size_vec, level_bins, level_offset,
+                                             level_count, num_bins_active, bin_active, bin_start_index, aabb_number,
+                                             aabb_min_rigid, aabb_max_rigid, shape_level, num_level_contact,
+                                             fam_data, obj_active, obj_data_ID, contact_pairs);
+    }
+  }
+
+  thrust::stable_sort(thrust_parallel, contact_pairs.begin(), contact_pairs.end());
+
+  number_of_contacts_possible = Thrust_Unique(contact_pairs);
+
+  contact_pairs.resize(number_of_contacts_possible);
+
+  LOG(TRACE) << "Number of possible collisions: " << number_of_contacts_possible;
+
+  return;
+}
+// =========================================================================================================
+void ChCBroadphase::RebuildBins() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  const int3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
+  real3 inv_bin_size_vec = 1.0 / data_manager->measures.collision.bin_size_vec;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
   bins_intersected.resize(num_shapes + 1);
   bins_intersected[num_shapes] = 0;
 
@@ -230,50 +731,233 @@ void ChCBroadphase::DetectPossibleCollisions() {
   LOG(TRACE) << "Completed (device_Store_AABB_BIN_Intersection)";
 
   Thrust_Sort_By_Key(bin_number, aabb_number);
-  num_bins_active = Thrust_Reduce_By_Key(bin_number, bin_number, bin_start_index);
 
-  if (num_bins_active <= 0) {
-    number_of_contacts_possible = 0;
-    return;
+  // Write the unique bin numbers to a separate list, bin_number still maps the
+  // entries of aabb_number to their bins
+  bin_active.resize(number_of_bin_intersections);
+  num_bins_active = Thrust_Reduce_By_Key(bin_number, bin_active, bin_start_index);
+
+  data_manager->measures.collision.rebinned_shapes = num_shapes;
+}
+// =========================================================================================================
+void ChCBroadphase::UpdateBins() {
+  typedef thrust::tuple<host_vector<uint>::iterator, host_vector<uint>::iterator> BinEntryTuple;
+  typedef thrust::zip_iterator<BinEntryTuple> BinEntryIterator;
+
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  const int3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
+  real3 inv_bin_size_vec = 1.0 / data_manager->measures.collision.bin_size_vec;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
+  // When the grid changed the bin lists from the previous step are useless,
+  // invalidate the stored ranges so that every shape gets re-binned
+  if (!grid_valid) {
+    bin_number.clear();
+    aabb_number.clear();
+    bin_range_min.assign(num_shapes, I3(-1, -1, -1));
+    bin_range_max.assign(num_shapes, I3(-1, -1, -1));
+    grid_valid = true;
   }
+  shape_rebin.resize(num_shapes);
 
-  bin_start_index.resize(num_bins_active + 1);
-  bin_start_index[num_bins_active] = 0;
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    function_Compute_AABB_BIN_Range(i, bins_per_axis, inv_bin_size_vec, aabb_min_rigid, aabb_max_rigid,
+                                    bin_range_min, bin_range_max, shape_rebin);
+  }
 
-  LOG(TRACE) << bins_per_axis.x << " " << bins_per_axis.y << " " << bins_per_axis.z;
-  LOG(TRACE) << "Last active bin: " << num_bins_active;
+  rebinned_shapes.resize(num_shapes);
+  uint num_rebinned = thrust::copy_if(thrust::counting_iterator<uint>(0), thrust::counting_iterator<uint>(num_shapes),
+                                      shape_rebin.begin(), rebinned_shapes.begin(), thrust::identity<bool>()) -
+                      rebinned_shapes.begin();
+  rebinned_shapes.resize(num_rebinned);
+  data_manager->measures.collision.rebinned_shapes = num_rebinned;
+
+  LOG(TRACE) << "Number of re-binned AABBs: " << num_rebinned;
+
+  if (num_rebinned > 0) {
+    // Remove the old entries of all shapes that changed bins, the remaining
+    // entries stay sorted by bin number.
+    BinEntryIterator entries_begin =
+        thrust::make_zip_iterator(thrust::make_tuple(bin_number.begin(), aabb_number.begin()));
+    BinEntryIterator entries_end = thrust::make_zip_iterator(thrust::make_tuple(bin_number.end(), aabb_number.end()));
+    uint num_kept =
+        thrust::remove_if(entries_begin, entries_end, function_Is_Rebinned(shape_rebin.data())) - entries_begin;
+    bin_number.resize(num_kept);
+    aabb_number.resize(num_kept);
+
+    // Generate and sort the entries for the shapes that changed bins
+    bins_intersected.resize(num_rebinned + 1);
+    bins_intersected[num_rebinned] = 0;
 
-  Thrust_Exclusive_Scan(bin_start_index);
-  num_contact.resize(num_bins_active + 1);
-  num_contact[num_bins_active] = 0;
+#pragma omp parallel for
+    for (int i = 0; i < num_rebinned; i++) {
+      function_Count_Rebinned_BIN_Intersection(i, rebinned_shapes, bin_range_min, bin_range_max, bins_intersected);
+    }
+
+    Thrust_Exclusive_Scan(bins_intersected);
+    uint num_new = bins_intersected.back();
+
+    new_bin_number.resize(num_new);
+    new_aabb_number.resize(num_new);
 
 #pragma omp parallel for
-  for (int i = 0; i < num_bins_active; i++) {
-    function_Count_AABB_AABB_Intersection(i, aabb_min_rigid, aabb_max_rigid, bin_number, aabb_number, bin_start_index,
-                                          fam_data, obj_active, obj_data_ID, num_contact);
+    for (int i = 0; i < num_rebinned; i++) {
+      function_Store_Rebinned_BIN_Intersection(i, bins_per_axis, rebinned_shapes, bin_range_min, bin_range_max,
+                                               bins_intersected, new_bin_number, new_aabb_number);
+    }
+
+    Thrust_Sort_By_Key(new_bin_number, new_aabb_number);
+
+    // Merge the new entries into the existing sorted lists
+    merge_bin_number.resize(num_kept + num_new);
+    merge_aabb_number.resize(num_kept + num_new);
+    thrust::merge_by_key(bin_number.begin(), bin_number.end(), new_bin_number.begin(), new_bin_number.end(),
+                         aabb_number.begin(), new_aabb_number.begin(), merge_bin_number.begin(),
+                         merge_aabb_number.begin());
+    bin_number.swap(merge_bin_number);
+    aabb_number.swap(merge_aabb_number);
   }
 
-  thrust::exclusive_scan(num_contact.begin(), num_contact.end(), num_contact.begin());
-  number_of_contacts_possible = num_contact.back();
+  number_of_bin_intersections = bin_number.size();
+
+  LOG(TRACE) << "Number of bin intersections: " << number_of_bin_intersections;
+
+  // The sorted bin lists must be kept intact for the next step, write the
+  // unique bin numbers to a separate list
+  bin_active.resize(number_of_bin_intersections);
+  bin_start_index.resize(number_of_bin_intersections);
+  num_bins_active = Thrust_Reduce_By_Key(bin_number, bin_active, bin_start_index);
+}
+// =========================================================================================================
+void ChCBroadphase::FindPairsSinglePass() {
+  host_vector<long long>& contact_pairs = data_manager->host_data.pair_rigid_rigid;
+  const host_vector<short2>& fam_data = data_manager->host_data.fam_rigid;
+  const host_vector<bool>& obj_active = data_manager->host_data.active_rigid;
+  const host_vector<uint>& obj_data_ID = data_manager->host_data.id_rigid;
+  const int3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
+  real3 inv_bin_size_vec = 1.0 / data_manager->measures.collision.bin_size_vec;
+
+  thread_pairs.resize(omp_get_max_threads());
+
+#pragma omp parallel
+  {
+    host_vector<long long>& pairs = thread_pairs[omp_get_thread_num()];
+    pairs.clear();
+
+#pragma omp for schedule(dynamic, 64)
+    for (int i = 0; i < num_bins_active; i++) {
+      function_Find_AABB_AABB_Intersection(i, inv_bin_size_vec, bins_per_axis, bin_aabbs, bin_active, aabb_number,
+                                           bin_start_index, fam_data, obj_active, obj_data_ID, pairs);
+    }
+  }
+
+  // Compact the per thread buffers, every pair was found exactly once
+  thread_offset.resize(thread_pairs.size() + 1);
+  thread_offset[0] = 0;
+  for (int t = 0; t < thread_pairs.size(); t++) {
+    thread_offset[t + 1] = thread_offset[t] + thread_pairs[t].size();
+  }
+  number_of_contacts_possible = thread_offset.back();
   contact_pairs.resize(number_of_contacts_possible);
+
+#pragma omp parallel for
+  for (int t = 0; t < thread_pairs.size(); t++) {
+    thrust::copy(thread_pairs[t].begin(), thread_pairs[t].end(), contact_pairs.begin() + thread_offset[t]);
+  }
+
+  thrust::sort(thrust_parallel, contact_pairs.begin(), contact_pairs.end());
+
   LOG(TRACE) << "Number of possible collisions: " << number_of_contacts_possible;
+}
+// =========================================================================================================
+void ChCBroadphase::RebuildHierarchicalBins() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  const int3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
+  const real3& bin_size_vec = data_manager->measures.collision.bin_size_vec;
+  real3 inv_bin_size_vec = 1.0 / bin_size_vec;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
+  // The finest level is the regular grid, every coarser level halves the
+  // number of bins per axis until a single bin covers everything
+  level_bins.clear();
+  level_offset.clear();
+  int3 bins = bins_per_axis;
+  uint offset = 0;
+  while (true) {
+    level_bins.push_back(bins);
+    level_offset.push_back(offset);
+    offset += bins.x * bins.y * bins.z;
+    if (bins.x == 1 && bins.y == 1 && bins.z == 1) {
+      break;
+    }
+    bins = I3((bins.x + 1) / 2, (bins.y + 1) / 2, (bins.z + 1) / 2);
+  }
+  uint num_levels = level_bins.size();
+  data_manager->measures.collision.grid_levels = num_levels;
+
+  shape_level.resize(num_shapes);
 
 #pragma omp parallel for
-  for (int index = 0; index < num_bins_active; index++) {
-    function_Store_AABB_AABB_Intersection(index, aabb_min_rigid, aabb_max_rigid, bin_number, aabb_number,
-                                          bin_start_index, num_contact, fam_data, obj_active, obj_data_ID,
-                                          contact_pairs);
+  for (int i = 0; i < num_shapes; i++) {
+    function_Compute_AABB_Level(i, num_levels, bin_size_vec, aabb_min_rigid, aabb_max_rigid, shape_level);
   }
 
-  thrust::stable_sort(thrust_parallel, contact_pairs.begin(), contact_pairs.end());
+  level_count.resize(num_levels);
+  for (uint level = 0; level < num_levels; level++) {
+    level_count[level] = Thrust_Count(shape_level, level);
+    LOG(TRACE) << "Level " << level << ": " << level_count[level] << " AABBs";
+  }
 
-  number_of_contacts_possible = Thrust_Unique(contact_pairs);
+  bins_intersected.resize(num_shapes + 1);
+  bins_intersected[num_shapes] = 0;
 
-  contact_pairs.resize(number_of_contacts_possible);
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    function_Count_AABB_Level_BIN_Intersection(i, inv_bin_size_vec, level_bins, aabb_min_rigid, aabb_max_rigid,
+                                               shape_level, bins_intersected);
+  }
 
-  LOG(TRACE) << "Number of possible collisions: " << number_of_contacts_possible;
+  Thrust_Exclusive_Scan(bins_intersected);
+  number_of_bin_intersections = bins_intersected.back();
 
-  return;
+  LOG(TRACE) << "Number of bin intersections: " << number_of_bin_intersections;
+
+  bin_number.resize(number_of_bin_intersections);
+  aabb_number.resize(number_of_bin_intersections);
+
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    function_Store_AABB_Level_BIN_Intersection(i, inv_bin_size_vec, level_bins, level_offset, aabb_min_rigid,
+                                               aabb_max_rigid, shape_level, bins_intersected, bin_number,
+                                               aabb_number);
+  }
+
+  Thrust_Sort_By_Key(bin_number, aabb_number);
+
+  // The unique bin numbers are needed to look up the bins of coarser levels
+  bin_active.resize(number_of_bin_intersections);
+  bin_start_index.resize(number_of_bin_intersections);
+  num_bins_active = Thrust_Reduce_By_Key(bin_number, bin_active, bin_start_index);
+
+  data_manager->measures.collision.rebinned_shapes = num_shapes;
+}
+// =========================================================================================================
+bool ChCBroadphase::GridIsValid(const real3& min_point, const real3& max_point) {
+  if (!grid_valid) {
+    return false;
+  }
+  if (bin_range_min.size() != data_manager->num_rigid_shapes) {
+    return false;
+  }
+  if (grid_bins_per_axis != data_manager->settings.collision.bins_per_axis) {
+    return false;
+  }
+  // All of the AABBs must still be inside of the padded grid
+  return (min_point.x >= grid_min_point.x && min_point.y >= grid_min_point.y && min_point.z >= grid_min_point.z) &&
+         (max_point.x <= grid_max_point.x && max_point.y <= grid_max_point.y && max_point.z <= grid_max_point.z);
 }
 }
 }
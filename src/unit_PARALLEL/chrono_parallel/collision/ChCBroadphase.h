@@ -12,7 +12,8 @@
 // Authors: Hammad Mazhar
 // =============================================================================
 // The boradphase algorithm uses a spatial subdivison approach to find contacts
-// between objects of different sizes
+// between objects of different sizes. Optionally a hierarchy of grids can be
+// used where every shape is stored in the level that matches its size.
 // =============================================================================
 
 #ifndef CHC_BROADPHASE_H
@@ -22,6 +23,7 @@
 #include "chrono_parallel/math/ChParallelMath.h"
 #include "chrono_parallel/ChDataManager.h"
 #include "chrono_parallel/collision/ChCAABBGenerator.h"
+#include "chrono_parallel/collision/ChCBroadphaseUtils.h"
 
 namespace chrono {
 namespace collision {
@@ -31,8 +33,24 @@ class CH_PARALLEL_API ChCBroadphase {
   // functions
   ChCBroadphase();
   void DetectPossibleCollisions();
+  // Discard the grid kept for the incremental broadphase, the shape indices it
+  // refers to are no longer valid after shapes were removed
+  void Reset();
   ChParallelDataManager* data_manager;
  private:
+  // Bin every shape from scratch, the grid is recomputed from the bounding box
+  void RebuildBins();
+  // Keep the sorted bin lists from the previous step and only re-bin the shapes
+  // whose range of grid cells changed
+  void UpdateBins();
+  // Find the pairs in every bin with a single test per pair, without the
+  // separate counting pass and duplicate removal
+  void FindPairsSinglePass();
+  // Bin every shape in the level of the hierarchical grid that matches its size
+  void RebuildHierarchicalBins();
+  // Check if the grid used by the incremental broadphase is still usable
+  bool GridIsValid(const real3& min_point, const real3& max_point);
+
   uint num_bins_active;
   uint number_of_bin_intersections;
   uint number_of_contacts_possible;
@@ -42,6 +60,35 @@ class CH_PARALLEL_API ChCBroadphase {
   custom_vector<uint> aabb_number;
   custom_vector<uint> bin_start_index;
   custom_vector<uint> num_contact;
+  custom_vector<uint> bin_active;
+
+  // Data used by the incremental broadphase
+  bool grid_valid;
+  int3 grid_bins_per_axis;
+  real3 grid_min_point;
+  real3 grid_max_point;
+  custom_vector<int3> bin_range_min;
+  custom_vector<int3> bin_range_max;
+  custom_vector<bool> shape_rebin;
+  custom_vector<uint> rebinned_shapes;
+  custom_vector<uint> new_bin_number;
+  custom_vector<uint> new_aabb_number;
+  custom_vector<uint> merge_bin_number;
+  custom_vector<uint> merge_aabb_number;
+
+  // AABBs of the (bin, aabb) entries, in the same order as aabb_number
+  aabb_soa bin_aabbs;
+
+  // Pairs found by each thread in single pass mode
+  std::vector<custom_vector<long long> > thread_pairs;
+  std::vector<uint> thread_offset;
+
+  // Data used by the hierarchical grid
+  std::vector<int3> level_bins;    // Number of bins per axis for each level
+  std::vector<uint> level_offset;  // Offset of the bin numbers of each level
+  std::vector<uint> level_count;   // Number of AABBs stored in each level
+  custom_vector<uint> shape_level;
+  custom_vector<uint> num_level_contact;
 
 };
 }
@@ -0,0 +1,437 @@
+#include <algorithm>
+#include <vector>
+
+#include "chrono_parallel/collision/ChCBroadphaseSAP.h"
+#include "chrono_parallel/collision/ChCBroadphaseUtils.h"
+
+#include <thrust/sort.h>
+#include <thrust/unique.h>
+#include <thrust/set_operations.h>
+
+namespace chrono {
+namespace collision {
+
+// The insertion sort is abandoned in favor of a full sort if it has to move
+// the endpoints more than this many times per endpoint
+#define SAP_MAX_INSERTION_MOVES 8
+// Above this number of shapes the endpoints are refreshed in parallel, every
+// thread sorting one chunk of the list
+#define SAP_PARALLEL_REFRESH_SHAPES 16384
+
+// Function to store the pair of shapes of two endpoints that crossed=====================================
+// Only a lower endpoint crossing the upper endpoint of another shape changes
+// the overlap of the two shapes along the axis
+static inline void function_Record_Swap(const sap_endpoint& a, const sap_endpoint& b, std::vector<long long>& swaps) {
+  uint shapeA = a.id >> 1;
+  uint shapeB = b.id >> 1;
+  if ((a.id & 1) == (b.id & 1) || shapeA == shapeB) {
+    return;
+  }
+  if (shapeA < shapeB) {
+    swaps.push_back((long long)shapeA << 32 | (long long)shapeB);
+  } else {
+    swaps.push_back((long long)shapeB << 32 | (long long)shapeA);
+  }
+}
+
+// Function to refresh a nearly sorted list of endpoints===================================================
+// Sorts the range [start, end) of the list, every pair of endpoints that cross
+// is stored in swaps. Returns false if the range was too far from being sorted,
+// in that case the range is left unsorted (but still a valid permutation)
+static bool function_Insertion_Sort(host_vector<sap_endpoint>& endpoints,
+                                    const uint start,
+                                    const uint end,
+                                    const uint max_moves,
+                                    std::vector<long long>& swaps) {
+  uint moves = 0;
+  for (uint i = start + 1; i < end; i++) {
+    sap_endpoint endpoint = endpoints[i];
+    uint j = i;
+    while (j > start && endpoint < endpoints[j - 1]) {
+      function_Record_Swap(endpoint, endpoints[j - 1], swaps);
+      endpoints[j] = endpoints[j - 1];
+      j--;
+      moves++;
+      if (moves > max_moves) {
+        endpoints[j] = endpoint;
+        return false;
+      }
+    }
+    endpoints[j] = endpoint;
+  }
+  return true;
+}
+
+// Function to refresh a nearly sorted list of endpoints in parallel=======================================
+// Every chunk of the list is sorted by its own thread, then the endpoints that
+// are out of order across the boundary of two chunks are sorted in a window
+// around the boundary: from the first endpoint of the left chunk that is larger
+// than the start of the right chunk, to the last endpoint of the right chunk
+// that is smaller than the end of the left chunk. Every pair of endpoints that
+// is out of order is swapped once, by a chunk or by a window. Returns false if
+// the windows overlap or the list is still not sorted, the list is then left
+// unsorted (but still a valid permutation)
+static bool function_Parallel_Insertion_Sort(host_vector<sap_endpoint>& endpoints,
+                                             const uint num_chunks,
+                                             const uint max_moves_per_endpoint,
+                                             std::vector<long long>& swaps) {
+  uint num_endpoints = endpoints.size();
+  std::vector<uint> chunk_start(num_chunks + 1);
+  for (uint c = 0; c <= num_chunks; c++) {
+    chunk_start[c] = (uint)((unsigned long long)num_endpoints * c / num_chunks);
+  }
+  std::vector<std::vector<long long> > chunk_swaps(num_chunks);
+
+  uint failed = 0;
+#pragma omp parallel for reduction(+ : failed)
+  for (int c = 0; c < num_chunks; c++) {
+    uint start = chunk_start[c];
+    uint end = chunk_start[c + 1];
+    failed += !function_Insertion_Sort(endpoints, start, end, max_moves_per_endpoint * (end - start), chunk_swaps[c]);
+  }
+  if (failed) {
+    return false;
+  }
+
+  std::vector<uint> window_start(num_chunks - 1);
+  std::vector<uint> window_end(num_chunks - 1);
+  for (uint b = 0; b < num_chunks - 1; b++) {
+    host_vector<sap_endpoint>::iterator left = endpoints.begin() + chunk_start[b];
+    host_vector<sap_endpoint>::iterator mid = endpoints.begin() + chunk_start[b + 1];
+    host_vector<sap_endpoint>::iterator right = endpoints.begin() + chunk_start[b + 2];
+    window_start[b] = std::upper_bound(left, mid, *mid) - endpoints.begin();
+    window_end[b] = std::lower_bound(mid, right, *(mid - 1)) - endpoints.begin();
+    if (b > 0 && window_start[b] < window_end[b - 1]) {
+      return false;
+    }
+  }
+
+#pragma omp parallel for reduction(+ : failed)
+  for (int b = 0; b < num_chunks - 1; b++) {
+    uint start = window_start[b];
+    uint end = window_end[b];
+    failed += !function_Insertion_Sort(endpoints, start, end, max_moves_per_endpoint * (end - start), chunk_swaps[b]);
+  }
+  if (failed) {
+    return false;
+  }
+
+  // An endpoint that has to cross a whole chunk is not caught by the windows
+  uint descents = 0;
+#pragma omp parallel for reduction(+ : descents)
+  for (int i = 1; i < num_endpoints; i++) {
+    descents += endpoints[i] < endpoints[i - 1];
+  }
+  if (descents != 0) {
+    return false;
+  }
+
+  for (uint c = 0; c < num_chunks; c++) {
+    swaps.insert(swaps.end(), chunk_swaps[c].begin(), chunk_swaps[c].end());
+  }
+  return true;
+}
+
+// Function to count the AABB AABB intersections along the sweep axis=======================================
+// Every shape is tested against the shapes whose lower endpoint lies between
+// its own endpoints, so every overlapping pair is found exactly once
+inline void function_Count_SAP_Intersection(const uint index,
+                                            const host_vector<real3>& aabb_min_data,
+                                            const host_vector<real3>& aabb_max_data,
+                                            const host_vector<sap_endpoint>& endpoints,
+                                            host_vector<uint>& num_contact) {
+  uint count = 0;
+  uint idA = endpoints[index].id;
+  if ((idA & 1) == 0) {
+    uint shapeA = idA >> 1;
+    real3 Amin = aabb_min_data[shapeA];
+    real3 Amax = aabb_max_data[shapeA];
+
+    for (uint k = index + 1; endpoints[k].id != (idA | 1); k++) {
+      uint idB = endpoints[k].id;
+      if ((idB & 1) == 0 && overlap(Amin, Amax, aabb_min_data[idB >> 1], aabb_max_data[idB >> 1])) {
+        count++;
+      }
+    }
+  }
+  num_contact[index] = count;
+}
+
+// Function to store the AABB AABB intersections along the sweep axis=======================================
+inline void function_Store_SAP_Intersection(const uint index,
+                                            const host_vector<real3>& aabb_min_data,
+                                            const host_vector<real3>& aabb_max_data,
+                                            const host_vector<sap_endpoint>& endpoints,
+                                            const host_vector<uint>& num_contact,
+                                            host_vector<long long>& potential_contacts) {
+  uint idA = endpoints[index].id;
+  if ((idA & 1) == 1) {
+    return;
+  }
+  uint shapeA = idA >> 1;
+  real3 Amin = aabb_min_data[shapeA];
+  real3 Amax = aabb_max_data[shapeA];
+  uint offset = num_contact[index];
+  uint count = 0;
+
+  for (uint k = index + 1; endpoints[k].id != (idA | 1); k++) {
+    uint idB = endpoints[k].id;
+    uint shapeB = idB >> 1;
+    if ((idB & 1) == 1 || !overlap(Amin, Amax, aabb_min_data[shapeB], aabb_max_data[shapeB]))
+      continue;
+
+    // the two indices of the shapes that make up the contact
+    if (shapeA < shapeB) {
+      potential_contacts[offset + count] = ((long long)shapeA << 32 | (long long)shapeB);
+    } else {
+      potential_contacts[offset + count] = ((long long)shapeB << 32 | (long long)shapeA);
+    }
+    count++;
+  }
+}
+
+// Function to check if a pair of overlapping AABBs is a possible contact=======================================
+inline bool function_Check_SAP_Pair(const long long pair,
+                                    const host_vector<short2>& fam_data,
+                                    const host_vector<bool>& body_active,
+                                    const host_vector<uint>& body_id) {
+  uint shapeA = int(pair >> 32);
+  uint shapeB = int(pair & 0xffffffff);
+  uint bodyA = body_id[shapeA];
+  uint bodyB = body_id[shapeB];
+
+  if (bodyA == bodyB)
+    return false;
+  if (!body_active[bodyA] && !body_active[bodyB])
+    return false;
+  return collide(fam_data[shapeA], fam_data[shapeB]);
+}
+// =========================================================================================================
+ChCBroadphaseSAP::ChCBroadphaseSAP() {
+  sweep_axis = 0;
+  sweep_variance = 0;
+  number_of_contacts_possible = 0;
+  data_manager = 0;
+}
+// =========================================================================================================
+void ChCBroadphaseSAP::Reset() {
+  for (int axis = 0; axis < 3; axis++) {
+    endpoints[axis].clear();
+  }
+  overlap_pairs.clear();
+}
+// =========================================================================================================
+void ChCBroadphaseSAP::ComputeSweepAxis() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
+  real sum_x = 0, sum_y = 0, sum_z = 0;
+  real sum2_x = 0, sum2_y = 0, sum2_z = 0;
+
+#pragma omp parallel for reduction(+ : sum_x, sum_y, sum_z, sum2_x, sum2_y, sum2_z)
+  for (int i = 0; i < num_shapes; i++) {
+    real3 center = (aabb_min_rigid[i] + aabb_max_rigid[i]) * .5;
+    sum_x += center.x;
+    sum_y += center.y;
+    sum_z += center.z;
+    sum2_x += center.x * center.x;
+    sum2_y += center.y * center.y;
+    sum2_z += center.z * center.z;
+  }
+
+  real variance[3] = {sum2_x - sum_x * sum_x / num_shapes, sum2_y - sum_y * sum_y / num_shapes,
+                      sum2_z - sum_z * sum_z / num_shapes};
+
+  sweep_axis = 0;
+  for (int i = 1; i < 3; i++) {
+    if (variance[i] > variance[sweep_axis]) {
+      sweep_axis = i;
+    }
+  }
+  sweep_variance = variance[sweep_axis];
+}
+// =========================================================================================================
+void ChCBroadphaseSAP::InitializeEndpoints() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
+  for (int axis = 0; axis < 3; axis++) {
+    host_vector<sap_endpoint>& list = endpoints[axis];
+    list.resize(num_shapes * 2);
+#pragma omp parallel for
+    for (int i = 0; i < num_shapes; i++) {
+      list[i * 2 + 0].value = aabb_min_rigid[i].array[axis];
+      list[i * 2 + 0].id = i * 2 + 0;
+      list[i * 2 + 1].value = aabb_max_rigid[i].array[axis];
+      list[i * 2 + 1].id = i * 2 + 1;
+    }
+    thrust::sort(thrust_parallel, list.begin(), list.end());
+  }
+}
+// =========================================================================================================
+bool ChCBroadphaseSAP::RefreshEndpoints() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  uint num_shapes = data_manager->num_rigid_shapes;
+  uint num_endpoints = num_shapes * 2;
+
+  for (int axis = 0; axis < 3; axis++) {
+    host_vector<sap_endpoint>& list = endpoints[axis];
+#pragma omp parallel for
+    for (int i = 0; i < num_endpoints; i++) {
+      uint id = list[i].id;
+      list[i].value = (id & 1) ? aabb_max_rigid[id >> 1].array[axis] : aabb_min_rigid[id >> 1].array[axis];
+    }
+  }
+
+  // Objects move little between steps so the order from the previous step is
+  // almost sorted. Large lists are sorted in parallel chunks, otherwise every
+  // axis is sorted by its own thread.
+  std::vector<long long> axis_swaps[3];
+  uint failed = 0;
+  int num_threads = omp_get_max_threads();
+  if (num_threads > 1 && num_shapes >= SAP_PARALLEL_REFRESH_SHAPES) {
+    for (int axis = 0; axis < 3 && !failed; axis++) {
+      failed += !function_Parallel_Insertion_Sort(endpoints[axis], num_threads, SAP_MAX_INSERTION_MOVES,
+                                                  axis_swaps[axis]);
+    }
+  } else {
+#pragma omp parallel for reduction(+ : failed)
+    for (int axis = 0; axis < 3; axis++) {
+      failed += !function_Insertion_Sort(endpoints[axis], 0, num_endpoints, SAP_MAX_INSERTION_MOVES * num_endpoints,
+                                         axis_swaps[axis]);
+    }
+  }
+  if (failed) {
+    return false;
+  }
+
+  swaps.clear();
+  for (int axis = 0; axis < 3; axis++) {
+    swaps.insert(swaps.end(), axis_swaps[axis].begin(), axis_swaps[axis].end());
+  }
+  return true;
+}
+// =========================================================================================================
+void ChCBroadphaseSAP::ComputeOverlaps() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+  const host_vector<sap_endpoint>& list = endpoints[sweep_axis];
+  uint num_endpoints = list.size();
+
+  num_contact.resize(num_endpoints + 1);
+  num_contact[num_endpoints] = 0;
+
+#pragma omp parallel for schedule(dynamic, 128)
+  for (int i = 0; i < num_endpoints; i++) {
+    function_Count_SAP_Intersection(i, aabb_min_rigid, aabb_max_rigid, list, num_contact);
+  }
+
+  Thrust_Exclusive_Scan(num_contact);
+  overlap_pairs.resize(num_contact.back());
+
+#pragma omp parallel for schedule(dynamic, 128)
+  for (int i = 0; i < num_endpoints; i++) {
+    function_Store_SAP_Intersection(i, aabb_min_rigid, aabb_max_rigid, list, num_contact, overlap_pairs);
+  }
+
+  thrust::sort(thrust_parallel, overlap_pairs.begin(), overlap_pairs.end());
+}
+// =========================================================================================================
+void ChCBroadphaseSAP::UpdateOverlaps() {
+  const host_vector<real3>& aabb_min_rigid = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max_rigid = data_manager->host_data.aabb_max_rigid;
+
+  // A pair can cross on several axes, or both of its lower endpoints can cross
+  // the upper endpoint of the other shape
+  thrust::sort(thrust_parallel, swaps.begin(), swaps.end());
+  swaps.erase(thrust::unique(thrust_parallel, swaps.begin(), swaps.end()), swaps.end());
+  uint num_swaps = swaps.size();
+
+  custom_vector<bool> swap_overlap(num_swaps);
+#pragma omp parallel for
+  for (int i = 0; i < num_swaps; i++) {
+    uint shapeA = int(swaps[i] >> 32);
+    uint shapeB = int(swaps[i] & 0xffffffff);
+    swap_overlap[i] =
+        overlap(aabb_min_rigid[shapeA], aabb_max_rigid[shapeA], aabb_min_rigid[shapeB], aabb_max_rigid[shapeB]);
+  }
+
+  // The pairs that stopped overlapping are removed, the ones that started to
+  // overlap are added, both lists are still sorted
+  custom_vector<long long> added, removed;
+  for (uint i = 0; i < num_swaps; i++) {
+    if (swap_overlap[i]) {
+      added.push_back(swaps[i]);
+    } else {
+      removed.push_back(swaps[i]);
+    }
+  }
+
+  custom_vector<long long> kept(overlap_pairs.size());
+  custom_vector<long long>::iterator kept_end = thrust::set_difference(
+      thrust_parallel, overlap_pairs.begin(), overlap_pairs.end(), removed.begin(), removed.end(), kept.begin());
+  kept.erase(kept_end, kept.end());
+
+  overlap_pairs.resize(kept.size() + added.size());
+  custom_vector<long long>::iterator pairs_end = thrust::set_union(
+      thrust_parallel, kept.begin(), kept.end(), added.begin(), added.end(), overlap_pairs.begin());
+  overlap_pairs.erase(pairs_end, overlap_pairs.end());
+
+  LOG(TRACE) << "SAP crossings: " << num_swaps << " added: " << added.size() << " removed: " << removed.size();
+}
+// =========================================================================================================
+void ChCBroadphaseSAP::DetectPossibleCollisions() {
+  host_vector<long long>& contact_pairs = data_manager->host_data.pair_rigid_rigid;
+  const host_vector<short2>& fam_data = data_manager->host_data.fam_rigid;
+  const host_vector<bool>& obj_active = data_manager->host_data.active_rigid;
+  const host_vector<uint>& obj_data_ID = data_manager->host_data.id_rigid;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
+  LOG(TRACE) << "Number of AABBs: " << num_shapes;
+  contact_pairs.clear();
+
+  // The AABBs are used in the global frame, there is no grid origin
+  data_manager->measures.collision.global_origin = R3(0);
+
+  // The list of pairs is updated with the endpoints that crossed since the
+  // previous step, and built from scratch when that is not possible
+  if (endpoints[0].size() == num_shapes * 2 && RefreshEndpoints()) {
+    UpdateOverlaps();
+    data_manager->measures.collision.rebinned_shapes = 0;
+  } else {
+    LOG(TRACE) << "SAP endpoints changed too much, sorting from scratch";
+    InitializeEndpoints();
+    ComputeSweepAxis();
+    ComputeOverlaps();
+    data_manager->measures.collision.rebinned_shapes = num_shapes;
+    LOG(TRACE) << "Sweep axis: " << sweep_axis << " variance: " << sweep_variance;
+  }
+
+  // Only the overlapping pairs that can collide are contacts, the list is
+  // sorted so that the order is the same as the one produced by the grid
+  uint num_overlaps = overlap_pairs.size();
+  num_contact.resize(num_overlaps + 1);
+  num_contact[num_overlaps] = 0;
+#pragma omp parallel for
+  for (int i = 0; i < num_overlaps; i++) {
+    num_contact[i] = function_Check_SAP_Pair(overlap_pairs[i], fam_data, obj_active, obj_data_ID);
+  }
+
+  Thrust_Exclusive_Scan(num_contact);
+  number_of_contacts_possible = num_contact.back();
+  contact_pairs.resize(number_of_contacts_possible);
+
+#pragma omp parallel for
+  for (int i = 0; i < num_overlaps; i++) {
+    if (num_contact[i + 1] != num_contact[i]) {
+      contact_pairs[num_contact[i]] = overlap_pairs[i];
+    }
+  }
+
+  LOG(TRACE) << "Number of possible collisions: " << number_of_contacts_possible;
+}
+}
+}
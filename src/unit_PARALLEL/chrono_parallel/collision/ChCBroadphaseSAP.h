@@ -0,0 +1,91 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+// Sweep and prune broadphase. The lower and upper endpoints of the AABBs are
+// kept sorted along all three axes, and the list of pairs whose AABBs overlap
+// on every axis is kept between steps. Objects move little between steps, so
+// the endpoints are refreshed with an insertion sort (in parallel chunks for
+// large numbers of shapes). Every time the lower endpoint of one AABB crosses
+// the upper endpoint of another, the overlap of the two AABBs along that axis
+// changed, only these pairs are tested again to update the list. The cost of
+// a step therefore scales with the motion of the shapes rather than with their
+// number. Unlike the grid, the cost of a large AABB does not depend on the
+// number of bins it spans.
+// The list of pairs is built from scratch when the shapes change or when the
+// endpoints moved too much for the insertion sort, by sweeping the axis along
+// which the AABB centers are spread the most.
+// =============================================================================
+
+#ifndef CHC_BROADPHASE_SAP_H
+#define CHC_BROADPHASE_SAP_H
+
+#include "chrono_parallel/ChParallelDefines.h"
+#include "chrono_parallel/math/ChParallelMath.h"
+#include "chrono_parallel/ChDataManager.h"
+#include "chrono_parallel/collision/ChCAABBGenerator.h"
+
+namespace chrono {
+namespace collision {
+
+// Lower or upper endpoint of an AABB along one axis
+struct sap_endpoint {
+  real value;  // Coordinate of the endpoint
+  uint id;     // Index of the shape times two, plus one for the upper endpoint
+};
+
+// Endpoints are sorted by coordinate, lower endpoints first when they are equal.
+// A lower endpoint is then before an upper endpoint exactly when the two AABBs
+// overlap along the axis, as in the overlap test.
+inline bool operator<(const sap_endpoint& a, const sap_endpoint& b) {
+  return a.value < b.value || (a.value == b.value && (a.id & 1) < (b.id & 1));
+}
+
+class CH_PARALLEL_API ChCBroadphaseSAP {
+ public:
+  // functions
+  ChCBroadphaseSAP();
+  void DetectPossibleCollisions();
+  // Discard the sorted endpoints and the pairs kept from the previous step, the
+  // shape indices they refer to are no longer valid after shapes were removed
+  void Reset();
+  ChParallelDataManager* data_manager;
+
+ private:
+  // Pick the axis along which the centers of the AABBs are spread the most,
+  // used when the list of pairs is built from scratch
+  void ComputeSweepAxis();
+  // Sort the endpoints of every axis from scratch
+  void InitializeEndpoints();
+  // Update the endpoints of every axis with the new AABBs and sort them again
+  // starting from the order of the previous step. The pairs of shapes whose
+  // lower and upper endpoints crossed are stored in swaps. Returns false if the
+  // endpoints moved too much, the lists are then left unsorted.
+  bool RefreshEndpoints();
+  // Find every pair of overlapping AABBs by sweeping the sweep axis
+  void ComputeOverlaps();
+  // Test the pairs in swaps again and update the list of overlapping AABBs
+  void UpdateOverlaps();
+
+  int sweep_axis;
+  real sweep_variance;
+  uint number_of_contacts_possible;
+
+  custom_vector<sap_endpoint> endpoints[3];  // Sorted endpoints along each axis
+  custom_vector<long long> overlap_pairs;    // Sorted pairs of shapes whose AABBs overlap
+  custom_vector<long long> swaps;            // Pairs whose endpoints crossed in the last refresh
+  custom_vector<uint> num_contact;
+};
+}
+}
+
+#endif
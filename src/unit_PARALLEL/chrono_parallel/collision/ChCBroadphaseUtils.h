@@ -22,6 +22,21 @@
 #include "chrono_parallel/ChDataManager.h"
 #include "chrono_parallel/collision/ChCAABBGenerator.h"
 
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Vector instruction set used for the blocked AABB tests
+#if defined(__AVX__)
+#define AABB_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AABB_SIMD_SSE2
+#endif
+
+#if defined(AABB_SIMD_AVX) || defined(AABB_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
 namespace chrono {
 namespace collision {
 
@@ -76,6 +91,56 @@ inline int3 Hash_Decode(uint hash, int3 bins_per_axis) {
   return decoded_hash;
 }
 
+// SPACE FILLING CURVES ====================================================================================
+// Position along a curve through a 1024^3 grid, cells close along the curve are close in space
+// Spread the 10 lower bits of a coordinate so that there are two zero bits between each of them
+inline uint Morton_Spread(uint x) {
+  x &= 0x3ff;
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+// Z-order curve, interleaves the bits of the three coordinates
+inline uint Morton_Index(const int3& A) {
+  return Morton_Spread(A.x) | (Morton_Spread(A.y) << 1) | (Morton_Spread(A.z) << 2);
+}
+// Hilbert curve, consecutive cells are always neighbors (J. Skilling, "Programming the Hilbert curve", 2004)
+inline uint Hilbert_Index(const int3& A) {
+  uint X[3] = {uint(A.x) & 0x3ff, uint(A.y) & 0x3ff, uint(A.z) & 0x3ff};
+  // Inverse undo of the rotations and reflections
+  for (uint Q = 1 << 9; Q > 1; Q >>= 1) {
+    uint P = Q - 1;
+    for (int i = 0; i < 3; i++) {
+      if (X[i] & Q) {
+        X[0] ^= P;
+      } else {
+        uint t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+  // Gray encode
+  X[1] ^= X[0];
+  X[2] ^= X[1];
+  uint t = 0;
+  for (uint Q = 1 << 9; Q > 1; Q >>= 1) {
+    if (X[2] & Q) {
+      t ^= Q - 1;
+    }
+  }
+  // Interleave the transposed bits, the bits of X[0] are the most significant
+  uint index = 0;
+  for (int b = 9; b >= 0; b--) {
+    for (int i = 0; i < 3; i++) {
+      index = (index << 1) | (((X[i] ^ t) >> b) & 1);
+    }
+  }
+  return index;
+}
+
 // AABB COLLISION FUNCTIONS ================================================================================
 
 // Check if two bodies interact using their collision family data.
@@ -92,6 +157,177 @@ inline bool overlap(real3 Amin, real3 Amax, real3 Bmin, real3 Bmax) {
          (Amin.z <= Bmax.z && Bmin.z <= Amax.z);
 }
 
+// BLOCKED AABB TESTS ======================================================================================
+// The AABBs of the grid bins are copied into a structure of arrays so that one
+// AABB can be tested against several candidates with a single vector compare.
+// The vector width follows the instruction set the compiler targets (the
+// default double precision build uses -march=native) independently of
+// ENABLE_SSE, which only controls the layout of real3 (see the top of the file).
+
+// Number of AABBs tested at once by function_Overlap_AABB_Block, a full
+// vector register of reals (two SSE2 registers of doubles)
+#if defined(AABB_SIMD_AVX) && !defined(CHRONO_PARALLEL_USE_DOUBLE)
+#define AABB_BLOCK_SIZE 8
+#else
+#define AABB_BLOCK_SIZE 4
+#endif
+
+// Alignment of the arrays of AABBs, every block starts on this boundary
+#define AABB_ALIGNMENT 32
+
+// Allocator returning memory aligned to Alignment bytes
+template <class T, std::size_t Alignment>
+class aligned_allocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <class U>
+  struct rebind {
+    typedef aligned_allocator<U, Alignment> other;
+  };
+
+  aligned_allocator() {}
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Alignment>&) {}
+
+  pointer address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+  size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+  pointer allocate(size_type n, const void* hint = 0) {
+    if (n == 0)
+      return 0;
+#ifdef _MSC_VER
+    void* p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+    void* p = 0;
+    if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0)
+      p = 0;
+#endif
+    if (!p)
+      throw std::bad_alloc();
+    return static_cast<pointer>(p);
+  }
+  void deallocate(pointer p, size_type) {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+  }
+  void construct(pointer p, const T& val) { new (p) T(val); }
+  void destroy(pointer p) { p->~T(); }
+
+  bool operator==(const aligned_allocator&) const { return true; }
+  bool operator!=(const aligned_allocator&) const { return false; }
+};
+
+typedef std::vector<real, aligned_allocator<real, AABB_ALIGNMENT> > aligned_real_vector;
+
+// Structure of arrays holding a list of AABBs. The bounds of consecutive AABBs
+// are contiguous in memory and aligned so that the blocks of AABB_BLOCK_SIZE
+// AABBs can be loaded with aligned loads.
+struct aabb_soa {
+  aligned_real_vector min_x, min_y, min_z;
+  aligned_real_vector max_x, max_y, max_z;
+
+  // Resize the arrays to hold num_aabbs AABBs, padded to a whole number of
+  // blocks with empty AABBs that never overlap anything
+  void resize(uint num_aabbs) {
+    uint padded = (num_aabbs + AABB_BLOCK_SIZE - 1) / AABB_BLOCK_SIZE * AABB_BLOCK_SIZE;
+    min_x.resize(padded);
+    min_y.resize(padded);
+    min_z.resize(padded);
+    max_x.resize(padded);
+    max_y.resize(padded);
+    max_z.resize(padded);
+    for (uint i = num_aabbs; i < padded; i++) {
+      min_x[i] = min_y[i] = min_z[i] = LARGE_REAL;
+      max_x[i] = max_y[i] = max_z[i] = -LARGE_REAL;
+    }
+  }
+};
+
+// Index of the first AABB of the block holding AABB index
+inline uint function_AABB_Block_Start(const uint index) {
+  return index & ~(AABB_BLOCK_SIZE - 1);
+}
+
+// Mask of the AABBs of the block starting at index that lie in [first, end)
+inline int function_AABB_Block_Range(const uint index, const uint first, const uint end) {
+  int mask = (1 << AABB_BLOCK_SIZE) - 1;
+  if (first > index) {
+    mask &= ~((1 << (first - index)) - 1);
+  }
+  if (end - index < AABB_BLOCK_SIZE) {
+    mask &= (1 << (end - index)) - 1;
+  }
+  return mask;
+}
+
+// Check if an AABB overlaps the AABB_BLOCK_SIZE AABBs of the block starting at
+// index in a structure of arrays. Bit i of the returned mask is set if AABB
+// index + i overlaps. index must be a multiple of AABB_BLOCK_SIZE.
+inline int function_Overlap_AABB_Block(const real3& Amin, const real3& Amax, const aabb_soa& aabbs, const uint index) {
+#if defined(CHRONO_PARALLEL_USE_DOUBLE) && defined(AABB_SIMD_AVX)
+  __m256d x = _mm256_and_pd(_mm256_cmp_pd(_mm256_set1_pd(Amin.x), _mm256_load_pd(&aabbs.max_x[index]), _CMP_LE_OQ),
+                            _mm256_cmp_pd(_mm256_load_pd(&aabbs.min_x[index]), _mm256_set1_pd(Amax.x), _CMP_LE_OQ));
+  __m256d y = _mm256_and_pd(_mm256_cmp_pd(_mm256_set1_pd(Amin.y), _mm256_load_pd(&aabbs.max_y[index]), _CMP_LE_OQ),
+                            _mm256_cmp_pd(_mm256_load_pd(&aabbs.min_y[index]), _mm256_set1_pd(Amax.y), _CMP_LE_OQ));
+  __m256d z = _mm256_and_pd(_mm256_cmp_pd(_mm256_set1_pd(Amin.z), _mm256_load_pd(&aabbs.max_z[index]), _CMP_LE_OQ),
+                            _mm256_cmp_pd(_mm256_load_pd(&aabbs.min_z[index]), _mm256_set1_pd(Amax.z), _CMP_LE_OQ));
+  return _mm256_movemask_pd(_mm256_and_pd(x, _mm256_and_pd(y, z)));
+#elif defined(CHRONO_PARALLEL_USE_DOUBLE) && defined(AABB_SIMD_SSE2)
+  __m128d min_x = _mm_set1_pd(Amin.x), min_y = _mm_set1_pd(Amin.y), min_z = _mm_set1_pd(Amin.z);
+  __m128d max_x = _mm_set1_pd(Amax.x), max_y = _mm_set1_pd(Amax.y), max_z = _mm_set1_pd(Amax.z);
+  int mask = 0;
+  for (int h = 0; h < AABB_BLOCK_SIZE; h += 2) {
+    uint k = index + h;
+    __m128d x = _mm_and_pd(_mm_cmple_pd(min_x, _mm_load_pd(&aabbs.max_x[k])),
+                           _mm_cmple_pd(_mm_load_pd(&aabbs.min_x[k]), max_x));
+    __m128d y = _mm_and_pd(_mm_cmple_pd(min_y, _mm_load_pd(&aabbs.max_y[k])),
+                           _mm_cmple_pd(_mm_load_pd(&aabbs.min_y[k]), max_y));
+    __m128d z = _mm_and_pd(_mm_cmple_pd(min_z, _mm_load_pd(&aabbs.max_z[k])),
+                           _mm_cmple_pd(_mm_load_pd(&aabbs.min_z[k]), max_z));
+    mask |= _mm_movemask_pd(_mm_and_pd(x, _mm_and_pd(y, z))) << h;
+  }
+  return mask;
+#elif defined(AABB_SIMD_AVX)
+  __m256 x = _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(Amin.x), _mm256_load_ps(&aabbs.max_x[index]), _CMP_LE_OQ),
+                           _mm256_cmp_ps(_mm256_load_ps(&aabbs.min_x[index]), _mm256_set1_ps(Amax.x), _CMP_LE_OQ));
+  __m256 y = _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(Amin.y), _mm256_load_ps(&aabbs.max_y[index]), _CMP_LE_OQ),
+                           _mm256_cmp_ps(_mm256_load_ps(&aabbs.min_y[index]), _mm256_set1_ps(Amax.y), _CMP_LE_OQ));
+  __m256 z = _mm256_and_ps(_mm256_cmp_ps(_mm256_set1_ps(Amin.z), _mm256_load_ps(&aabbs.max_z[index]), _CMP_LE_OQ),
+                           _mm256_cmp_ps(_mm256_load_ps(&aabbs.min_z[index]), _mm256_set1_ps(Amax.z), _CMP_LE_OQ));
+  return _mm256_movemask_ps(_mm256_and_ps(x, _mm256_and_ps(y, z)));
+#elif defined(AABB_SIMD_SSE2)
+  __m128 x = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(Amin.x), _mm_load_ps(&aabbs.max_x[index])),
+                        _mm_cmple_ps(_mm_load_ps(&aabbs.min_x[index]), _mm_set1_ps(Amax.x)));
+  __m128 y = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(Amin.y), _mm_load_ps(&aabbs.max_y[index])),
+                        _mm_cmple_ps(_mm_load_ps(&aabbs.min_y[index]), _mm_set1_ps(Amax.y)));
+  __m128 z = _mm_and_ps(_mm_cmple_ps(_mm_set1_ps(Amin.z), _mm_load_ps(&aabbs.max_z[index])),
+                        _mm_cmple_ps(_mm_load_ps(&aabbs.min_z[index]), _mm_set1_ps(Amax.z)));
+  return _mm_movemask_ps(_mm_and_ps(x, _mm_and_ps(y, z)));
+#else
+  // Without short-circuit evaluation the loop has no branches and can be
+  // vectorized by the compiler
+  int mask = 0;
+  for (int i = 0; i < AABB_BLOCK_SIZE; i++) {
+    uint k = index + i;
+    int hit = (Amin.x <= aabbs.max_x[k]) & (aabbs.min_x[k] <= Amax.x) & (Amin.y <= aabbs.max_y[k]) &
+              (aabbs.min_y[k] <= Amax.y) & (Amin.z <= aabbs.max_z[k]) & (aabbs.min_z[k] <= Amax.z);
+    mask |= hit << i;
+  }
+  return mask;
+#endif
+}
+
 // Grid Size FUNCTIONS =====================================================================================
 
 // for a given number of aabbs in a grid, the grids maximum and minimum point along with the density factor
@@ -110,7 +346,7 @@ static int3 function_Compute_Grid_Resolution(uint num_aabb, real3 d, real k = .1
 
 // =========================================================================================================
 
-bool function_Check_Sphere(real3 pos_a, real3 pos_b, real radius) {
+inline bool function_Check_Sphere(real3 pos_a, real3 pos_b, real radius) {
   real3 delta = pos_b - pos_a;
   real dist2 = dot(delta, delta);
   real radSum = radius + radius;
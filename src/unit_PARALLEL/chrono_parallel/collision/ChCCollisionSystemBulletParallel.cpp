@@ -78,10 +78,12 @@ void ChCollisionSystemBulletParallel::Remove(ChCollisionModel* model) {
   ChModelBullet* bmodel = static_cast<ChModelBullet*>(model);
   if (bmodel->GetBulletModel()->getCollisionShape()) {
     bt_collision_world->removeCollisionObject(bmodel->GetBulletModel());
+    data_manager->num_rigid_shapes--;
   }
 }
 
 void ChCollisionSystemBulletParallel::Run() {
+  data_manager->SetPhaseThreads(PHASE_BROADPHASE);
   data_manager->system_timer.start("collision_broad");
   if (bt_collision_world) {
     bt_collision_world->performDiscreteCollisionDetection();
@@ -89,6 +91,7 @@ void ChCollisionSystemBulletParallel::Run() {
   data_manager->system_timer.stop("collision_broad");
 }
 void ChCollisionSystemBulletParallel::ReportContacts(ChContactContainerBase* mcontactcontainer) {
+  data_manager->SetPhaseThreads(PHASE_NARROWPHASE);
   data_manager->system_timer.start("collision_narrow");
   data_manager->host_data.norm_rigid_rigid.clear();
   data_manager->host_data.cpta_rigid_rigid.clear();
@@ -115,8 +118,11 @@ void ChCollisionSystemBulletParallel::ReportContacts(ChContactContainerBase* mco
     double marginA = icontact.modelA->GetSafeMargin();
     double marginB = icontact.modelB->GetSafeMargin();
 
-    bool activeA = ((ChBody*)(icontact.modelA->GetPhysicsItem()))->IsActive();
-    bool activeB = ((ChBody*)(icontact.modelB->GetPhysicsItem()))->IsActive();
+    ChBody* bodyA = (ChBody*)(icontact.modelA->GetPhysicsItem());
+    ChBody* bodyB = (ChBody*)(icontact.modelB->GetPhysicsItem());
+
+    bool activeA = bodyA->IsActive();
+    bool activeB = bodyB->IsActive();
 
     if (activeA == 0 && activeB == 0) {
       continue;
@@ -165,7 +171,9 @@ void ChCollisionSystemBulletParallel::ReportContacts(ChContactContainerBase* mco
           data_manager->host_data.cpta_rigid_rigid.push_back(R3(icontact.vpA.x, icontact.vpA.y, icontact.vpA.z));
           data_manager->host_data.cptb_rigid_rigid.push_back(R3(icontact.vpB.x, icontact.vpB.y, icontact.vpB.z));
           data_manager->host_data.dpth_rigid_rigid.push_back(icontact.distance);
-          data_manager->host_data.bids_rigid_rigid.push_back(I2(obA->getCompanionId(), obB->getCompanionId()));
+          // The body ids are used rather than the companion ids, the bodies are
+          // renumbered when bodies are removed from the system
+          data_manager->host_data.bids_rigid_rigid.push_back(I2(bodyA->GetId(), bodyB->GetId()));
           data_manager->num_rigid_contacts++;
         }
       }
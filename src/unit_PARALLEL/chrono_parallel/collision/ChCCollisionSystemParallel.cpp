@@ -10,14 +10,22 @@
 
 #include "chrono_parallel/collision/ChCCollisionSystemParallel.h"
 
+#include <algorithm>
+
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+
 namespace chrono {
 namespace collision {
 
 ChCollisionSystemParallel::ChCollisionSystemParallel(ChParallelDataManager* dm) : data_manager(dm) {
+  pairs_valid = false;
   broadphase = new ChCBroadphase;
+  broadphase_sap = new ChCBroadphaseSAP;
   narrowphase = new ChCNarrowphaseDispatch;
   aabb_generator = new ChCAABBGenerator;
   broadphase->data_manager = dm;
+  broadphase_sap->data_manager = dm;
   narrowphase->data_manager = dm;
   aabb_generator->data_manager = dm;
 }
@@ -25,6 +33,7 @@ ChCollisionSystemParallel::ChCollisionSystemParallel(ChParallelDataManager* dm)
 ChCollisionSystemParallel::~ChCollisionSystemParallel() {
   delete narrowphase;
   delete broadphase;
+  delete broadphase_sap;
   delete aabb_generator;
 }
 
@@ -59,28 +68,142 @@ void ChCollisionSystemParallel::Add(ChCollisionModel* model) {
       data_manager->host_data.id_rigid.push_back(body_id);
       data_manager->num_rigid_shapes++;
     }
+    pairs_valid = false;
   }
 }
 
 void ChCollisionSystemParallel::Remove(ChCollisionModel* model) {
-  //            ChCollisionModelGPU *body = (ChCollisionModelGPU *) model;
-  //            int body_id = ((ChBodyGPU *) body->GetBody())->id;
-  //
-  //            //for (int j = 0; j < body->GetNObjects(); j++) {
-  //            for (int i = 0; i < data_manager->host_typ_data.size(); i++) {
-  //                if (data_manager->host_typ_data[i].z == body_id) {
-  //                    data_manager->host_ObA_data.erase(data_manager->host_ObA_data.begin() + i);
-  //                    data_manager->host_ObB_data.erase(data_manager->host_ObB_data.begin() + i);
-  //                    data_manager->host_ObC_data.erase(data_manager->host_ObC_data.begin() + i);
-  //                    data_manager->host_ObR_data.erase(data_manager->host_ObR_data.begin() + i);
-  //                    data_manager->host_fam_data.erase(data_manager->host_fam_data.begin() + i);
-  //                    data_manager->host_typ_data.erase(data_manager->host_typ_data.begin() + i);
-  //                    data_manager->num_models--;
-  //                    return;
-  //                }
-  //            }
-  //
-  //            //}
+  ChCollisionModelParallel* pmodel = static_cast<ChCollisionModelParallel*>(model);
+  int body_id = pmodel->GetBody()->GetId();
+  removed_models.push_back(I2(body_id, data_manager->num_rigid_shapes));
+}
+
+void ChCollisionSystemParallel::RemoveShapes(const custom_vector<int>& body_map, custom_vector<int>& shape_map) {
+  host_container& host_data = data_manager->host_data;
+  uint num_shapes = data_manager->num_rigid_shapes;
+  uint num_bodies = body_map.size();
+
+  // A shape is removed if it was added to its body before the model of the body
+  // was removed, or if its body was removed
+  custom_vector<uint> removed_before(num_bodies, 0);
+  for (int i = 0; i < removed_models.size(); i++) {
+    int2 model = removed_models[i];
+    removed_before[model.x] = std::max(removed_before[model.x], uint(model.y));
+  }
+  removed_models.clear();
+
+  custom_vector<uint> shape_removed(num_shapes);
+  custom_vector<uint> point_removed(host_data.convex_data.size(), 0);
+
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    uint body_id = host_data.id_rigid[i];
+    shape_removed[i] = (i < removed_before[body_id] || body_map[body_id] == -1);
+    // The points of a convex shape are not shared with other shapes
+    if (shape_removed[i] && host_data.typ_rigid[i] == CONVEX) {
+      real3 B = host_data.ObB_rigid[i];
+      for (int j = int(B.y); j < int(B.y) + int(B.x); j++) {
+        point_removed[j] = 1;
+      }
+    }
+  }
+
+  // The offset of a convex shape moves back by the number of removed points
+  // stored in front of it
+  custom_vector<uint> point_offset(point_removed.size());
+  thrust::exclusive_scan(point_removed.begin(), point_removed.end(), point_offset.begin());
+  shape_map.resize(num_shapes);
+  thrust::exclusive_scan(shape_removed.begin(), shape_removed.end(), shape_map.begin());
+
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    if (shape_removed[i]) {
+      shape_map[i] = -1;
+      continue;
+    }
+    shape_map[i] = i - shape_map[i];
+    host_data.id_rigid[i] = body_map[host_data.id_rigid[i]];
+    if (host_data.typ_rigid[i] == CONVEX) {
+      host_data.ObB_rigid[i].y -= point_offset[int(host_data.ObB_rigid[i].y)];
+    }
+  }
+
+  Thrust_Compact(host_data.ObA_rigid, shape_removed);
+  Thrust_Compact(host_data.ObB_rigid, shape_removed);
+  Thrust_Compact(host_data.ObC_rigid, shape_removed);
+  Thrust_Compact(host_data.ObR_rigid, shape_removed);
+  Thrust_Compact(host_data.fam_rigid, shape_removed);
+  Thrust_Compact(host_data.margin_rigid, shape_removed);
+  Thrust_Compact(host_data.typ_rigid, shape_removed);
+  Thrust_Compact(host_data.id_rigid, shape_removed);
+  Thrust_Compact(host_data.convex_data, point_removed);
+
+  data_manager->num_rigid_shapes = host_data.id_rigid.size();
+
+  // The broadphase data kept between steps refers to the old shape indices
+  broadphase->Reset();
+  broadphase_sap->Reset();
+  pairs_valid = false;
+
+  LOG(TRACE) << "Removed shapes: " << num_shapes - data_manager->num_rigid_shapes;
+}
+
+void ChCollisionSystemParallel::ReorderShapes(const custom_vector<int>& body_map, custom_vector<int>& shape_map) {
+  host_container& host_data = data_manager->host_data;
+  uint num_shapes = data_manager->num_rigid_shapes;
+
+  // The shapes stay grouped by body and keep their order within a body, the
+  // sorted keys are the new body identifiers of the shapes
+  custom_vector<uint> shape_body(num_shapes);
+  custom_vector<int> shape_order(num_shapes);
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    shape_body[i] = body_map[host_data.id_rigid[i]];
+    shape_order[i] = i;
+  }
+  thrust::stable_sort_by_key(shape_body.begin(), shape_body.end(), shape_order.begin());
+
+  shape_map.resize(num_shapes);
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    shape_map[shape_order[i]] = i;
+  }
+
+  Thrust_Permute(host_data.ObA_rigid, shape_order);
+  Thrust_Permute(host_data.ObB_rigid, shape_order);
+  Thrust_Permute(host_data.ObC_rigid, shape_order);
+  Thrust_Permute(host_data.ObR_rigid, shape_order);
+  Thrust_Permute(host_data.fam_rigid, shape_order);
+  Thrust_Permute(host_data.margin_rigid, shape_order);
+  Thrust_Permute(host_data.typ_rigid, shape_order);
+  host_data.id_rigid = shape_body;
+
+  // The points of the convex shapes are stored again in the new shape order
+  custom_vector<uint> num_points(num_shapes);
+  custom_vector<uint> point_offset(num_shapes);
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    num_points[i] = host_data.typ_rigid[i] == CONVEX ? uint(host_data.ObB_rigid[i].x) : 0;
+  }
+  thrust::exclusive_scan(num_points.begin(), num_points.end(), point_offset.begin());
+
+  custom_vector<real3> convex_data(num_shapes > 0 ? point_offset[num_shapes - 1] + num_points[num_shapes - 1] : 0);
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    int start = int(host_data.ObB_rigid[i].y);
+    for (int j = 0; j < num_points[i]; j++) {
+      convex_data[point_offset[i] + j] = host_data.convex_data[start + j];
+    }
+    if (num_points[i] > 0) {
+      host_data.ObB_rigid[i].y = point_offset[i];
+    }
+  }
+  host_data.convex_data.swap(convex_data);
+
+  // The broadphase data kept between steps refers to the old shape indices
+  broadphase->Reset();
+  broadphase_sap->Reset();
+  pairs_valid = false;
 }
 
 void ChCollisionSystemParallel::Run() {
@@ -100,17 +223,75 @@ void ChCollisionSystemParallel::Run() {
     return;
   }
 
+  data_manager->SetPhaseThreads(PHASE_BROADPHASE);
   data_manager->system_timer.start("collision_broad");
-  aabb_generator->GenerateAABB();
-  broadphase->DetectPossibleCollisions();
+  // The bounding boxes are only grown by half of the skin when the pairs are
+  // reused, see PairsAreValid
+  real skin = data_manager->settings.collision.pair_reuse_skin;
+  bool reuse = skin > 0;
+  aabb_generator->GenerateAABB(reuse ? skin / 2 : 0);
+  if (PairsAreValid()) {
+    data_manager->host_data.pair_rigid_rigid = reuse_pairs;
+    data_manager->measures.collision.pairs_reused++;
+  } else {
+    // The broadphase moves the bounding boxes to the origin of its grid
+    if (reuse) {
+      reuse_aabb_min = data_manager->host_data.aabb_min_rigid;
+      reuse_aabb_max = data_manager->host_data.aabb_max_rigid;
+      reuse_active = data_manager->host_data.active_rigid;
+    }
+    switch (data_manager->settings.collision.broadphase_algorithm) {
+      case BROADPHASE_GRID:
+      case BROADPHASE_HIERARCHICAL_GRID:
+        broadphase->DetectPossibleCollisions();
+        break;
+      case BROADPHASE_SAP:
+        broadphase_sap->DetectPossibleCollisions();
+        break;
+    }
+    if (reuse) {
+      reuse_pairs = data_manager->host_data.pair_rigid_rigid;
+    }
+    pairs_valid = reuse;
+    data_manager->measures.collision.pairs_reused = 0;
+  }
   data_manager->system_timer.stop("collision_broad");
 
+  data_manager->SetPhaseThreads(PHASE_NARROWPHASE);
   data_manager->system_timer.start("collision_narrow");
   narrowphase->Process();
   data_manager->system_timer.stop("collision_narrow");
 }
 
+bool ChCollisionSystemParallel::PairsAreValid() {
+  const host_vector<real3>& aabb_min = data_manager->host_data.aabb_min_rigid;
+  const host_vector<real3>& aabb_max = data_manager->host_data.aabb_max_rigid;
+  real skin = data_manager->settings.collision.pair_reuse_skin;
+
+  if (!pairs_valid || skin <= 0 || reuse_aabb_min.size() != data_manager->num_rigid_shapes ||
+      reuse_active != data_manager->host_data.active_rigid) {
+    return false;
+  }
+
+  // The bounding boxes were grown by half of the skin, the pairs stay valid as
+  // long as no corner of a bounding box moved by more than that
+  real max_move = skin / 2;
+  int num_moved = 0;
+#pragma omp parallel for reduction(+ : num_moved)
+  for (int i = 0; i < reuse_aabb_min.size(); i++) {
+    real3 move_min = aabb_min[i] - reuse_aabb_min[i];
+    real3 move_max = aabb_max[i] - reuse_aabb_max[i];
+    real move = std::max(std::max(std::max(fabs(move_min.x), fabs(move_min.y)), fabs(move_min.z)),
+                         std::max(std::max(fabs(move_max.x), fabs(move_max.y)), fabs(move_max.z)));
+    num_moved += (move > max_move);
+  }
+
+  LOG(TRACE) << "Shapes moved past the skin: " << num_moved;
+  return num_moved == 0;
+}
+
 void ChCollisionSystemParallel::GetOverlappingAABB(custom_vector<bool>& active_id, real3 Amin, real3 Amax) {
+  // The active region is tested against the bounding boxes without the skin
   aabb_generator->GenerateAABB();
 #pragma omp parallel for
   for (int i = 0; i < data_manager->host_data.typ_rigid.size(); i++) {
@@ -13,6 +13,7 @@
 #include "chrono_parallel/collision/ChCAABBGenerator.h"
 #include "chrono_parallel/collision/ChCNarrowphaseDispatch.h"
 #include "chrono_parallel/collision/ChCBroadphase.h"
+#include "chrono_parallel/collision/ChCBroadphaseSAP.h"
 
 namespace chrono {
 
@@ -39,8 +40,24 @@ class CH_PARALLEL_API ChCollisionSystemParallel : public ChCollisionSystem {
 
   /// Removes a collision model from the collision
   /// engine (custom data may be deallocated).
+  /// The shapes are only marked for removal, they are dropped in batch by
+  /// RemoveShapes() at the start of the next step.
   virtual void Remove(ChCollisionModel* model);
 
+  /// Drop the shapes of the models removed since the last call and compact the
+  /// shape arrays. body_map holds the new index of every body (-1 for removed
+  /// bodies) and is used to renumber the bodies of the remaining shapes. On
+  /// return shape_map holds the new index of every shape, -1 for removed shapes.
+  void RemoveShapes(const custom_vector<int>& body_map, custom_vector<int>& shape_map);
+
+  /// Move the shapes to follow the new order of their bodies, body_map holds
+  /// the new index of every body. On return shape_map holds the new index of
+  /// every shape.
+  void ReorderShapes(const custom_vector<int>& body_map, custom_vector<int>& shape_map);
+
+  /// Check if some models were removed since the last call to RemoveShapes()
+  bool HasRemovedShapes() const { return removed_models.size() > 0; }
+
   /// Removes all collision models from the collision
   /// engine (custom data may be deallocated).
   // virtual void RemoveAll();
@@ -90,12 +107,28 @@ class CH_PARALLEL_API ChCollisionSystemParallel : public ChCollisionSystem {
 
  private:
   ChCBroadphase* broadphase;
+  ChCBroadphaseSAP* broadphase_sap;
   ChCNarrowphaseDispatch* narrowphase;
 
   ChCAABBGenerator* aabb_generator;
 
   ChParallelDataManager* data_manager;
 
+  // Body of every removed model and the number of shapes at the time it was
+  // removed, shapes added to the same body afterwards are kept
+  custom_vector<int2> removed_models;
+
+  // True if the bounding boxes of the shapes are still close enough to the
+  // ones used by the last broadphase to reuse its list of pairs
+  bool PairsAreValid();
+
+  // List of pairs found by the last broadphase along with the bounding boxes
+  // and active flags it was computed from, see pair_reuse_skin
+  bool pairs_valid;
+  custom_vector<long long> reuse_pairs;
+  custom_vector<real3> reuse_aabb_min, reuse_aabb_max;
+  custom_vector<bool> reuse_active;
+
   friend class chrono::ChSystemParallel;
 };
 
@@ -4,7 +4,9 @@
 #include "chrono_parallel/ChConfigParallel.h"
 #include "chrono_parallel/constraints/ChConstraintRigidRigid.h"
 #include "chrono_parallel/math/quartic.h"
+#include <thrust/binary_search.h>
 #include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
 
 using namespace chrono;
 
@@ -248,6 +250,236 @@ void chrono::Compute_Jacobian_Rolling(const real4& quat,
   T3 = quatRotate(W, quaternion_conjugate);
 }
 
+// Compute the jacobian blocks of a contact, these are the same values that
+// Build_D stores in the rows of D_n_T, D_t_T and D_s_T
+static inline void function_Contact_Jacobian(const int index,
+                                             const real3* norm,
+                                             const real3* ptA,
+                                             const real3* ptB,
+                                             const real3* pos_data,
+                                             const real4* rot,
+                                             const int2* ids,
+                                             real3& U,
+                                             real3& V,
+                                             real3& W,
+                                             real3& T3,
+                                             real3& T4,
+                                             real3& T5,
+                                             real3& T6,
+                                             real3& T7,
+                                             real3& T8) {
+  U = norm[index];
+  Orthogonalize(U, V, W);
+  int2 body_id = ids[index];
+  Compute_Jacobian(rot[body_id.x], U, V, W, ptA[index] - pos_data[body_id.x], T3, T4, T5);
+  Compute_Jacobian(rot[body_id.y], U, V, W, ptB[index] - pos_data[body_id.y], T6, T7, T8);
+}
+
+// Read the jacobian blocks of a contact from block storage, or compute them
+// when there is no storage
+#define CONTACT_JACOBIAN(index)                                                                            \
+  if (blocks) {                                                                                            \
+    U = block_uvw[index * 3 + 0];                                                                          \
+    V = block_uvw[index * 3 + 1];                                                                          \
+    W = block_uvw[index * 3 + 2];                                                                          \
+    T3 = block_angular_a[index * 3 + 0];                                                                   \
+    T4 = block_angular_a[index * 3 + 1];                                                                   \
+    T5 = block_angular_a[index * 3 + 2];                                                                   \
+    T6 = block_angular_b[index * 3 + 0];                                                                   \
+    T7 = block_angular_b[index * 3 + 1];                                                                   \
+    T8 = block_angular_b[index * 3 + 2];                                                                   \
+  } else {                                                                                                 \
+    function_Contact_Jacobian(index, norm, ptA, ptB, pos_data, rot, ids, U, V, W, T3, T4, T5, T6, T7, T8); \
+  }
+
+void ChConstraintRigidRigid::GenerateBodyContacts() {
+  LOG(INFO) << "ChConstraintRigidRigid::GenerateBodyContacts";
+  const int2* ids = data_manager->host_data.bids_rigid_rigid.data();
+  uint num_contacts = data_manager->num_rigid_contacts;
+  uint num_bodies = data_manager->num_rigid_bodies;
+
+  body_contacts.resize(num_contacts * 2);
+  body_contact_id.resize(num_contacts * 2);
+  body_contact_start.resize(num_bodies + 1);
+
+#pragma omp parallel for
+  for (int index = 0; index < num_contacts; index++) {
+    body_contact_id[index * 2 + 0] = ids[index].x;
+    body_contact_id[index * 2 + 1] = ids[index].y;
+    body_contacts[index * 2 + 0] = index * 2 + 0;
+    body_contacts[index * 2 + 1] = index * 2 + 1;
+  }
+
+  Thrust_Sort_By_Key(body_contact_id, body_contacts);
+  thrust::lower_bound(body_contact_id.begin(), body_contact_id.end(), thrust::counting_iterator<uint>(0),
+                      thrust::counting_iterator<uint>(num_bodies + 1), body_contact_start.begin());
+}
+
+void ChConstraintRigidRigid::Build_Blocks() {
+  LOG(INFO) << "ChConstraintRigidRigid::Build_Blocks";
+  const real3* norm = data_manager->host_data.norm_rigid_rigid.data();
+  const real3* ptA = data_manager->host_data.cpta_rigid_rigid.data();
+  const real3* ptB = data_manager->host_data.cptb_rigid_rigid.data();
+  const real3* pos_data = data_manager->host_data.pos_rigid.data();
+  const real4* rot = data_manager->host_data.rot_rigid.data();
+  const int2* ids = data_manager->host_data.bids_rigid_rigid.data();
+  SOLVERMODE solver_mode = data_manager->settings.solver.solver_mode;
+  uint num_contacts = data_manager->num_rigid_contacts;
+
+  block_uvw.resize(num_contacts * 3);
+  block_angular_a.resize(num_contacts * 3);
+  block_angular_b.resize(num_contacts * 3);
+  block_rolling_a.resize(solver_mode == SPINNING ? num_contacts * 3 : 0);
+  block_rolling_b.resize(solver_mode == SPINNING ? num_contacts * 3 : 0);
+
+#pragma omp parallel for
+  for (int index = 0; index < num_contacts; index++) {
+    real3 U, V, W, T3, T4, T5, T6, T7, T8;
+    function_Contact_Jacobian(index, norm, ptA, ptB, pos_data, rot, ids, U, V, W, T3, T4, T5, T6, T7, T8);
+
+    block_uvw[index * 3 + 0] = U;
+    block_uvw[index * 3 + 1] = V;
+    block_uvw[index * 3 + 2] = W;
+    block_angular_a[index * 3 + 0] = T3;
+    block_angular_a[index * 3 + 1] = T4;
+    block_angular_a[index * 3 + 2] = T5;
+    block_angular_b[index * 3 + 0] = T6;
+    block_angular_b[index * 3 + 1] = T7;
+    block_angular_b[index * 3 + 2] = T8;
+
+    if (solver_mode == SPINNING) {
+      int2 body_id = ids[index];
+      Compute_Jacobian_Rolling(rot[body_id.x], U, V, W, block_rolling_a[index * 3 + 0],
+                               block_rolling_a[index * 3 + 1], block_rolling_a[index * 3 + 2]);
+      Compute_Jacobian_Rolling(rot[body_id.y], U, V, W, block_rolling_b[index * 3 + 0],
+                               block_rolling_b[index * 3 + 1], block_rolling_b[index * 3 + 2]);
+    }
+  }
+}
+
+void ChConstraintRigidRigid::Apply_D_T(SOLVERMODE mode, const DynamicVector<real>& v, DynamicVector<real>& output) {
+  const real3* norm = data_manager->host_data.norm_rigid_rigid.data();
+  const real3* ptA = data_manager->host_data.cpta_rigid_rigid.data();
+  const real3* ptB = data_manager->host_data.cptb_rigid_rigid.data();
+  const real3* pos_data = data_manager->host_data.pos_rigid.data();
+  const real4* rot = data_manager->host_data.rot_rigid.data();
+  const int2* ids = data_manager->host_data.bids_rigid_rigid.data();
+  const bool blocks = data_manager->settings.solver.jacobian_storage == JACOBIAN_BLOCK;
+  uint num_contacts = data_manager->num_rigid_contacts;
+
+#pragma omp parallel for
+  for (int index = 0; index < num_contacts; index++) {
+    real3 U, V, W, T3, T4, T5, T6, T7, T8;
+    CONTACT_JACOBIAN(index)
+    int2 body_id = ids[index];
+
+    real3 vA = R3(v[body_id.x * 6 + 0], v[body_id.x * 6 + 1], v[body_id.x * 6 + 2]);
+    real3 oA = R3(v[body_id.x * 6 + 3], v[body_id.x * 6 + 4], v[body_id.x * 6 + 5]);
+    real3 vB = R3(v[body_id.y * 6 + 0], v[body_id.y * 6 + 1], v[body_id.y * 6 + 2]);
+    real3 oB = R3(v[body_id.y * 6 + 3], v[body_id.y * 6 + 4], v[body_id.y * 6 + 5]);
+    real3 vAB = vB - vA;
+
+    output[index] = dot(U, vAB) + dot(T3, oA) - dot(T6, oB);
+
+    if (mode == SLIDING || mode == SPINNING) {
+      output[num_contacts + index * 2 + 0] = dot(V, vAB) + dot(T4, oA) - dot(T7, oB);
+      output[num_contacts + index * 2 + 1] = dot(W, vAB) + dot(T5, oA) - dot(T8, oB);
+    }
+
+    if (mode == SPINNING) {
+      real3 TA, TB, TC, TD, TE, TF;
+      if (blocks) {
+        TA = block_rolling_a[index * 3 + 0];
+        TB = block_rolling_a[index * 3 + 1];
+        TC = block_rolling_a[index * 3 + 2];
+        TD = block_rolling_b[index * 3 + 0];
+        TE = block_rolling_b[index * 3 + 1];
+        TF = block_rolling_b[index * 3 + 2];
+      } else {
+        Compute_Jacobian_Rolling(rot[body_id.x], U, V, W, TA, TB, TC);
+        Compute_Jacobian_Rolling(rot[body_id.y], U, V, W, TD, TE, TF);
+      }
+
+      output[3 * num_contacts + index * 3 + 0] = dot(TD, oB) - dot(TA, oA);
+      output[3 * num_contacts + index * 3 + 1] = dot(TE, oB) - dot(TB, oA);
+      output[3 * num_contacts + index * 3 + 2] = dot(TF, oB) - dot(TC, oA);
+    }
+  }
+}
+
+void ChConstraintRigidRigid::Apply_D(SOLVERMODE mode, const DynamicVector<real>& x, DynamicVector<real>& output) {
+  const real3* norm = data_manager->host_data.norm_rigid_rigid.data();
+  const real3* ptA = data_manager->host_data.cpta_rigid_rigid.data();
+  const real3* ptB = data_manager->host_data.cptb_rigid_rigid.data();
+  const real3* pos_data = data_manager->host_data.pos_rigid.data();
+  const real4* rot = data_manager->host_data.rot_rigid.data();
+  const int2* ids = data_manager->host_data.bids_rigid_rigid.data();
+  const bool blocks = data_manager->settings.solver.jacobian_storage == JACOBIAN_BLOCK;
+  uint num_contacts = data_manager->num_rigid_contacts;
+  uint num_bodies = data_manager->num_rigid_bodies;
+
+  output.resize(data_manager->num_dof);
+  reset(output);
+
+  // Every body gathers the contributions of its own contacts so that no two
+  // threads write to the same entries, this is the transpose product without
+  // storing the transpose
+#pragma omp parallel for schedule(dynamic, 64)
+  for (int body = 0; body < num_bodies; body++) {
+    real3 force = R3(0), torque = R3(0);
+
+    for (uint k = body_contact_start[body]; k < body_contact_start[body + 1]; k++) {
+      int index = body_contacts[k] / 2;
+      bool first = (body_contacts[k] % 2) == 0;
+
+      real3 U, V, W, T3, T4, T5, T6, T7, T8;
+      CONTACT_JACOBIAN(index)
+
+      real gamma_n = x[index];
+      real gamma_u = 0, gamma_v = 0;
+      if (mode == SLIDING || mode == SPINNING) {
+        gamma_u = x[num_contacts + index * 2 + 0];
+        gamma_v = x[num_contacts + index * 2 + 1];
+      }
+      real3 f = U * gamma_n + V * gamma_u + W * gamma_v;
+
+      if (first) {
+        force -= f;
+        torque += T3 * gamma_n + T4 * gamma_u + T5 * gamma_v;
+      } else {
+        force += f;
+        torque -= T6 * gamma_n + T7 * gamma_u + T8 * gamma_v;
+      }
+
+      if (mode == SPINNING) {
+        real3 TR1, TR2, TR3;
+        if (blocks) {
+          const custom_vector<real3>& rolling = first ? block_rolling_a : block_rolling_b;
+          TR1 = rolling[index * 3 + 0];
+          TR2 = rolling[index * 3 + 1];
+          TR3 = rolling[index * 3 + 2];
+        } else {
+          Compute_Jacobian_Rolling(rot[body], U, V, W, TR1, TR2, TR3);
+        }
+        real3 t = TR1 * x[3 * num_contacts + index * 3 + 0] + TR2 * x[3 * num_contacts + index * 3 + 1] +
+                  TR3 * x[3 * num_contacts + index * 3 + 2];
+        if (first) {
+          torque -= t;
+        } else {
+          torque += t;
+        }
+      }
+    }
+
+    output[body * 6 + 0] = force.x;
+    output[body * 6 + 1] = force.y;
+    output[body * 6 + 2] = force.z;
+    output[body * 6 + 3] = torque.x;
+    output[body * 6 + 4] = torque.y;
+    output[body * 6 + 5] = torque.z;
+  }
+}
+
 void ChConstraintRigidRigid::Build_b() {
   if (data_manager->num_rigid_contacts <= 0) {
     return;
@@ -282,7 +514,6 @@ void ChConstraintRigidRigid::Build_s() {
 
   int2* ids = data_manager->host_data.bids_rigid_rigid.data();
   const CompressedMatrix<real>& D_t_T = data_manager->host_data.D_t_T;
-  DynamicVector<real> v_new;
 
   const DynamicVector<real>& M_invk = data_manager->host_data.M_invk;
   const DynamicVector<real>& gamma = data_manager->host_data.gamma;
@@ -299,6 +530,25 @@ void ChConstraintRigidRigid::Build_s() {
   ConstSubVectorType gamma_b = blaze::subvector(gamma, num_unilaterals, num_bilaterals);
   ConstSubVectorType gamma_n = blaze::subvector(gamma, 0, num_contacts);
 
+  if (data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+    SOLVERMODE solver_mode = data_manager->settings.solver.solver_mode;
+    D_T_v.resize(data_manager->num_constraints);
+
+    Apply_D(solver_mode, gamma, D_gamma);
+    v_new = M_invk + M_inv * D_gamma + M_invD_b * gamma_b;
+    Apply_D_T(SLIDING, v_new, D_T_v);
+
+#pragma omp parallel for
+    for (int index = 0; index < num_contacts; index++) {
+      real fric = data_manager->host_data.fric_rigid_rigid[index].x;
+      real s_v = D_T_v[num_contacts + index * 2 + 0];
+      real s_w = D_T_v[num_contacts + index * 2 + 1];
+      data_manager->host_data.s[index * 1 + 0] = sqrt(s_v * s_v + s_w * s_w) * fric;
+    }
+    return;
+  }
+
   // Compute new velocity based on the lagrange multipliers
   switch (data_manager->settings.solver.solver_mode) {
     case NORMAL: {
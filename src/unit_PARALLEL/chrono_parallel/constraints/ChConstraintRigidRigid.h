@@ -95,11 +95,44 @@ class CH_PARALLEL_API ChConstraintRigidRigid {
   // Fill-in the non zero entries in the bilateral jacobian with ones.
   // This operation is sequential.
   void GenerateSparsity();
+
+  // Products with the contact jacobian used instead of D_n_T, D_t_T and D_s_T
+  // when the jacobians are not assembled (see solver.jacobian_storage).
+  // Build the list of contacts acting on each body, needed by Apply_D
+  void GenerateBodyContacts();
+  // Compute and store the dense jacobian blocks of every contact
+  void Build_Blocks();
+  // output = D^T * v for the constraints used in the given solver mode, the
+  // entries are stored at the same offsets as in the constraint vector
+  void Apply_D_T(SOLVERMODE mode, const DynamicVector<real>& v, DynamicVector<real>& output);
+  // output = D * x, using the constraints of the given solver mode. The output
+  // has one entry per degree of freedom
+  void Apply_D(SOLVERMODE mode, const DynamicVector<real>& x, DynamicVector<real>& output);
   int offset;
 
  protected:
   custom_vector<bool2> contact_active_pairs;
 
+  // Contacts sorted by body, each entry is contact * 2 + 0 for the first body
+  // of the contact and contact * 2 + 1 for the second one
+  custom_vector<uint> body_contacts;
+  custom_vector<uint> body_contact_id;
+  custom_vector<uint> body_contact_start;
+
+  // Jacobian blocks of each contact in block storage mode. The linear part
+  // is the same for both bodies up to the sign, so it is only stored once.
+  custom_vector<real3> block_uvw;        // Normal and tangent directions, 3 per contact
+  custom_vector<real3> block_angular_a;  // Angular terms of the first body, 3 per contact
+  custom_vector<real3> block_angular_b;  // Angular terms of the second body, 3 per contact
+  custom_vector<real3> block_rolling_a;  // Rolling terms of the first body, 3 per contact
+  custom_vector<real3> block_rolling_b;  // Rolling terms of the second body, 3 per contact
+
+  // Work vectors of Build_s, kept between calls so that every iteration of the
+  // solver reuses their storage
+  DynamicVector<real> D_gamma;  // D * gamma
+  DynamicVector<real> v_new;    // Velocity from the current lagrange multipliers
+  DynamicVector<real> D_T_v;    // D^T * v_new
+
   real inv_h;
   real inv_hpa;
   real inv_hhpa;
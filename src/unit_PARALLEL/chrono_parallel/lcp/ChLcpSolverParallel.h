@@ -46,6 +46,10 @@ class CH_PARALLEL_API ChLcpSolverParallel : public ChLcpIterativeSolver {
   void ComputeMassMatrix();
   // Solves just the bilaterals so that they can be warm started
   void PerformStabilization();
+  // Renumber the data kept from the previous step that refers to shapes, after
+  // shapes were removed. shape_map holds the new index of every shape, -1 for
+  // the removed ones.
+  virtual void RemapShapes(const custom_vector<int>& shape_map) {}
 
   real GetResidual() { return residual; }
   ChParallelDataManager* data_manager;
@@ -60,7 +64,7 @@ class CH_PARALLEL_API ChLcpSolverParallel : public ChLcpIterativeSolver {
 
 class CH_PARALLEL_API ChLcpSolverParallelDVI : public ChLcpSolverParallel {
  public:
-  ChLcpSolverParallelDVI(ChParallelDataManager* dc) : ChLcpSolverParallel(dc) {}
+  ChLcpSolverParallelDVI(ChParallelDataManager* dc) : ChLcpSolverParallel(dc), previous_mode(NORMAL) {}
 
   virtual void RunTimeStep();
   virtual void ComputeImpulses();
@@ -79,9 +83,23 @@ class CH_PARALLEL_API ChLcpSolverParallelDVI : public ChLcpSolverParallel {
   void PreSolve();
   // This function is used to change the solver algorithm.
   void ChangeSolverType(SOLVERTYPE type);
+  // Access to the rigid contact constraints, used to apply the contact
+  // jacobian when it is not assembled
+  ChConstraintRigidRigid& GetRigidRigid() { return rigid_rigid; }
+  // Initialize the multipliers of the contacts that also existed in the
+  // previous step with the values computed in that step
+  void WarmStartContacts();
+  // The contacts of the previous step are not warm started after shapes were
+  // removed
+  virtual void RemapShapes(const custom_vector<int>& shape_map);
 
  private:
   ChConstraintRigidRigid rigid_rigid;
+
+  // Contact pairs and multipliers from the previous step, used for warm starting
+  custom_vector<long long> previous_pairs;
+  DynamicVector<real> previous_gamma;
+  SOLVERMODE previous_mode;
 };
 
 class CH_PARALLEL_API ChLcpSolverParallelDEM : public ChLcpSolverParallel {
@@ -100,12 +118,22 @@ class CH_PARALLEL_API ChLcpSolverParallelDEM : public ChLcpSolverParallel {
 
   void ProcessContacts();
 
+  // Rebuild the contact history table with the new shape indices
+  virtual void RemapShapes(const custom_vector<int>& shape_map);
+
  private:
   void host_CalcContactForces(custom_vector<int>& ext_body_id,
                               custom_vector<real3>& ext_body_force,
                               custom_vector<real3>& ext_body_torque,
-                              custom_vector<int2>& shape_pairs,
-                              custom_vector<bool>& shear_touch);
+                              custom_vector<bool>& shear_touch,
+                              custom_vector<real3>& shear_disp);
+
+  // Contact history for the MULTI_STEP tangential displacement mode
+  void host_LoadShearHistory(custom_vector<int>& shear_occurrence, custom_vector<real3>& shear_disp);
+  void host_StoreShearHistory(const custom_vector<long long>& pairs,
+                              const custom_vector<int>& shear_occurrence,
+                              const custom_vector<bool>& shear_touch,
+                              const custom_vector<real3>& shear_disp);
 
   void host_AddContactForces(uint ct_body_count, const custom_vector<int>& ct_body_id);
 
@@ -22,6 +22,12 @@
 
 #include "chrono_parallel/lcp/ChLcpSolverParallel.h"
 
+#include <thrust/scan.h>
+#include <thrust/functional.h>
+#include <thrust/binary_search.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <algorithm>
+
 using namespace chrono;
 
 // -----------------------------------------------------------------------------
@@ -49,15 +55,13 @@ void function_CalcContactForces(
     real* mu,                               // coefficient of friction (per body)
     real* cohesion,                         // cohesion force (per body)
     int2* body_id,                          // body IDs (per contact)
-    int2* shape_id,                         // shape IDs (per contact)
     real3* pt1,                             // point on shape 1 (per contact)
     real3* pt2,                             // point on shape 2 (per contact)
     real3* normal,                          // contact normal (per contact)
     real* depth,                            // penetration depth (per contact)
     real* eff_radius,                       // effective contact radius (per contact)
-    int3* shear_neigh,                      // neighbor list of contacting bodies and shapes (max_shear per body)
-    bool* shear_touch,                      // flag if contact in neighbor list is persistent (max_shear per body)
-    real3* shear_disp,                      // accumulated shear displacement for each neighbor (max_shear per body)
+    bool* shear_touch,                      // flag if the contact history is kept (per contact)
+    real3* shear_disp,                      // accumulated shear displacement (per contact)
     int* ext_body_id,                       // [output] body IDs (two per contact)
     real3* ext_body_force,                  // [output] body force (two per contact)
     real3* ext_body_torque)                 // [output] body torque (two per contact)
@@ -152,13 +156,7 @@ void function_CalcContactForces(
   real delta_n = -depth[index];
   real3 delta_t = R3(0, 0, 0);
 
-  int i;
-  int contact_id;
   int shear_body1;
-  int shear_body2;
-  int shear_shape1;
-  int shear_shape2;
-  bool newcontact = true;
 
   if (displ_mode == ONE_STEP) {
     delta_t = relvel_t * dT;
@@ -166,64 +164,26 @@ void function_CalcContactForces(
   } else if (displ_mode == MULTI_STEP) {
     delta_t = relvel_t * dT;
 
-    // Contact history information should be stored on the body with
-    // the smaller shape in contact or the body with larger index.
-    // Currently, it is assumed that the smaller shape is on the body
-    // with larger ID.
+    // The contact history was looked up before this function was called, the
+    // shear displacement is stored relative to the body with larger index.
     // We call this body shear_body1.
-    int shape1 = shape_id[index].x;
-    int shape2 = shape_id[index].y;
-
     shear_body1 = std::max(body1, body2);
-    shear_body2 = std::min(body1, body2);
-    shear_shape1 = std::max(shape1, shape2);
-    shear_shape2 = std::min(shape1, shape2);
-
-    // Check if contact history already exists.
-    // If not, initialize new contact history.
-    for (i = 0; i < max_shear; i++) {
-      if (shear_neigh[max_shear * shear_body1 + i].x == shear_body2
-        && shear_neigh[max_shear * shear_body1 + i].y == shear_shape1
-        && shear_neigh[max_shear * shear_body1 + i].z == shear_shape2) {
-        contact_id = i;
-        newcontact = false;
-        break;
-      }
-    }
-    if (newcontact == true) {
-      for (i = 0; i < max_shear; i++) {
-        if (shear_neigh[max_shear * shear_body1 + i].x == -1) {
-          contact_id = i;
-          shear_neigh[max_shear * shear_body1 + i].x = shear_body2;
-          shear_neigh[max_shear * shear_body1 + i].y = shear_shape1;
-          shear_neigh[max_shear * shear_body1 + i].z = shear_shape2;
-          shear_disp[max_shear * shear_body1 + i].x = 0;
-          shear_disp[max_shear * shear_body1 + i].y = 0;
-          shear_disp[max_shear * shear_body1 + i].z = 0;
-          break;
-        }
-      }
-    }
 
     // Record that these two bodies are really in contact at this time.
-    shear_touch[max_shear * shear_body1 + contact_id] = true;
+    shear_touch[index] = true;
 
     // Increment stored contact history tangential (shear) displacement vector
     // and project it onto the <current> contact plane.
 
     if (shear_body1 == body1) {
-      shear_disp[max_shear * shear_body1 + contact_id] += delta_t;
-      shear_disp[max_shear * shear_body1 + contact_id] -=
-        dot(shear_disp[max_shear * shear_body1 + contact_id], normal[index])
-        * normal[index];
-      delta_t = shear_disp[max_shear * shear_body1 + contact_id];
+      shear_disp[index] += delta_t;
+      shear_disp[index] -= dot(shear_disp[index], normal[index]) * normal[index];
+      delta_t = shear_disp[index];
     }
     else {
-      shear_disp[max_shear * shear_body1 + contact_id] -= delta_t;
-      shear_disp[max_shear * shear_body1 + contact_id] -=
-        dot(shear_disp[max_shear * shear_body1 + contact_id], normal[index])
-        * normal[index];
-      delta_t = -shear_disp[max_shear * shear_body1 + contact_id];
+      shear_disp[index] -= delta_t;
+      shear_disp[index] -= dot(shear_disp[index], normal[index]) * normal[index];
+      delta_t = -shear_disp[index];
     }
   }
 
@@ -315,9 +275,9 @@ void function_CalcContactForces(
       forceT_stiff *= ratio;
       if (displ_mode == MULTI_STEP) {
         if (shear_body1 == body1) {
-          shear_disp[max_shear * shear_body1 + contact_id] = forceT_stiff / kt;
+          shear_disp[index] = forceT_stiff / kt;
         } else {
-          shear_disp[max_shear * shear_body1 + contact_id] = -forceT_stiff / kt;
+          shear_disp[index] = -forceT_stiff / kt;
         }
       }
     } else {
@@ -352,14 +312,165 @@ void function_CalcContactForces(
   ext_body_torque[2 * index + 1] = torque2_loc;
 }
 
+// -----------------------------------------------------------------------------
+// Contact history hash table. The history of a contact is keyed by its shape
+// pair and by its occurrence, the index of the contact among the contacts
+// reported for the same pair. The table is rebuilt every step from the
+// contacts that are touching, so it only holds live contacts.
+// -----------------------------------------------------------------------------
+
+// Fibonacci hashing of a shape pair into a table with 2^bits slots
+static inline uint function_Shear_Hash(long long pair, uint bits) {
+  unsigned long long hash = (unsigned long long)pair * 0x9E3779B97F4A7C15ULL;
+  return bits == 0 ? 0 : (uint)(hash >> (64 - bits));
+}
+
+// Number of bits of the table addressed by the hash, the table is at least
+// twice as large as the number of entries to keep the probe sequences short
+static inline uint function_Shear_Bits(uint num_entries) {
+  uint bits = 4;
+  while ((1u << bits) < 2 * num_entries) {
+    bits++;
+  }
+  return bits;
+}
+
+// Find the shear displacement of a contact, zero if it is a new contact
+static inline real3 function_Shear_Lookup(long long pair,
+                                          int occurrence,
+                                          const long long* table_pair,
+                                          const int* table_occurrence,
+                                          const real3* table_disp,
+                                          uint table_size) {
+  if (table_size == 0) {
+    return R3(0, 0, 0);
+  }
+  // The hashed half of the table has 2^bits slots
+  uint bits = 0;
+  while ((2u << bits) < table_size) {
+    bits++;
+  }
+  for (uint slot = function_Shear_Hash(pair, bits); slot < table_size && table_pair[slot] != -1; slot++) {
+    if (table_pair[slot] == pair && table_occurrence[slot] == occurrence) {
+      return table_disp[slot];
+    }
+  }
+  return R3(0, 0, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Copy the shear displacement of every contact from the table built in the
+// previous step.
+// -----------------------------------------------------------------------------
+void ChLcpSolverParallelDEM::host_LoadShearHistory(custom_vector<int>& shear_occurrence,
+                                                   custom_vector<real3>& shear_disp) {
+  const custom_vector<long long>& pairs = data_manager->host_data.pair_rigid_rigid;
+  const custom_vector<long long>& table_pair = data_manager->host_data.shear_pair;
+  const custom_vector<int>& table_occurrence = data_manager->host_data.shear_occurrence;
+  const custom_vector<real3>& table_disp = data_manager->host_data.shear_disp;
+
+#pragma omp parallel for
+  for (int index = 0; index < data_manager->num_rigid_contacts; index++) {
+    // The contacts of a pair are next to each other in the sorted pair list
+    int occurrence = 0;
+    while (occurrence < index && pairs[index - occurrence - 1] == pairs[index]) {
+      occurrence++;
+    }
+    shear_occurrence[index] = occurrence;
+    shear_disp[index] = function_Shear_Lookup(pairs[index], occurrence, table_pair.data(), table_occurrence.data(),
+                                              table_disp.data(), table_pair.size());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Rebuild the table from the contacts that are touching. The entries are
+// sorted by their home slot and placed with linear probing, the slot of the
+// k-th entry is max(home_j - j, j <= k) + k which is computed with a scan so
+// that no atomic operations are needed.
+// -----------------------------------------------------------------------------
+void ChLcpSolverParallelDEM::host_StoreShearHistory(const custom_vector<long long>& pairs,
+                                                    const custom_vector<int>& shear_occurrence,
+                                                    const custom_vector<bool>& shear_touch,
+                                                    const custom_vector<real3>& shear_disp) {
+  custom_vector<long long>& table_pair = data_manager->host_data.shear_pair;
+  custom_vector<int>& table_occurrence = data_manager->host_data.shear_occurrence;
+  custom_vector<real3>& table_disp = data_manager->host_data.shear_disp;
+  uint num_contacts = pairs.size();
+
+  uint num_entries = Thrust_Count(shear_touch, true);
+  uint bits = function_Shear_Bits(num_entries);
+  uint table_size = 2 * (1u << bits);
+
+  // Contacts that are not kept are sorted past the end of the table
+  custom_vector<int> home(num_contacts);
+  custom_vector<uint> entry(num_contacts);
+#pragma omp parallel for
+  for (int index = 0; index < num_contacts; index++) {
+    home[index] = shear_touch[index] ? function_Shear_Hash(pairs[index], bits) : table_size;
+    entry[index] = index;
+  }
+  Thrust_Sort_By_Key(home, entry);
+
+#pragma omp parallel for
+  for (int k = 0; k < num_entries; k++) {
+    home[k] -= k;
+  }
+  thrust::inclusive_scan(home.begin(), home.begin() + num_entries, home.begin(), thrust::maximum<int>());
+
+  table_pair.resize(table_size);
+  table_occurrence.resize(table_size);
+  table_disp.resize(table_size);
+  thrust::fill(thrust_parallel, table_pair.begin(), table_pair.end(), -1);
+
+#pragma omp parallel for
+  for (int k = 0; k < num_entries; k++) {
+    uint slot = home[k] + k;
+    uint index = entry[k];
+    table_pair[slot] = pairs[index];
+    table_occurrence[slot] = shear_occurrence[index];
+    table_disp[slot] = shear_disp[index];
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Renumber the shapes of the entries in the table after shapes were removed.
+// The hash of an entry changes with its pair, so the table is built again from
+// its own entries, the entries of removed shapes are dropped.
+// -----------------------------------------------------------------------------
+void ChLcpSolverParallelDEM::RemapShapes(const custom_vector<int>& shape_map) {
+  uint table_size = data_manager->host_data.shear_pair.size();
+  custom_vector<long long> pairs(table_size);
+  custom_vector<int> shear_occurrence = data_manager->host_data.shear_occurrence;
+  custom_vector<bool> shear_touch(table_size);
+  custom_vector<real3> shear_disp = data_manager->host_data.shear_disp;
+
+#pragma omp parallel for
+  for (int slot = 0; slot < table_size; slot++) {
+    long long pair = data_manager->host_data.shear_pair[slot];
+    int shapeA = pair == -1 ? -1 : shape_map[int(pair >> 32)];
+    int shapeB = pair == -1 ? -1 : shape_map[int(pair & 0xffffffff)];
+    shear_touch[slot] = (shapeA != -1 && shapeB != -1);
+    // Reordering the bodies can swap the two shapes of a pair. The shapes are
+    // grouped by body, so the displacement that is stored relative to the body
+    // with the larger index changes sign.
+    if (shear_touch[slot] && shapeA > shapeB) {
+      std::swap(shapeA, shapeB);
+      shear_disp[slot] = -shear_disp[slot];
+    }
+    pairs[slot] = shear_touch[slot] ? ((long long)shapeA << 32 | (long long)shapeB) : -1;
+  }
+
+  host_StoreShearHistory(pairs, shear_occurrence, shear_touch, shear_disp);
+}
+
 // -----------------------------------------------------------------------------
 // Calculate contact forces and torques for all contact pairs.
 // -----------------------------------------------------------------------------
 void ChLcpSolverParallelDEM::host_CalcContactForces(custom_vector<int>& ext_body_id,
                                                     custom_vector<real3>& ext_body_force,
                                                     custom_vector<real3>& ext_body_torque,
-                                                    custom_vector<int2>& shape_pairs,
-                                                    custom_vector<bool>& shear_touch) {
+                                                    custom_vector<bool>& shear_touch,
+                                                    custom_vector<real3>& shear_disp) {
 #pragma omp parallel for
   for (int index = 0; index < data_manager->num_rigid_contacts; index++) {
     function_CalcContactForces(index,
@@ -379,15 +490,13 @@ void ChLcpSolverParallelDEM::host_CalcContactForces(custom_vector<int>& ext_body
                                data_manager->host_data.mu.data(),
                                data_manager->host_data.cohesion_data.data(),
                                data_manager->host_data.bids_rigid_rigid.data(),
-                               shape_pairs.data(),
                                data_manager->host_data.cpta_rigid_rigid.data(),
                                data_manager->host_data.cptb_rigid_rigid.data(),
                                data_manager->host_data.norm_rigid_rigid.data(),
                                data_manager->host_data.dpth_rigid_rigid.data(),
                                data_manager->host_data.erad_rigid_rigid.data(),
-                               data_manager->host_data.shear_neigh.data(),
                                shear_touch.data(),
-                               data_manager->host_data.shear_disp.data(),
+                               shear_disp.data(),
                                ext_body_id.data(),
                                ext_body_force.data(),
                                ext_body_torque.data());
@@ -442,67 +551,110 @@ void ChLcpSolverParallelDEM::ProcessContacts() {
   custom_vector<int> ext_body_id(2 * data_manager->num_rigid_contacts);
   custom_vector<real3> ext_body_force(2 * data_manager->num_rigid_contacts);
   custom_vector<real3> ext_body_torque(2 * data_manager->num_rigid_contacts);
-  custom_vector<int2> shape_pairs;
   custom_vector<bool> shear_touch;
+  custom_vector<real3> shear_disp;
+  custom_vector<int> shear_occurrence;
 
   if (data_manager->settings.solver.tangential_displ_mode == MULTI_STEP) {
-    shape_pairs.resize(data_manager->num_rigid_contacts);
-    shear_touch.resize(max_shear * data_manager->num_rigid_bodies);
+    shear_touch.resize(data_manager->num_rigid_contacts);
+    shear_disp.resize(data_manager->num_rigid_contacts);
+    shear_occurrence.resize(data_manager->num_rigid_contacts);
     thrust::fill(thrust_parallel, shear_touch.begin(), shear_touch.end(), false);
-#pragma omp parallel for
-    for (int i = 0; i < data_manager->num_rigid_contacts; i++) {
-      int2 pair = I2(int(data_manager->host_data.pair_rigid_rigid[i] >> 32),
-                     int(data_manager->host_data.pair_rigid_rigid[i] & 0xffffffff));
-      shape_pairs[i] = pair;
-    }
+    host_LoadShearHistory(shear_occurrence, shear_disp);
   }
 
-  host_CalcContactForces(ext_body_id, ext_body_force, ext_body_torque, shape_pairs, shear_touch);
+  host_CalcContactForces(ext_body_id, ext_body_force, ext_body_torque, shear_touch, shear_disp);
 
+  // Only the contacts that were touching are kept in the history
   if (data_manager->settings.solver.tangential_displ_mode == MULTI_STEP) {
+    host_StoreShearHistory(data_manager->host_data.pair_rigid_rigid, shear_occurrence, shear_touch, shear_disp);
+  }
+
+  // 2. Calculate contact forces and torques - per body basis
+  //    Build the list of contacts of each body (in compressed row form) with a
+  //    counting sort of the body IDs. The 'ext' arrays are split in one chunk
+  //    per thread and every chunk counts the entries of each body in its own
+  //    histogram. Scanning the histograms body by body gives the start of every
+  //    body and, within it, the position of the entries of every chunk, so each
+  //    chunk scatters the index of its entries to the lists without atomics and
+  //    the entries of a body stay in increasing order. Every body then sums the
+  //    forces and torques of its own contacts. The number of bodies that
+  //    experience at least one contact is 'ct_body_count'.
+  uint num_bodies = data_manager->num_rigid_bodies;
+  uint num_entries = 2 * data_manager->num_rigid_contacts;
+  uint num_chunks = omp_get_max_threads();
+  custom_vector<uint> ext_index(num_entries);
+  custom_vector<uint> body_start(num_bodies + 1);
+  custom_vector<uint> chunk_count(num_chunks * num_bodies);
+
+  thrust::fill(thrust_parallel, chunk_count.begin(), chunk_count.end(), 0);
+#pragma omp parallel for schedule(static, 1)
+  for (int c = 0; c < num_chunks; c++) {
+    uint* count = chunk_count.data() + c * num_bodies;
+    uint end = (uint)((unsigned long long)num_entries * (c + 1) / num_chunks);
+    for (uint k = (uint)((unsigned long long)num_entries * c / num_chunks); k < end; k++) {
+      count[ext_body_id[k]]++;
+    }
+  }
+
+  // Turn the counts of every body into the offsets of the chunks in its list
 #pragma omp parallel for
-    for (int index = 0; index < data_manager->num_rigid_bodies; index++) {
-      for (int i = 0; i < max_shear; i++) {
-        if (shear_touch[max_shear * index + i] == false)
-          data_manager->host_data.shear_neigh[max_shear * index + i].x = -1;
-      }
+  for (int body = 0; body < num_bodies; body++) {
+    uint total = 0;
+    for (uint c = 0; c < num_chunks; c++) {
+      uint count = chunk_count[c * num_bodies + body];
+      chunk_count[c * num_bodies + body] = total;
+      total += count;
+    }
+    body_start[body] = total;
+  }
+  body_start[num_bodies] = 0;
+  thrust::exclusive_scan(thrust_parallel, body_start.begin(), body_start.end(), body_start.begin());
+
+#pragma omp parallel for schedule(static, 1)
+  for (int c = 0; c < num_chunks; c++) {
+    uint* fill = chunk_count.data() + c * num_bodies;
+    uint end = (uint)((unsigned long long)num_entries * (c + 1) / num_chunks);
+    for (uint k = (uint)((unsigned long long)num_entries * c / num_chunks); k < end; k++) {
+      int body = ext_body_id[k];
+      ext_index[body_start[body] + fill[body]++] = k;
     }
   }
 
-  // 2. Calculate contact forces and torques - per body basis
-  //    Accumulate the contact forces and torques for all bodies that are
-  //    involved in at least one contact, by reducing the contact forces and
-  //    torques from all contacts these bodies are involved in. The number of
-  //    bodies that experience at least one contact is 'ct_body_count'.
-  thrust::sort_by_key(thrust_parallel,
-                      ext_body_id.begin(),
-                      ext_body_id.end(),
-                      thrust::make_zip_iterator(thrust::make_tuple(ext_body_force.begin(), ext_body_torque.begin())));
-
-  custom_vector<int> ct_body_id(data_manager->num_rigid_bodies);
+  // Position of each body in the list of bodies in contact
+  custom_vector<uint> ct_body_offset(num_bodies + 1);
+#pragma omp parallel for
+  for (int body = 0; body < num_bodies; body++) {
+    ct_body_offset[body] = body_start[body + 1] > body_start[body];
+  }
+  ct_body_offset[num_bodies] = 0;
+  Thrust_Exclusive_Scan(ct_body_offset);
+  uint ct_body_count = ct_body_offset[num_bodies];
+
+  custom_vector<int> ct_body_id(ct_body_count);
   custom_vector<real3>& ct_body_force = data_manager->host_data.ct_body_force;
   custom_vector<real3>& ct_body_torque = data_manager->host_data.ct_body_torque;
 
-  ct_body_force.resize(data_manager->num_rigid_bodies);
-  ct_body_torque.resize(data_manager->num_rigid_bodies);
-
-  // Reduce contact forces from all contacts and count bodies currently involved
-  // in contact. We do this simultaneously for contact forces and torques, using
-  // zip iterators.
-  uint ct_body_count =
-      thrust::reduce_by_key(
-          ext_body_id.begin(),
-          ext_body_id.end(),
-          thrust::make_zip_iterator(thrust::make_tuple(ext_body_force.begin(), ext_body_torque.begin())),
-          ct_body_id.begin(),
-          thrust::make_zip_iterator(thrust::make_tuple(ct_body_force.begin(), ct_body_torque.begin())),
-          thrust::equal_to<int>(),
-          sum_tuples()).first -
-      ct_body_id.begin();
-
   ct_body_force.resize(ct_body_count);
   ct_body_torque.resize(ct_body_count);
 
+#pragma omp parallel for schedule(dynamic, 256)
+  for (int body = 0; body < num_bodies; body++) {
+    if (body_start[body + 1] == body_start[body]) {
+      continue;
+    }
+    real3 force = ZERO_VECTOR;
+    real3 torque = ZERO_VECTOR;
+    for (uint k = body_start[body]; k < body_start[body + 1]; k++) {
+      force += ext_body_force[ext_index[k]];
+      torque += ext_body_torque[ext_index[k]];
+    }
+    uint offset = ct_body_offset[body];
+    ct_body_id[offset] = body;
+    ct_body_force[offset] = force;
+    ct_body_torque[offset] = torque;
+  }
+
   // 3. Add contact forces and torques to existing forces (impulses):
   //    For all bodies involved in a contact, update the body forces and torques
   //    (scaled by the integration time step).
@@ -20,6 +20,12 @@ using namespace chrono;
   M.reserve(nnz);                                \
   M.resize(rows, cols, false);
 
+#define RELEASE(M)                 \
+  {                                \
+    CompressedMatrix<real> empty;  \
+    swap(M, empty);                \
+  }
+
 void ChLcpSolverParallelDVI::RunTimeStep() {
   LOG(INFO) << "ChLcpSolverParallelDVI::RunTimeStep";
   // Compute the offsets and number of constrains depending on the solver mode
@@ -42,6 +48,10 @@ void ChLcpSolverParallelDVI::RunTimeStep() {
   data_manager->host_data.gamma.resize(data_manager->num_constraints);
   data_manager->host_data.gamma.reset();
 
+  if (data_manager->settings.solver.warm_start) {
+    WarmStartContacts();
+  }
+
   // Perform any setup tasks for all constraint types
   rigid_rigid.Setup(data_manager);
   bilateral.Setup(data_manager);
@@ -108,6 +118,13 @@ void ChLcpSolverParallelDVI::RunTimeStep() {
 
   ComputeImpulses();
 
+  // Keep the contacts and their multipliers for warm starting the next step
+  if (data_manager->settings.solver.warm_start) {
+    previous_pairs = data_manager->host_data.pair_rigid_rigid;
+    previous_gamma = data_manager->host_data.gamma;
+    previous_mode = data_manager->settings.solver.solver_mode;
+  }
+
   for (int i = 0; i < data_manager->measures.solver.maxd_hist.size(); i++) {
     AtIterationEnd(data_manager->measures.solver.maxd_hist[i], data_manager->measures.solver.maxdeltalambda_hist[i],
                    i);
@@ -117,6 +134,59 @@ void ChLcpSolverParallelDVI::RunTimeStep() {
   LOG(TRACE) << "Solve Done: " << residual;
 }
 
+void ChLcpSolverParallelDVI::RemapShapes(const custom_vector<int>& shape_map) {
+  // The multipliers are stored in the order of the pairs, dropping the pairs of
+  // removed shapes or sorting the renumbered pairs would require rebuilding the
+  // whole multiplier vector for a single step of warm starting
+  previous_pairs.clear();
+}
+
+void ChLcpSolverParallelDVI::WarmStartContacts() {
+  const custom_vector<long long>& pairs = data_manager->host_data.pair_rigid_rigid;
+  DynamicVector<real>& gamma = data_manager->host_data.gamma;
+  SOLVERMODE solver_mode = data_manager->settings.solver.solver_mode;
+  uint num_contacts = data_manager->num_rigid_contacts;
+  uint num_previous = previous_pairs.size();
+  uint num_warm_started = 0;
+
+  data_manager->measures.solver.warm_started_contacts = 0;
+  // The pair list is only available when the parallel collision system is used
+  if (num_contacts == 0 || num_previous == 0 || pairs.size() != num_contacts) {
+    return;
+  }
+
+  const long long* pairs_begin = pairs.data();
+  const long long* previous_begin = previous_pairs.data();
+  const long long* previous_end = previous_pairs.data() + num_previous;
+
+  // Both pair lists are sorted, pairs of shapes with several contact points
+  // are matched in the order the narrowphase reported them
+#pragma omp parallel for reduction(+ : num_warm_started)
+  for (int i = 0; i < num_contacts; i++) {
+    long long pair = pairs[i];
+    uint occurrence = i - (std::lower_bound(pairs_begin, pairs_begin + i, pair) - pairs_begin);
+    uint j = (std::lower_bound(previous_begin, previous_end, pair) - previous_begin) + occurrence;
+    if (j >= num_previous || previous_pairs[j] != pair) {
+      continue;
+    }
+
+    gamma[i] = previous_gamma[j];
+    if (solver_mode != NORMAL && previous_mode != NORMAL) {
+      gamma[num_contacts + i * 2 + 0] = previous_gamma[num_previous + j * 2 + 0];
+      gamma[num_contacts + i * 2 + 1] = previous_gamma[num_previous + j * 2 + 1];
+    }
+    if (solver_mode == SPINNING && previous_mode == SPINNING) {
+      gamma[3 * num_contacts + i * 3 + 0] = previous_gamma[3 * num_previous + j * 3 + 0];
+      gamma[3 * num_contacts + i * 3 + 1] = previous_gamma[3 * num_previous + j * 3 + 1];
+      gamma[3 * num_contacts + i * 3 + 2] = previous_gamma[3 * num_previous + j * 3 + 2];
+    }
+    num_warm_started++;
+  }
+
+  data_manager->measures.solver.warm_started_contacts = num_warm_started;
+  LOG(TRACE) << "Warm started contacts: " << num_warm_started << " of " << num_contacts;
+}
+
 void ChLcpSolverParallelDVI::ComputeD() {
   LOG(INFO) << "ChLcpSolverParallelDVI::ComputeD()";
   data_manager->system_timer.start("ChLcpSolverParallel_D");
@@ -157,7 +227,18 @@ void ChLcpSolverParallelDVI::ComputeD() {
 
   const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
 
-  switch (data_manager->settings.solver.solver_mode) {
+  if (data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    // The contact jacobians are not assembled, release their storage
+    RELEASE(D_n_T)
+    RELEASE(D_n)
+    RELEASE(M_invD_n)
+    RELEASE(D_t_T)
+    RELEASE(D_t)
+    RELEASE(M_invD_t)
+    RELEASE(D_s_T)
+    RELEASE(D_s)
+    RELEASE(M_invD_s)
+  } else switch (data_manager->settings.solver.solver_mode) {
     case NORMAL:
       CLEAR_RESERVE_RESIZE(D_n_T, nnz_normal, num_normal, num_dof)
       CLEAR_RESERVE_RESIZE(D_n, nnz_normal, num_dof, num_normal)
@@ -192,9 +273,16 @@ void ChLcpSolverParallelDVI::ComputeD() {
   }
   CLEAR_RESERVE_RESIZE(D_b_T, nnz_bilaterals, num_bilaterals, num_dof)
 
-  rigid_rigid.GenerateSparsity();
+  if (data_manager->settings.solver.jacobian_storage == JACOBIAN_BLOCK) {
+    rigid_rigid.GenerateBodyContacts();
+    rigid_rigid.Build_Blocks();
+  } else if (data_manager->settings.solver.jacobian_storage == JACOBIAN_MATRIX_FREE) {
+    rigid_rigid.GenerateBodyContacts();
+  } else {
+    rigid_rigid.GenerateSparsity();
+    rigid_rigid.Build_D();
+  }
   bilateral.GenerateSparsity();
-  rigid_rigid.Build_D();
   bilateral.Build_D();
 
   data_manager->system_timer.stop("ChLcpSolverParallel_D");
@@ -252,6 +340,17 @@ void ChLcpSolverParallelDVI::ComputeR() {
   SubVectorType R_b = blaze::subvector(R, num_unilaterals, num_bilaterals);
 
   R_b = -b_b - D_b_T * M_invk;
+
+  if (data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    // R = -b - D^T * M_invk, b is zero for the friction constraints
+    DynamicVector<real> D_T_M_invk(data_manager->num_constraints);
+    rigid_rigid.Apply_D_T(data_manager->settings.solver.solver_mode, M_invk, D_T_M_invk);
+    blaze::subvector(R, 0, num_unilaterals) =
+        -blaze::subvector(b, 0, num_unilaterals) - blaze::subvector(D_T_M_invk, 0, num_unilaterals);
+    data_manager->system_timer.stop("ChLcpSolverParallel_R");
+    return;
+  }
+
   switch (data_manager->settings.solver.solver_mode) {
     case NORMAL: {
       R_n = -b_n - D_n_T * M_invk;
@@ -347,7 +446,14 @@ void ChLcpSolverParallelDVI::ComputeImpulses() {
   uint num_unilaterals = data_manager->num_unilaterals;
   uint num_bilaterals = data_manager->num_bilaterals;
 
-  if (data_manager->num_constraints > 0) {
+  if (data_manager->num_constraints > 0 && data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+    ConstSubVectorType gamma_b = blaze::subvector(gamma, num_unilaterals, num_bilaterals);
+    DynamicVector<real> D_gamma;
+
+    rigid_rigid.Apply_D(data_manager->settings.solver.solver_mode, gamma, D_gamma);
+    v = M_invk + M_inv * D_gamma + M_invD_b * gamma_b;
+  } else if (data_manager->num_constraints > 0) {
     ConstSubVectorType gamma_b =
         blaze::subvector(gamma, num_unilaterals, num_bilaterals);
     ConstSubVectorType gamma_n = blaze::subvector(gamma, 0, num_contacts);
@@ -16,9 +16,9 @@ class CH_PARALLEL_API ChLcpSystemDescriptorParallel : public ChLcpSystemDescript
   ChLcpSystemDescriptorParallel(ChParallelDataManager* dc) : data_manager(dc) {}
   ~ChLcpSystemDescriptorParallel() {}
 
-  void ConvertToMatrixForm(ChSparseMatrix* Cq,
-                           ChSparseMatrix* M,
-                           ChSparseMatrix* E,
+  void ConvertToMatrixForm(ChSparseMatrixBase* Cq,
+                           ChSparseMatrixBase* M,
+                           ChSparseMatrixBase* E,
                            ChMatrix<>* Fvector,
                            ChMatrix<>* Bvector,
                            ChMatrix<>* Frict) {
@@ -103,6 +103,14 @@ static inline uint3 operator-(const uint3& a, const uint3& b) {
   return U3(a.x - b.x, a.y - b.y, a.z - b.z);
 }
 
+static inline bool operator==(const int3& a, const int3& b) {
+  return ((a.x == b.x) && (a.y == b.y) && (a.z == b.z));
+}
+
+static inline bool operator!=(const int3& a, const int3& b) {
+  return !(a == b);
+}
+
 static inline int clamp(const int& a, const int& clamp_min, const int& clamp_max) {
   if (a < clamp_min) {
     return clamp_min;
@@ -0,0 +1,94 @@
+#include <fstream>
+#include <iostream>
+
+#include "chrono_parallel/physics/ChEnsembleParallel.h"
+
+using namespace chrono;
+
+ChEnsembleParallel::ChEnsembleParallel() : num_workers(CHOMPfunctions::GetNumProcs()), throughput(0) {
+}
+
+ChEnsembleParallel::~ChEnsembleParallel() {
+}
+
+void ChEnsembleParallel::AddSystem(ChSystemParallel* system) {
+  settings_container* settings = system->GetSettings();
+  settings->min_threads = 1;
+  settings->max_threads = 1;
+  settings->perform_thread_tuning = false;
+  settings->phase_thread_tuning = false;
+  settings->thread_affinity = AFFINITY_NONE;
+
+  EnsembleRecord record;
+  record.sim_time = system->GetChTime();
+  record.num_bodies = system->data_manager->num_rigid_bodies;
+  record.num_contacts = 0;
+  record.solver_iterations = 0;
+  record.num_steps = 0;
+  record.step_time = 0;
+
+  systems.push_back(system);
+  records.push_back(record);
+}
+
+void ChEnsembleParallel::DoStepDynamics(double step_size, int num_steps) {
+  int num_systems = systems.size();
+  ChTimer<double> wall_timer;
+  wall_timer.start();
+
+  // A worker takes all the steps of a system before picking the next one, the
+  // systems can take very different times so they are handed out one by one
+#pragma omp parallel for schedule(dynamic, 1) num_threads(num_workers)
+  for (int i = 0; i < num_systems; i++) {
+    // The parallel loops inside the system run on this worker only, even when
+    // nested parallelism is enabled
+    CHOMPfunctions::SetNumThreads(1);
+
+    ChSystemParallel* system = systems[i];
+    ChTimer<double> timer;
+    timer.start();
+    for (int step = 0; step < num_steps; step++) {
+      system->DoStepDynamics(step_size);
+    }
+    timer.stop();
+
+    EnsembleRecord& record = records[i];
+    record.sim_time = system->GetChTime();
+    record.num_bodies = system->data_manager->num_rigid_bodies;
+    record.num_contacts = system->GetNumContacts();
+    record.solver_iterations = system->data_manager->measures.solver.total_iteration;
+    record.num_steps += num_steps;
+    record.step_time += timer();
+  }
+
+  wall_timer.stop();
+  throughput = wall_timer() > 0 ? num_systems * num_steps / wall_timer() : 0;
+
+  LOG(TRACE) << "Ensemble of " << num_systems << " systems: " << throughput << " steps per second";
+}
+
+void ChEnsembleParallel::PrintReport() const {
+  std::cout << "Ensemble Report:" << std::endl;
+  std::cout << "------------" << std::endl;
+  for (int i = 0; i < records.size(); i++) {
+    const EnsembleRecord& record = records[i];
+    std::cout << "System:\t" << i << "\t" << record.sim_time << "\t" << record.num_bodies << "\t"
+              << record.num_contacts << "\t" << record.num_steps << "\t" << record.step_time << std::endl;
+  }
+  std::cout << "Throughput:\t" << throughput << std::endl;
+  std::cout << "------------" << std::endl;
+}
+
+bool ChEnsembleParallel::ExportCSV(const std::string& filename) const {
+  std::ofstream file(filename.c_str());
+  if (!file.is_open()) {
+    return false;
+  }
+  file << "system,sim_time,num_bodies,num_contacts,solver_iterations,num_steps,step_time\n";
+  for (int i = 0; i < records.size(); i++) {
+    const EnsembleRecord& record = records[i];
+    file << i << "," << record.sim_time << "," << record.num_bodies << "," << record.num_contacts << ","
+         << record.solver_iterations << "," << record.num_steps << "," << record.step_time << "\n";
+  }
+  return true;
+}
@@ -0,0 +1,78 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// Description: Steps many independent parallel systems concurrently. Systems
+// that are too small to scale over a whole OpenMP team are each stepped by a
+// single worker thread, the workers share one team and pick the next system as
+// soon as they are done with one.
+// =============================================================================
+
+#ifndef CH_ENSEMBLEPARALLEL_H
+#define CH_ENSEMBLEPARALLEL_H
+
+#include <string>
+#include <vector>
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+namespace chrono {
+
+// Summary of one system of the ensemble, updated after every call to
+// ChEnsembleParallel::DoStepDynamics()
+struct EnsembleRecord {
+  double sim_time;        // Simulation time of the system
+  uint num_bodies;        // Number of rigid bodies
+  uint num_contacts;      // Number of contacts of all types at the last step
+  int solver_iterations;  // Solver iterations performed in the last step
+  int num_steps;          // Number of steps taken through the ensemble
+  double step_time;       // Wall time spent stepping the system through the ensemble
+};
+
+class CH_PARALLEL_API ChEnsembleParallel {
+ public:
+  ChEnsembleParallel();
+  ~ChEnsembleParallel();
+
+  // Add a system to the ensemble, the ensemble does not take ownership of it.
+  // The system runs on a single worker thread so its thread tuning and thread
+  // pinning are disabled.
+  void AddSystem(ChSystemParallel* system);
+  int GetNumSystems() const { return systems.size(); }
+  ChSystemParallel* GetSystem(int i) const { return systems[i]; }
+
+  // The number of worker threads, by default the number visible via openMP
+  void SetNumWorkers(int workers) { num_workers = workers; }
+  int GetNumWorkers() const { return num_workers; }
+
+  // Advance every system by num_steps steps of the given size
+  void DoStepDynamics(double step_size, int num_steps = 1);
+
+  const EnsembleRecord& GetRecord(int i) const { return records[i]; }
+  // Number of system steps per second of wall time during the last call to
+  // DoStepDynamics()
+  double GetThroughput() const { return throughput; }
+
+  void PrintReport() const;
+  // Write the records as comma separated values, one line per system
+  bool ExportCSV(const std::string& filename) const;
+
+ private:
+  std::vector<ChSystemParallel*> systems;
+  std::vector<EnsembleRecord> records;
+  int num_workers;
+  double throughput;
+};
+}
+
+#endif
@@ -5,7 +5,17 @@
 #include "physics/ChShaftsBody.h"
 
 #include "chrono_parallel/physics/ChSystemParallel.h"
+#include "chrono_parallel/collision/ChCBroadphaseUtils.h"
 #include <numeric>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+#include <thrust/transform_reduce.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+#endif
 
 using namespace chrono;
 using namespace chrono::collision;
@@ -25,11 +35,20 @@ ChSystemParallel::ChSystemParallel(unsigned int max_objects) : ChSystem(1000, 10
   cd_accumulator.resize(10, 0);
   frame_threads = 0;
   frame_bins = 0;
+  frame_reorder = 0;
+  frame_phase = 0;
+  for (int i = 0; i < NUM_THREAD_PHASES; i++) {
+    phase_tuning[i].threads = 0;
+  }
   old_timer = 0;
   old_timer_cd = 0;
   detect_optimal_threads = false;
   detect_optimal_bins = false;
   current_threads = 2;
+  affinity_policy = AFFINITY_NONE;
+  affinity_threads = 0;
+  first_touch_threads = 0;
+  first_touch_bodies = 0;
 
   data_manager->system_timer.AddTimer("step");
   data_manager->system_timer.AddTimer("update");
@@ -49,6 +68,10 @@ ChSystemParallel::ChSystemParallel(unsigned int max_objects) : ChSystem(1000, 10
 }
 
 ChSystemParallel::~ChSystemParallel() {
+  // Give the pinned threads the process mask back
+  if (affinity_policy != AFFINITY_NONE) {
+    SetThreadAffinity(AFFINITY_NONE, 0);
+  }
   delete data_manager;
 }
 
@@ -63,6 +86,14 @@ int ChSystemParallel::Integrate_Y() {
   data_manager->system_timer.Reset();
   data_manager->system_timer.start("step");
 
+  // Bodies are added, removed and moved in memory with the threads of the update
+  data_manager->SetPhaseThreads(PHASE_UPDATE);
+  FlushRemovedBodies();
+  if (data_manager->settings.reorder_frequency > 0 && ++frame_reorder >= data_manager->settings.reorder_frequency) {
+    frame_reorder = 0;
+    ReorderBodies();
+  }
+  UpdateDataPlacement();
   Setup();
 
   data_manager->system_timer.start("update");
@@ -74,10 +105,12 @@ int ChSystemParallel::Integrate_Y() {
   collision_system->ReportContacts(this->contact_container);
   data_manager->system_timer.stop("collision");
 
+  data_manager->SetPhaseThreads(PHASE_SOLVER);
   data_manager->system_timer.start("lcp");
   ((ChLcpSolverParallel*)(LCP_solver_speed))->RunTimeStep();
   data_manager->system_timer.stop("lcp");
 
+  data_manager->SetPhaseThreads(PHASE_UPDATE);
   data_manager->system_timer.start("update");
 
   // Iterate over the active bilateral constraints and store their Lagrange
@@ -97,25 +130,30 @@ int ChSystemParallel::Integrate_Y() {
   custom_vector<real3>& pos_pointer = data_manager->host_data.pos_rigid;
   custom_vector<real4>& rot_pointer = data_manager->host_data.rot_rigid;
 
+  if (data_manager->settings.host_body_state) {
+    IntegrateRigidBodies();
+  } else {
 #pragma omp parallel for
-  for (int i = 0; i < bodylist.size(); i++) {
-    if (data_manager->host_data.active_rigid[i] == true) {
-      bodylist[i]->Variables().Get_qb().SetElement(0, 0, velocities[i * 6 + 0]);
-      bodylist[i]->Variables().Get_qb().SetElement(1, 0, velocities[i * 6 + 1]);
-      bodylist[i]->Variables().Get_qb().SetElement(2, 0, velocities[i * 6 + 2]);
-      bodylist[i]->Variables().Get_qb().SetElement(3, 0, velocities[i * 6 + 3]);
-      bodylist[i]->Variables().Get_qb().SetElement(4, 0, velocities[i * 6 + 4]);
-      bodylist[i]->Variables().Get_qb().SetElement(5, 0, velocities[i * 6 + 5]);
-
-      bodylist[i]->VariablesQbIncrementPosition(this->GetStep());
-      bodylist[i]->VariablesQbSetSpeed(this->GetStep());
-
-      bodylist[i]->Update(ChTime);
-
-      // update the position and rotation vectors
-      pos_pointer[i] = (R3(bodylist[i]->GetPos().x, bodylist[i]->GetPos().y, bodylist[i]->GetPos().z));
-      rot_pointer[i] =
-          (R4(bodylist[i]->GetRot().e0, bodylist[i]->GetRot().e1, bodylist[i]->GetRot().e2, bodylist[i]->GetRot().e3));
+    for (int i = 0; i < bodylist.size(); i++) {
+      if (data_manager->host_data.active_rigid[i] == true) {
+        bodylist[i]->Variables().Get_qb().SetElement(0, 0, velocities[i * 6 + 0]);
+        bodylist[i]->Variables().Get_qb().SetElement(1, 0, velocities[i * 6 + 1]);
+        bodylist[i]->Variables().Get_qb().SetElement(2, 0, velocities[i * 6 + 2]);
+        bodylist[i]->Variables().Get_qb().SetElement(3, 0, velocities[i * 6 + 3]);
+        bodylist[i]->Variables().Get_qb().SetElement(4, 0, velocities[i * 6 + 4]);
+        bodylist[i]->Variables().Get_qb().SetElement(5, 0, velocities[i * 6 + 5]);
+
+        bodylist[i]->VariablesQbIncrementPosition(this->GetStep());
+        bodylist[i]->VariablesQbSetSpeed(this->GetStep());
+
+        bodylist[i]->Update(ChTime);
+
+        // update the position and rotation vectors
+        ChVector<>& body_pos = bodylist[i]->GetPos();
+        ChQuaternion<>& body_rot = bodylist[i]->GetRot();
+        pos_pointer[i] = R3(body_pos.x, body_pos.y, body_pos.z);
+        rot_pointer[i] = R4(body_rot.e0, body_rot.e1, body_rot.e2, body_rot.e3);
+      }
     }
   }
 
@@ -134,11 +172,16 @@ int ChSystemParallel::Integrate_Y() {
     otherphysicslist[i]->Update(ChTime);
   }
 
+  if (data_manager->settings.sleep.use_sleeping) {
+    UpdateSleepingBodies();
+  }
+
   data_manager->system_timer.stop("update");
 
   //=============================================================================================
   ChTime += GetStep();
   data_manager->system_timer.stop("step");
+  RecordStep();
   if (data_manager->settings.perform_thread_tuning) {
     RecomputeThreads();
   }
@@ -167,16 +210,200 @@ void ChSystemParallel::AddBody(ChSharedPtr<ChBody> newbody) {
   }
 
   // Reserve space for this body in the system-wide vectors. Note that the
-  // actual data is set in UpdateBodies().
-  data_manager->host_data.pos_rigid.push_back(R3());
-  data_manager->host_data.rot_rigid.push_back(R4());
+  // actual data is set in UpdateBodies(), unless the state of the bodies is
+  // kept in the data manager in which case it is only copied here.
+  ChVector<>& pos = newbody->GetPos();
+  ChQuaternion<>& rot = newbody->GetRot();
+  ChVector<>& vel = newbody->GetPos_dt();
+  ChVector<> omg = newbody->GetWvel_loc();
+  data_manager->host_data.pos_rigid.push_back(R3(pos.x, pos.y, pos.z));
+  data_manager->host_data.rot_rigid.push_back(R4(rot.e0, rot.e1, rot.e2, rot.e3));
+  data_manager->host_data.vel_rigid.push_back(R3(vel.x, vel.y, vel.z));
+  data_manager->host_data.omg_rigid.push_back(R3(omg.x, omg.y, omg.z));
   data_manager->host_data.active_rigid.push_back(true);
   data_manager->host_data.collide_rigid.push_back(true);
+  data_manager->host_data.sleep_timer.push_back(0);
+  data_manager->host_data.sleep_island.push_back(body_index.size());
+  data_manager->host_data.uid_rigid.push_back(body_index.size());
+  body_index.push_back(newbody->GetId());
 
   // Let derived classes reserve space for specific material surface data
   AddMaterialSurfaceData(newbody);
 }
 
+//
+// Queue the specified body for removal. Its collision model is removed right
+// away, the shapes and the system-wide body data are compacted in batch at the
+// start of the next step, see FlushRemovedBodies().
+//
+void ChSystemParallel::RemoveBody(ChSharedPtr<ChBody> mbody) {
+  assert(std::find(bodylist.begin(), bodylist.end(), mbody.get_ptr()) != bodylist.end());
+
+  if (mbody->GetCollide()) {
+    mbody->RemoveCollisionModelsFromSystem();
+  }
+
+  removed_bodies.push_back(mbody.get_ptr());
+}
+
+//
+// Remove all queued bodies. The bodies that are kept are renumbered in order,
+// so every system-wide vector is compacted with the same flags and the shapes
+// are moved to the new body indices.
+//
+void ChSystemParallel::FlushRemovedBodies() {
+  ChCollisionSystemParallel* collsys = dynamic_cast<ChCollisionSystemParallel*>(collision_system);
+  bool remove_shapes = collsys && collsys->HasRemovedShapes();
+
+  if (removed_bodies.size() == 0 && !remove_shapes) {
+    return;
+  }
+
+  uint num_bodies = data_manager->num_rigid_bodies;
+  custom_vector<uint> body_removed(num_bodies, 0);
+  custom_vector<int> body_map(num_bodies);
+
+  // A body queued more than once is only released once
+  std::vector<ChBody*> released;
+  for (int i = 0; i < removed_bodies.size(); i++) {
+    int id = removed_bodies[i]->GetId();
+    if (body_removed[id] == 0) {
+      body_removed[id] = 1;
+      released.push_back(removed_bodies[i]);
+    }
+  }
+  removed_bodies.clear();
+
+  thrust::exclusive_scan(body_removed.begin(), body_removed.end(), body_map.begin());
+#pragma omp parallel for
+  for (int i = 0; i < num_bodies; i++) {
+    body_map[i] = body_removed[i] ? -1 : i - body_map[i];
+  }
+
+  // The shapes of the removed bodies are still needed to find what rests on them
+  if (data_manager->settings.sleep.use_sleeping && released.size() > 0) {
+    WakeRemovedIslands(body_removed);
+  }
+
+  if (remove_shapes) {
+    custom_vector<int> shape_map;
+    collsys->RemoveShapes(body_map, shape_map);
+    ((ChLcpSolverParallel*)(LCP_solver_speed))->RemapShapes(shape_map);
+  }
+
+  if (released.size() == 0) {
+    return;
+  }
+
+  uint num_kept = 0;
+  for (int i = 0; i < num_bodies; i++) {
+    if (body_removed[i]) {
+      body_index[data_manager->host_data.uid_rigid[i]] = -1;
+    } else {
+      body_index[data_manager->host_data.uid_rigid[i]] = num_kept;
+      bodylist[num_kept] = bodylist[i];
+      bodylist[num_kept]->SetId(num_kept);
+      num_kept++;
+    }
+  }
+  bodylist.resize(num_kept);
+  data_manager->num_rigid_bodies = num_kept;
+
+  Thrust_Compact(data_manager->host_data.pos_rigid, body_removed);
+  Thrust_Compact(data_manager->host_data.rot_rigid, body_removed);
+  Thrust_Compact(data_manager->host_data.vel_rigid, body_removed);
+  Thrust_Compact(data_manager->host_data.omg_rigid, body_removed);
+  Thrust_Compact(data_manager->host_data.active_rigid, body_removed);
+  Thrust_Compact(data_manager->host_data.collide_rigid, body_removed);
+  Thrust_Compact(data_manager->host_data.sleep_timer, body_removed);
+  Thrust_Compact(data_manager->host_data.sleep_island, body_removed);
+  Thrust_Compact(data_manager->host_data.uid_rigid, body_removed);
+
+  // Let derived classes compact the specific material surface data
+  RemoveMaterialSurfaceData(body_removed);
+
+  for (int i = 0; i < released.size(); i++) {
+    released[i]->SetSystem(0);
+    released[i]->RemoveRef();
+  }
+
+  LOG(TRACE) << "Removed bodies: " << released.size() << " remaining: " << num_kept;
+}
+
+//
+// Sort the bodies along a space filling curve through their positions so that
+// bodies close in space are also close in memory. The state of the bodies and
+// their shapes are permuted and the bodies are renumbered, the material data,
+// masses and flags are loaded again from the bodies in the next Update().
+//
+void ChSystemParallel::ReorderBodies() {
+  ChCollisionSystemParallel* collsys = dynamic_cast<ChCollisionSystemParallel*>(collision_system);
+  uint num_bodies = data_manager->num_rigid_bodies;
+  if (!collsys || num_bodies < 2) {
+    return;
+  }
+
+  host_container& host_data = data_manager->host_data;
+  const custom_vector<real3>& position = host_data.pos_rigid;
+
+  // Place the bodies on a 1024^3 grid covering all of them, the same scale is
+  // used on all axes so that the curve does not favor an axis
+  bbox res = bbox(position[0], position[0]);
+  res = thrust::transform_reduce(thrust_parallel, position.begin(), position.end(), bbox_transformation(), res,
+                                 bbox_reduction());
+  real3 diagonal = res.second - res.first;
+  real max_extent = std::max(diagonal.x, std::max(diagonal.y, diagonal.z));
+  real scale = max_extent > 0 ? 1023 / max_extent : 0;
+  bool hilbert = data_manager->settings.reorder_curve == CURVE_HILBERT;
+
+  custom_vector<uint> keys(num_bodies);
+  custom_vector<int> body_order(num_bodies);
+#pragma omp parallel for
+  for (int i = 0; i < num_bodies; i++) {
+    real3 cell = (position[i] - res.first) * scale;
+    int3 grid = I3(int(cell.x), int(cell.y), int(cell.z));
+    keys[i] = hilbert ? Hilbert_Index(grid) : Morton_Index(grid);
+    body_order[i] = i;
+  }
+  thrust::stable_sort_by_key(keys.begin(), keys.end(), body_order.begin());
+
+  uint num_moved = 0;
+  custom_vector<int> body_map(num_bodies);
+#pragma omp parallel for reduction(+ : num_moved)
+  for (int i = 0; i < num_bodies; i++) {
+    body_map[body_order[i]] = i;
+    num_moved += (body_order[i] != i);
+  }
+  if (num_moved == 0) {
+    return;
+  }
+
+  std::vector<ChBody*> old_bodylist = bodylist;
+  for (int i = 0; i < num_bodies; i++) {
+    bodylist[i] = old_bodylist[body_order[i]];
+    bodylist[i]->SetId(i);
+  }
+
+  Thrust_Permute(host_data.pos_rigid, body_order);
+  Thrust_Permute(host_data.rot_rigid, body_order);
+  Thrust_Permute(host_data.vel_rigid, body_order);
+  Thrust_Permute(host_data.omg_rigid, body_order);
+  Thrust_Permute(host_data.active_rigid, body_order);
+  Thrust_Permute(host_data.collide_rigid, body_order);
+  Thrust_Permute(host_data.sleep_timer, body_order);
+  Thrust_Permute(host_data.sleep_island, body_order);
+  Thrust_Permute(host_data.uid_rigid, body_order);
+  for (int i = 0; i < num_bodies; i++) {
+    body_index[host_data.uid_rigid[i]] = i;
+  }
+
+  custom_vector<int> shape_map;
+  collsys->ReorderShapes(body_map, shape_map);
+  ((ChLcpSolverParallel*)(LCP_solver_speed))->RemapShapes(shape_map);
+
+  LOG(TRACE) << "Reordered bodies: " << num_moved << " of " << num_bodies << " moved";
+}
+
 //
 // Add physics items, other than bodies or links, to the system.
 // We keep track separately of ChShaft elements which are maintained in their
@@ -231,9 +458,12 @@ void ChSystemParallel::AddShaft(ChSharedPtr<ChShaft> shaft) {
 // Reset forces for all lcp variables
 //
 void ChSystemParallel::ClearForceVariables() {
+  // The forces of the bodies are written directly into hf
+  if (!data_manager->settings.host_body_state) {
 #pragma omp parallel for
-  for (int i = 0; i < data_manager->num_rigid_bodies; i++) {
-    bodylist[i]->VariablesFbReset();
+    for (int i = 0; i < data_manager->num_rigid_bodies; i++) {
+      bodylist[i]->VariablesFbReset();
+    }
   }
 
   ////#pragma omp parallel for
@@ -264,6 +494,14 @@ void ChSystemParallel::Update() {
   data_manager->host_data.bilateral_mapping.clear();
   data_manager->host_data.bilateral_type.clear();
 
+  // The links read the state of their bodies from the ChBody objects
+  if (data_manager->settings.host_body_state) {
+    for (int i = 0; i < linklist.size(); i++) {
+      SyncBody(dynamic_cast<ChBody*>(linklist[i]->GetBody1()));
+      SyncBody(dynamic_cast<ChBody*>(linklist[i]->GetBody2()));
+    }
+  }
+
   this->LCP_descriptor->BeginInsertion();
   UpdateLinks();
   UpdateOtherPhysics();
@@ -285,6 +523,13 @@ void ChSystemParallel::UpdateRigidBodies() {
   custom_vector<real4>& rotation = data_manager->host_data.rot_rigid;
   custom_vector<bool>& active = data_manager->host_data.active_rigid;
   custom_vector<bool>& collide = data_manager->host_data.collide_rigid;
+  custom_vector<real3>& velocity = data_manager->host_data.vel_rigid;
+  custom_vector<real3>& omega = data_manager->host_data.omg_rigid;
+
+  if (data_manager->settings.host_body_state) {
+    LoadRigidBodyForces();
+    return;
+  }
 
 #pragma omp parallel for
   for (int i = 0; i < bodylist.size(); i++) {
@@ -313,6 +558,8 @@ void ChSystemParallel::UpdateRigidBodies() {
 
     position[i] = R3(body_pos.x, body_pos.y, body_pos.z);
     rotation[i] = R4(body_rot.e0, body_rot.e1, body_rot.e2, body_rot.e3);
+    velocity[i] = R3(body_qb.GetElementN(0), body_qb.GetElementN(1), body_qb.GetElementN(2));
+    omega[i] = R3(body_qb.GetElementN(3), body_qb.GetElementN(4), body_qb.GetElementN(5));
 
     active[i] = bodylist[i]->IsActive();
     collide[i] = bodylist[i]->GetCollide();
@@ -324,6 +571,125 @@ void ChSystemParallel::UpdateRigidBodies() {
   }
 }
 
+//
+// Load the velocities and the applied forces of all bodies when their state is
+// kept in the data manager. The forces are computed like in ChBody::UpdateForces
+// and ChBody::VariablesFbLoadForces, without the ChForce objects, and the
+// ChBody objects are only read for their mass, inertia and accumulators.
+//
+void ChSystemParallel::LoadRigidBodyForces() {
+  const custom_vector<real4>& rotation = data_manager->host_data.rot_rigid;
+  const custom_vector<real3>& velocity = data_manager->host_data.vel_rigid;
+  const custom_vector<real3>& omega = data_manager->host_data.omg_rigid;
+  custom_vector<bool>& active = data_manager->host_data.active_rigid;
+  custom_vector<bool>& collide = data_manager->host_data.collide_rigid;
+  DynamicVector<real>& v = data_manager->host_data.v;
+  DynamicVector<real>& hf = data_manager->host_data.hf;
+  real3 gravity = R3(G_acc.x, G_acc.y, G_acc.z);
+  real step_size = GetStep();
+
+#pragma omp parallel for
+  for (int i = 0; i < bodylist.size(); i++) {
+    ChBody* body = bodylist[i];
+    real3 vel = velocity[i];
+    real3 omg = omega[i];
+
+    ChVector<> body_force = body->Get_accumulated_force() + body->Get_Scr_force();
+    ChVector<> body_torque = body->Get_accumulated_torque() + body->Get_Scr_torque();
+    real3 force = R3(body_force.x, body_force.y, body_force.z) + gravity * body->GetMass();
+    real3 torque = quatRotateT(R3(body_torque.x, body_torque.y, body_torque.z), rotation[i]);
+    if (!body->GetNoGyroTorque()) {
+      ChVector<> body_omg(omg.x, omg.y, omg.z);
+      ChVector<> gyro = Vcross(body_omg, body->GetInertia() * body_omg);
+      torque = torque - R3(gyro.x, gyro.y, gyro.z);
+    }
+
+    v[i * 6 + 0] = vel.x;
+    v[i * 6 + 1] = vel.y;
+    v[i * 6 + 2] = vel.z;
+    v[i * 6 + 3] = omg.x;
+    v[i * 6 + 4] = omg.y;
+    v[i * 6 + 5] = omg.z;
+
+    hf[i * 6 + 0] = force.x * step_size;
+    hf[i * 6 + 1] = force.y * step_size;
+    hf[i * 6 + 2] = force.z * step_size;
+    hf[i * 6 + 3] = torque.x * step_size;
+    hf[i * 6 + 4] = torque.y * step_size;
+    hf[i * 6 + 5] = torque.z * step_size;
+
+    active[i] = body->IsActive();
+    collide[i] = body->GetCollide();
+
+    // Let derived classes set the specific material surface data.
+    UpdateMaterialSurfaceData(i, body);
+  }
+}
+
+//
+// Advance the state of all active bodies kept in the data manager with the
+// velocities computed by the solver, the rotation is updated like in
+// ChBody::VariablesQbIncrementPosition.
+//
+void ChSystemParallel::IntegrateRigidBodies() {
+  const DynamicVector<real>& v = data_manager->host_data.v;
+  const custom_vector<bool>& active = data_manager->host_data.active_rigid;
+  custom_vector<real3>& position = data_manager->host_data.pos_rigid;
+  custom_vector<real4>& rotation = data_manager->host_data.rot_rigid;
+  custom_vector<real3>& velocity = data_manager->host_data.vel_rigid;
+  custom_vector<real3>& omega = data_manager->host_data.omg_rigid;
+  real step_size = GetStep();
+
+#pragma omp parallel for
+  for (int i = 0; i < data_manager->num_rigid_bodies; i++) {
+    if (!active[i]) {
+      continue;
+    }
+    real3 vel = R3(v[i * 6 + 0], v[i * 6 + 1], v[i * 6 + 2]);
+    real3 omg = R3(v[i * 6 + 3], v[i * 6 + 4], v[i * 6 + 5]);
+    velocity[i] = vel;
+    omega[i] = omg;
+    position[i] = position[i] + vel * step_size;
+
+    real3 omg_abs = quatRotate(omg, rotation[i]);
+    real omg_len = length(omg_abs);
+    if (omg_len > 0) {
+      quaternion delta_rot = Q_from_AngAxis(omg_len * step_size, omg_abs / omg_len);
+      rotation[i] = normalize(delta_rot % rotation[i]);
+    }
+  }
+}
+
+//
+// Copy the state kept in the data manager into a ChBody.
+//
+void ChSystemParallel::SyncBody(ChBody* body) {
+  if (!body || body->GetSystem() != this) {
+    return;
+  }
+  int i = body->GetId();
+  real3 pos = data_manager->host_data.pos_rigid[i];
+  real4 rot = data_manager->host_data.rot_rigid[i];
+  real3 vel = data_manager->host_data.vel_rigid[i];
+  real3 omg = data_manager->host_data.omg_rigid[i];
+
+  body->SetPos(ChVector<>(pos.x, pos.y, pos.z));
+  body->SetRot(ChQuaternion<>(rot.w, rot.x, rot.y, rot.z));
+  body->SetPos_dt(ChVector<>(vel.x, vel.y, vel.z));
+  body->SetWvel_loc(ChVector<>(omg.x, omg.y, omg.z));
+  body->Update(ChTime);
+}
+
+void ChSystemParallel::SyncBodies() {
+  if (!data_manager->settings.host_body_state) {
+    return;
+  }
+#pragma omp parallel for
+  for (int i = 0; i < bodylist.size(); i++) {
+    SyncBody(bodylist[i]);
+  }
+}
+
 //
 // Update all shaft elements in the system and populate system-wide state and
 // force vectors. Note that visualization assets are not updated.
@@ -514,7 +880,352 @@ void ChSystemParallel::Setup() {
   nbodies_fixed = -1;
 }
 
+void ChSystemParallel::RecordStep() {
+  if (data_manager->system_timer.GetRecordCapacity() == 0) {
+    return;
+  }
+  const host_container& host_data = data_manager->host_data;
+
+  // Every nonzero of the assembled jacobians and of M^-1*D is read once in a
+  // Shur product, each one is stored as a value and a column index
+  size_t nnz = host_data.D_n_T.nonZeros() + host_data.D_t_T.nonZeros() + host_data.D_s_T.nonZeros() +
+               host_data.D_b_T.nonZeros() + host_data.M_invD_n.nonZeros() + host_data.M_invD_t.nonZeros() +
+               host_data.M_invD_s.nonZeros() + host_data.M_invD_b.nonZeros();
+
+  TimerRecord record;
+  record.sim_time = ChTime;
+  record.num_bodies = data_manager->num_rigid_bodies;
+  record.num_contacts = GetNumContacts();
+  record.solver_iterations = data_manager->measures.solver.total_iteration;
+  record.residual = data_manager->measures.solver.residual;
+  record.bytes_per_product = nnz * (sizeof(real) + sizeof(size_t));
+  data_manager->system_timer.Record(record);
+}
+
+// Find the island of a body, halving the path to the root along the way
+static inline uint function_Island_Find(uint body, custom_vector<uint>& island) {
+  while (island[body] != body) {
+    island[body] = island[island[body]];
+    body = island[body];
+  }
+  return body;
+}
+
+// Merge the islands of two bodies, the root of an island is its lowest body
+static inline void function_Island_Union(uint body_a, uint body_b, custom_vector<uint>& island) {
+  uint root_a = function_Island_Find(body_a, island);
+  uint root_b = function_Island_Find(body_b, island);
+  if (root_a < root_b) {
+    island[root_b] = root_a;
+  } else if (root_b < root_a) {
+    island[root_a] = root_b;
+  }
+}
+
+//
+// Islands are the groups of bodies connected by contacts or links. A body that
+// is inactive without sleeping (fixed, or frozen by the active AABB) does not
+// connect islands, otherwise everything resting on the ground would be a
+// single island. An island goes to sleep when all of its bodies have been
+// resting long enough, and all the sleeping bodies of an island that contains
+// a moving body are woken up. Contacts between two sleeping bodies are not
+// generated, so every sleeping body keeps the island it fell asleep in and the
+// sleeping bodies of the same island are merged again. A moving body touching
+// any of them wakes up the whole island.
+//
+void ChSystemParallel::UpdateSleepingBodies() {
+  const sleep_settings& sleep = data_manager->settings.sleep;
+  const DynamicVector<real>& v = data_manager->host_data.v;
+  const custom_vector<int2>& bids = data_manager->host_data.bids_rigid_rigid;
+  const custom_vector<bool>& active = data_manager->host_data.active_rigid;
+  const custom_vector<uint>& uid = data_manager->host_data.uid_rigid;
+  custom_vector<real>& sleep_timer = data_manager->host_data.sleep_timer;
+  custom_vector<uint>& sleep_island = data_manager->host_data.sleep_island;
+  uint num_bodies = data_manager->num_rigid_bodies;
+  uint num_contacts = data_manager->num_rigid_contacts;
+
+  custom_vector<bool> body_fixed(num_bodies);
+  custom_vector<uint> island(num_bodies);
+  custom_vector<uint> island_root(num_bodies);
+  custom_vector<bool> island_resting(num_bodies, true);
+
+  // Accumulate the time every awake body has been resting, the speeds are the
+  // ones computed in this step
+#pragma omp parallel for
+  for (int i = 0; i < num_bodies; i++) {
+    island[i] = i;
+    body_fixed[i] = !active[i] && !bodylist[i]->GetSleeping();
+    if (!active[i]) {
+      continue;
+    }
+    real speed = std::max(std::abs(v[i * 6 + 0]), std::max(std::abs(v[i * 6 + 1]), std::abs(v[i * 6 + 2])));
+    real wvel = std::max(std::abs(v[i * 6 + 3]), std::max(std::abs(v[i * 6 + 4]), std::abs(v[i * 6 + 5])));
+    if (speed < sleep.min_speed && wvel < sleep.min_wvel) {
+      sleep_timer[i] += GetStep();
+    } else {
+      sleep_timer[i] = 0;
+    }
+  }
+
+  // The union-find is sequential, it touches every contact once and is cheap
+  // compared to the contact processing that produced the list
+  for (int i = 0; i < num_contacts; i++) {
+    int2 body = bids[i];
+    if (!body_fixed[body.x] && !body_fixed[body.y]) {
+      function_Island_Union(body.x, body.y, island);
+    }
+  }
+  for (int i = 0; i < linklist.size(); i++) {
+    ChBody* body_a = dynamic_cast<ChBody*>(linklist[i]->GetBody1());
+    ChBody* body_b = dynamic_cast<ChBody*>(linklist[i]->GetBody2());
+    if (body_a && body_b && body_a->GetSystem() == this && body_b->GetSystem() == this &&
+        !body_fixed[body_a->GetId()] && !body_fixed[body_b->GetId()]) {
+      function_Island_Union(body_a->GetId(), body_b->GetId(), island);
+    }
+  }
+
+  // The sleeping bodies are not in contact with each other anymore, the ones
+  // that fell asleep in the same island are merged again
+  custom_vector<uint> sleeping_island;
+  custom_vector<uint> sleeping_body;
+  for (int i = 0; i < num_bodies; i++) {
+    if (bodylist[i]->GetSleeping()) {
+      sleeping_island.push_back(sleep_island[i]);
+      sleeping_body.push_back(i);
+    }
+  }
+  thrust::sort_by_key(thrust_parallel, sleeping_island.begin(), sleeping_island.end(), sleeping_body.begin());
+  for (int i = 1; i < sleeping_body.size(); i++) {
+    if (sleeping_island[i] == sleeping_island[i - 1]) {
+      function_Island_Union(sleeping_body[i - 1], sleeping_body[i], island);
+    }
+  }
+
+  // Every body only reads the island tree from here on, several bodies can
+  // clear the flag of the same island at the same time
+#pragma omp parallel for
+  for (int i = 0; i < num_bodies; i++) {
+    uint root = i;
+    while (island[root] != root) {
+      root = island[root];
+    }
+    island_root[i] = root;
+    if (!body_fixed[i] && sleep_timer[i] < sleep.sleep_time) {
+      island_resting[root] = false;
+    }
+  }
+
+  uint num_islands = 0;
+  uint num_sleeping = 0;
+
+#pragma omp parallel for reduction(+ : num_islands, num_sleeping)
+  for (int i = 0; i < num_bodies; i++) {
+    if (body_fixed[i]) {
+      continue;
+    }
+    bool resting = island_resting[island_root[i]];
+    // A resting island is labeled with the stable id of its root, the bodies
+    // that were already asleep in it take the same label
+    if (resting) {
+      sleep_island[i] = uid[island_root[i]];
+    }
+    if (resting && !bodylist[i]->GetSleeping()) {
+      bodylist[i]->SetSleeping(true);
+      bodylist[i]->SetPos_dt(ChVector<>(0, 0, 0));
+      bodylist[i]->SetWvel_loc(ChVector<>(0, 0, 0));
+      // When the state lives in the data manager the speeds stored there are
+      // loaded into the solver and written back to the ChBody, clear them too
+      if (data_manager->settings.host_body_state) {
+        data_manager->host_data.vel_rigid[i] = R3(0);
+        data_manager->host_data.omg_rigid[i] = R3(0);
+      }
+    } else if (!resting && bodylist[i]->GetSleeping()) {
+      bodylist[i]->SetSleeping(false);
+      sleep_timer[i] = 0;
+    }
+    num_islands += (island_root[i] == i);
+    num_sleeping += resting;
+  }
+
+  data_manager->measures.sleep.num_islands = num_islands;
+  data_manager->measures.sleep.num_sleeping = num_sleeping;
+
+  LOG(TRACE) << "Islands: " << num_islands << " sleeping bodies: " << num_sleeping;
+}
+
+//
+// Wake up the sleeping islands that lose a body. A sleeping body only touches
+// the other sleeping bodies of its island, or fixed bodies whose contacts with
+// it are not generated. The sleeping bodies resting on a removed fixed body are
+// found with the bounding boxes of the last collision detection, which are all
+// in the same frame.
+//
+void ChSystemParallel::WakeRemovedIslands(const custom_vector<uint>& body_removed) {
+  const host_container& host_data = data_manager->host_data;
+  custom_vector<real>& sleep_timer = data_manager->host_data.sleep_timer;
+  uint num_bodies = data_manager->num_rigid_bodies;
+  // Shapes added since the last collision detection have no bounding box yet
+  uint num_shapes = std::min(host_data.aabb_min_rigid.size(), host_data.id_rigid.size());
+
+  custom_vector<bool> body_sleeping(num_bodies);
+  custom_vector<bool> body_touched(num_bodies, false);
+  for (int i = 0; i < num_bodies; i++) {
+    body_sleeping[i] = bodylist[i]->GetSleeping();
+  }
+
+  custom_vector<real3> fixed_min, fixed_max;
+  for (int i = 0; i < num_shapes; i++) {
+    uint body = host_data.id_rigid[i];
+    if (body_removed[body] && !body_sleeping[body] && !host_data.active_rigid[body]) {
+      fixed_min.push_back(host_data.aabb_min_rigid[i]);
+      fixed_max.push_back(host_data.aabb_max_rigid[i]);
+    }
+  }
+
+  // Several shapes of a body can set its flag at the same time
+#pragma omp parallel for
+  for (int i = 0; i < num_shapes; i++) {
+    uint body = host_data.id_rigid[i];
+    if (!body_sleeping[body] || body_removed[body]) {
+      continue;
+    }
+    for (int k = 0; k < fixed_min.size(); k++) {
+      if (collision::overlap(host_data.aabb_min_rigid[i], host_data.aabb_max_rigid[i], fixed_min[k], fixed_max[k])) {
+        body_touched[body] = true;
+        break;
+      }
+    }
+  }
+
+  std::vector<uint> islands;
+  for (int i = 0; i < num_bodies; i++) {
+    if (body_sleeping[i] && (body_removed[i] || body_touched[i])) {
+      islands.push_back(host_data.sleep_island[i]);
+    }
+  }
+  std::sort(islands.begin(), islands.end());
+  islands.erase(std::unique(islands.begin(), islands.end()), islands.end());
+  if (islands.size() == 0) {
+    return;
+  }
+
+  uint num_woken = 0;
+#pragma omp parallel for reduction(+ : num_woken)
+  for (int i = 0; i < num_bodies; i++) {
+    if (body_sleeping[i] && !body_removed[i] &&
+        std::binary_search(islands.begin(), islands.end(), host_data.sleep_island[i])) {
+      bodylist[i]->SetSleeping(false);
+      sleep_timer[i] = 0;
+      num_woken++;
+    }
+  }
+
+  LOG(TRACE) << "Islands woken by removed bodies: " << islands.size() << " bodies: " << num_woken;
+}
+
+void ChSystemParallel::UpdateDataPlacement() {
+  int num_threads = CHOMPfunctions::GetMaxThreads();
+
+  // The threads must be pinned before the data is touched, all the threads
+  // that a phase of the step may use are pinned. The processors are chosen
+  // again when the policy or the number of threads changes.
+  THREADAFFINITY policy = data_manager->settings.thread_affinity;
+  int num_pinned = std::max(num_threads, data_manager->settings.max_threads);
+  if (policy != affinity_policy || (policy != AFFINITY_NONE && num_pinned != affinity_threads)) {
+    SetThreadAffinity(policy, num_pinned);
+  }
+
+  if (data_manager->settings.numa_first_touch &&
+      (num_threads != first_touch_threads || bodylist.size() != first_touch_bodies)) {
+    data_manager->FirstTouch();
+    first_touch_threads = num_threads;
+    first_touch_bodies = bodylist.size();
+    LOG(TRACE) << "First touch of " << first_touch_bodies << " bodies with " << num_threads << " threads";
+  }
+}
+
+void ChSystemParallel::SetThreadAffinity(THREADAFFINITY policy, int num_threads) {
+#ifdef __linux__
+  // Save the processors the process may run on while no thread is pinned, the
+  // threads get them back when the pinning is turned off
+  if (affinity_policy == AFFINITY_NONE) {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(cpu_set_t), &allowed);
+    process_cpus.clear();
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        process_cpus.push_back(cpu);
+      }
+    }
+  }
+
+  affinity_cpus.clear();
+  if (policy != AFFINITY_NONE) {
+    // Group the allowed processors by socket
+    std::vector<std::vector<int> > sockets;
+    for (int i = 0; i < process_cpus.size(); i++) {
+      int cpu = process_cpus[i];
+      std::stringstream path;
+      path << "/sys/devices/system/cpu/cpu" << cpu << "/topology/physical_package_id";
+      std::ifstream file(path.str().c_str());
+      int socket = 0;
+      if (!(file >> socket) || socket < 0) {
+        socket = 0;
+      }
+      if (socket >= sockets.size()) {
+        sockets.resize(socket + 1);
+      }
+      sockets[socket].push_back(cpu);
+    }
+
+    if (policy == AFFINITY_COMPACT) {
+      for (int s = 0; s < sockets.size(); s++) {
+        affinity_cpus.insert(affinity_cpus.end(), sockets[s].begin(), sockets[s].end());
+      }
+    } else {
+      // Take one processor from every socket in turn
+      for (int k = 0; affinity_cpus.size() < process_cpus.size(); k++) {
+        for (int s = 0; s < sockets.size(); s++) {
+          if (k < sockets[s].size()) {
+            affinity_cpus.push_back(sockets[s][k]);
+          }
+        }
+      }
+    }
+  }
+
+  // Every thread that is or was pinned is visited, including the calling
+  // thread (thread 0), the threads that are not pinned get the process mask
+  int num_team = std::max(num_threads, affinity_threads);
+  if (process_cpus.size() > 0 && num_team > 0) {
+#pragma omp parallel num_threads(num_team)
+    {
+      int thread = CHOMPfunctions::GetThreadNum();
+      cpu_set_t mask;
+      CPU_ZERO(&mask);
+      if (thread < num_threads && affinity_cpus.size() > 0) {
+        CPU_SET(affinity_cpus[thread % affinity_cpus.size()], &mask);
+      } else {
+        for (int i = 0; i < process_cpus.size(); i++) {
+          CPU_SET(process_cpus[i], &mask);
+        }
+      }
+      sched_setaffinity(0, sizeof(cpu_set_t), &mask);
+    }
+  }
+#endif
+
+  affinity_policy = policy;
+  affinity_threads = (policy == AFFINITY_NONE) ? 0 : num_threads;
+}
+
 void ChSystemParallel::RecomputeThreads() {
+  if (data_manager->settings.phase_thread_tuning) {
+    RecomputePhaseThreads();
+    return;
+  }
+
   timer_accumulator.insert(timer_accumulator.begin(), data_manager->system_timer.GetTime("step"));
   timer_accumulator.pop_back();
 
@@ -557,6 +1268,112 @@ void ChSystemParallel::RecomputeThreads() {
   frame_threads++;
 }
 
+// Timers measuring each phase of the step, in the order of THREADPHASE
+static const char* phase_timers[NUM_THREAD_PHASES] = {"update", "collision_broad", "collision_narrow", "lcp"};
+
+//
+// Tune the number of threads of every phase of the step independently. Each
+// phase alternates between timing its accepted number of threads and timing a
+// trial with two more or two less threads, each over a window of steps. A
+// trial is accepted if the phase gets at least 5% faster, otherwise the other
+// direction is tried next. Once both directions failed the phase is settled
+// and only explores again after tuning_hold steps, so it follows changes in the
+// problem size without oscillating between two numbers of threads.
+//
+void ChSystemParallel::RecomputePhaseThreads() {
+  double time[NUM_THREAD_PHASES];
+  for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+    time[p] = data_manager->system_timer.GetTime(phase_timers[p]);
+  }
+  UpdatePhaseThreads(time);
+}
+
+void ChSystemParallel::UpdatePhaseThreads(const double phase_time[NUM_THREAD_PHASES]) {
+  const settings_container& settings = data_manager->settings;
+  thread_measures& measures = data_manager->measures.threads;
+  int window = std::max(settings.tuning_window, 1);
+
+  for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+    PhaseTuning& tuning = phase_tuning[p];
+    if (tuning.threads == 0) {
+      tuning.threads = std::max(settings.min_threads, std::min(CHOMPfunctions::GetMaxThreads(), settings.max_threads));
+      tuning.trial = 0;
+      tuning.direction = 1;
+      tuning.rejected = 0;
+      tuning.hold = 0;
+      tuning.baseline = 0;
+      tuning.sum = 0;
+      measures.num_threads[p] = tuning.threads;
+    }
+    tuning.sum += phase_time[p];
+  }
+
+  if (++frame_phase < uint(window)) {
+    return;
+  }
+  frame_phase = 0;
+
+  for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+    PhaseTuning& tuning = phase_tuning[p];
+    double time = tuning.sum / window;
+    tuning.sum = 0;
+    measures.phase_time[p] = time;
+
+    if (tuning.trial != 0) {
+      // End of a trial, the accepted number of threads is timed again next
+      if (time < 0.95 * tuning.baseline) {
+        LOG(INFO) << "Phase " << phase_timers[p] << ": " << tuning.threads << " -> " << tuning.trial << " threads";
+        tuning.threads = tuning.trial;
+        tuning.rejected = 0;
+        measures.num_changes++;
+      } else {
+        tuning.direction = -tuning.direction;
+        tuning.rejected++;
+        if (tuning.rejected >= 2) {
+          tuning.hold = settings.tuning_hold;
+        }
+      }
+      tuning.trial = 0;
+    } else if (tuning.hold > 0) {
+      tuning.baseline = time;
+      tuning.hold -= window;
+      if (tuning.hold <= 0) {
+        tuning.rejected = 0;
+      }
+    } else {
+      // Pick the next trial, turning around at the thread limits
+      tuning.baseline = time;
+      for (int attempt = 0; attempt < 2 && tuning.trial == 0; attempt++) {
+        int trial = tuning.threads + 2 * tuning.direction;
+        trial = std::max(settings.min_threads, std::min(trial, settings.max_threads));
+        if (trial != tuning.threads) {
+          tuning.trial = trial;
+        } else {
+          tuning.direction = -tuning.direction;
+        }
+      }
+      if (tuning.trial == 0) {
+        tuning.hold = settings.tuning_hold;
+      }
+    }
+
+    measures.num_threads[p] = tuning.trial != 0 ? tuning.trial : tuning.threads;
+    measures.settled[p] = tuning.hold > 0;
+  }
+}
+
+void ChSystemParallel::PrintThreadReport() {
+  const thread_measures& measures = data_manager->measures.threads;
+  std::cout << "Thread Report:" << std::endl;
+  std::cout << "------------" << std::endl;
+  for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+    std::cout << "Phase:\t" << phase_timers[p] << "\t" << measures.num_threads[p] << "\t" << measures.phase_time[p]
+              << "\t" << (measures.settled[p] ? "settled" : "exploring") << std::endl;
+  }
+  std::cout << "Changes:\t" << measures.num_changes << std::endl;
+  std::cout << "------------" << std::endl;
+}
+
 void ChSystemParallel::ChangeCollisionSystem(COLLISIONSYSTEMTYPE type) {
   assert(GetNbodies() == 0);
 
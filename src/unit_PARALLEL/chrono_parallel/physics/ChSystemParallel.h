@@ -53,6 +53,9 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
 
   virtual int Integrate_Y();
   virtual void AddBody(ChSharedPtr<ChBody> newbody);
+  // The body is only queued for removal, it stays in the body list until the
+  // start of the next step where all the queued bodies are removed in batch
+  virtual void RemoveBody(ChSharedPtr<ChBody> mbody);
   virtual void AddOtherPhysicsItem(ChSharedPtr<ChPhysicsItem> newitem);
 
   void ClearForceVariables();
@@ -63,10 +66,28 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
   void UpdateRigidBodies();
   void UpdateShafts();
   void UpdateFluidBodies();
+  // Copy the state of the rigid bodies kept in the data manager into the ChBody
+  // objects, only needed when settings.host_body_state is enabled
+  void SyncBodies();
   void RecomputeThreads();
+  // Advance the per phase thread tuning by one step given the time of every
+  // phase, in the order of THREADPHASE. Called with the measured times at every
+  // step when settings.phase_thread_tuning is enabled, the numbers of threads
+  // picked are in data_manager->measures.threads
+  void UpdatePhaseThreads(const double phase_time[NUM_THREAD_PHASES]);
+  // Print the number of threads picked for each phase of the step by the
+  // per phase thread tuning, see settings.phase_thread_tuning
+  void PrintThreadReport();
+  // Put to sleep the islands of bodies that came to rest and wake up the
+  // sleeping islands that are in contact with a moving body
+  void UpdateSleepingBodies();
+  // Store the timers and solver counters of the step that just finished, does
+  // nothing unless a record capacity was set on the system timer
+  void RecordStep();
 
   virtual void AddMaterialSurfaceData(ChSharedPtr<ChBody> newbody) = 0;
   virtual void UpdateMaterialSurfaceData(int index, ChBody* body) = 0;
+  virtual void RemoveMaterialSurfaceData(const custom_vector<uint>& body_removed) = 0;
   virtual void Setup();
   virtual void ChangeCollisionSystem(COLLISIONSYSTEMTYPE type);
 
@@ -99,6 +120,12 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
   virtual real3 GetBodyContactForce(uint body_id) const = 0;
   virtual real3 GetBodyContactTorque(uint body_id) const = 0;
 
+  // The bodies are renumbered when bodies are removed or reordered, the stable
+  // id of a body is its insertion order and never changes
+  uint GetBodyStableId(int index) const { return data_manager->host_data.uid_rigid[index]; }
+  // Current index of a body from its stable id, -1 if the body was removed
+  int GetBodyIndex(uint stable_id) const { return body_index[stable_id]; }
+
   settings_container* GetSettings() { return &(data_manager->settings); }
 
   // based on the passed logging level and the state of that level, enable or
@@ -118,9 +145,58 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
   int current_threads;
   int detect_optimal_bins;
   std::vector<double> timer_accumulator, cd_accumulator;
-  uint frame_threads, frame_bins, counter;
+  uint frame_threads, frame_bins, frame_reorder, frame_phase, counter;
   std::vector<ChLink*>::iterator it;
 
+  // Remove the bodies queued by RemoveBody() and the shapes of the removed
+  // collision models, compacting the system-wide body and shape vectors
+  void FlushRemovedBodies();
+  // Wake up the sleeping islands that contain a removed body or rest on a
+  // removed fixed body
+  void WakeRemovedIslands(const custom_vector<uint>& body_removed);
+  // Sort the bodies and their shapes along a space filling curve through the
+  // body positions, see settings.reorder_frequency
+  void ReorderBodies();
+
+  // Used instead of the ChBody objects when the state of the bodies is kept in
+  // the data manager: load the velocities and applied forces, advance the
+  // positions and rotations, and copy the state of a single body back
+  void LoadRigidBodyForces();
+  void IntegrateRigidBodies();
+  void SyncBody(ChBody* body);
+
+  // Pin the threads and first touch the body and shape arrays according to the
+  // settings, only redone when the number of threads or bodies changed
+  void UpdateDataPlacement();
+  // Pin the first num_threads OpenMP threads according to the policy, with
+  // AFFINITY_NONE the threads get the processors of the process back
+  void SetThreadAffinity(THREADAFFINITY policy, int num_threads);
+
+  // Hill climbing state of the number of threads of one phase of the step
+  struct PhaseTuning {
+    int threads;      // Accepted number of threads, 0 before the first step
+    int trial;        // Number of threads being tried, 0 while timing the accepted number
+    int direction;    // Direction of the next trial, +1 or -1
+    int rejected;     // Number of trials rejected in a row
+    int hold;         // Steps left before exploring again once settled
+    double baseline;  // Average time of the phase with the accepted number of threads
+    double sum;       // Time of the phase accumulated over the current window
+  };
+  void RecomputePhaseThreads();
+  PhaseTuning phase_tuning[NUM_THREAD_PHASES];
+
+  std::vector<ChBody*> removed_bodies;
+  // Current index of every body from its stable id, -1 for removed bodies
+  std::vector<int> body_index;
+
+  int affinity_threads, first_touch_threads, first_touch_bodies;
+  // Policy the threads are currently pinned with
+  THREADAFFINITY affinity_policy;
+  // The processors the threads are pinned to, in the order of the thread ids
+  std::vector<int> affinity_cpus;
+  // The processors the process could run on before the threads were pinned
+  std::vector<int> process_cpus;
+
  private:
   void AddShaft(ChSharedPtr<ChShaft> shaft);
 
@@ -139,6 +215,7 @@ class CH_PARALLEL_API ChSystemParallelDVI : public ChSystemParallel {
   virtual ChBody::ContactMethod GetContactMethod() const { return ChBody::DVI; }
   virtual void AddMaterialSurfaceData(ChSharedPtr<ChBody> newbody);
   virtual void UpdateMaterialSurfaceData(int index, ChBody* body);
+  virtual void RemoveMaterialSurfaceData(const custom_vector<uint>& body_removed);
 
   void CalculateContactForces();
 
@@ -158,6 +235,7 @@ class CH_PARALLEL_API ChSystemParallelDEM : public ChSystemParallel {
   virtual ChBody::ContactMethod GetContactMethod() const { return ChBody::DEM; }
   virtual void AddMaterialSurfaceData(ChSharedPtr<ChBody> newbody);
   virtual void UpdateMaterialSurfaceData(int index, ChBody* body);
+  virtual void RemoveMaterialSurfaceData(const custom_vector<uint>& body_removed);
 
   virtual void Setup();
   virtual void ChangeCollisionSystem(COLLISIONSYSTEMTYPE type);
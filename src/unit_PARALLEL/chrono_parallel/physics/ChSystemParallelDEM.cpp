@@ -30,13 +30,6 @@ void ChSystemParallelDEM::AddMaterialSurfaceData(ChSharedPtr<ChBody> newbody) {
   } else {
     data_manager->host_data.dem_coeffs.push_back(R4(0, 0, 0, 0));
   }
-
-  if (data_manager->settings.solver.tangential_displ_mode == MULTI_STEP) {
-    for (int i = 0; i < max_shear; i++) {
-      data_manager->host_data.shear_neigh.push_back(I3(-1, -1, -1));
-      data_manager->host_data.shear_disp.push_back(R3(0, 0, 0));
-    }
-  }
 }
 
 void ChSystemParallelDEM::UpdateMaterialSurfaceData(int index, ChBody* body) {
@@ -66,6 +59,19 @@ void ChSystemParallelDEM::UpdateMaterialSurfaceData(int index, ChBody* body) {
   }
 }
 
+void ChSystemParallelDEM::RemoveMaterialSurfaceData(const custom_vector<uint>& body_removed) {
+  Thrust_Compact(data_manager->host_data.mu, body_removed);
+  Thrust_Compact(data_manager->host_data.cohesion_data, body_removed);
+  Thrust_Compact(data_manager->host_data.mass_rigid, body_removed);
+
+  if (data_manager->settings.solver.use_material_properties) {
+    Thrust_Compact(data_manager->host_data.elastic_moduli, body_removed);
+    Thrust_Compact(data_manager->host_data.cr, body_removed);
+  } else {
+    Thrust_Compact(data_manager->host_data.dem_coeffs, body_removed);
+  }
+}
+
 void ChSystemParallelDEM::Setup() {
   // First, invoke the base class method
   ChSystemParallel::Setup();
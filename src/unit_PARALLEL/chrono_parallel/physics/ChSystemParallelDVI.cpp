@@ -53,6 +53,12 @@ void ChSystemParallelDVI::UpdateMaterialSurfaceData(int index, ChBody* body) {
                          mat_ptr->GetComplianceSpinning());
 }
 
+void ChSystemParallelDVI::RemoveMaterialSurfaceData(const custom_vector<uint>& body_removed) {
+  Thrust_Compact(data_manager->host_data.fric_data, body_removed);
+  Thrust_Compact(data_manager->host_data.cohesion_data, body_removed);
+  Thrust_Compact(data_manager->host_data.compliance_data, body_removed);
+}
+
 void ChSystemParallelDVI::CalculateContactForces() {
   uint num_contacts = data_manager->num_rigid_contacts;
   DynamicVector<real>& Fc = data_manager->host_data.Fc;
@@ -67,6 +73,13 @@ void ChSystemParallelDVI::CalculateContactForces() {
 
   DynamicVector<real>& gamma = data_manager->host_data.gamma;
 
+  if (data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    ChLcpSolverParallelDVI* solver = (ChLcpSolverParallelDVI*)(LCP_solver_speed);
+    solver->GetRigidRigid().Apply_D(data_manager->settings.solver.solver_mode, gamma, Fc);
+    Fc = Fc / data_manager->settings.step_size;
+    return;
+  }
+
   switch (data_manager->settings.solver.solver_mode) {
     case NORMAL: {
       const CompressedMatrix<real>& D_n = data_manager->host_data.D_n;
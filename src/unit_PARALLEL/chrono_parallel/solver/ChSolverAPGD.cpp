@@ -36,7 +36,13 @@ void ChSolverAPGD::UpdateR() {
   SubVectorType R_n = blaze::subvector(R, 0, num_contacts);
   SubVectorType s_n = blaze::subvector(s, 0, num_contacts);
 
-  R_n = -b_n - D_n_T * M_invk - s_n;
+  if (data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    D_T_M_invk.resize(data_manager->num_constraints);
+    rigid_rigid->Apply_D_T(NORMAL, M_invk, D_T_M_invk);
+    R_n = -b_n - blaze::subvector(D_T_M_invk, 0, num_contacts) - s_n;
+  } else {
+    R_n = -b_n - D_n_T * M_invk - s_n;
+  }
 }
 
 uint ChSolverAPGD::SolveAPGD(const uint max_iter,
@@ -37,6 +37,9 @@ class CH_PARALLEL_API ChSolverJacobi : public ChSolverParallel {
     data_manager->system_timer.stop("ChSolverParallel_Solve");
   }
 
+  // The Schur complement is assembled from D_T and M_invD
+  bool RequiresAssembledJacobian() const { return true; }
+
   // Solve using the Jacobi method
   uint SolveJacobi(const uint max_iter,            // Maximum number of iterations
                    const uint size,                // Number of unknowns
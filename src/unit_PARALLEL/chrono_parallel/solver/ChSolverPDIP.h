@@ -90,6 +90,9 @@ class CH_PARALLEL_API ChSolverPDIP : public ChSolverParallel {
     data_manager->system_timer.stop("ChSolverParallel_Solve");
   }
 
+  // The Newton step products use the assembled D_T and M_invD
+  bool RequiresAssembledJacobian() const { return true; }
+
   // Solve using the primal-dual interior point method
   uint SolvePDIP(const uint max_iter,                  // Maximum number of iterations
                  const uint size,                      // Number of unknowns
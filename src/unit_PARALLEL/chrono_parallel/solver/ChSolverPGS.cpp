@@ -1,46 +1,268 @@
 #include "chrono_parallel/solver/ChSolverPGS.h"
 #include <blaze/math/SparseRow.h>
 #include <blaze/math/CompressedVector.h>
+
+#include <thrust/fill.h>
+#include <thrust/extrema.h>
+
 using namespace chrono;
 
+// The colors used by a body are stored as bits, contacts that cannot get one
+// of these colors are put in one extra color that is processed sequentially
+#define PGS_MAX_COLORS 64
+
+// Dot product of a row of a jacobian with a vector of velocities
+static inline real function_Row_Dot(const CompressedMatrix<real>& D_T, const uint row, const DynamicVector<real>& v) {
+  real sum = 0;
+  for (CompressedMatrix<real>::ConstIterator it = D_T.begin(row); it != D_T.end(row); ++it) {
+    sum += it->value() * v[it->index()];
+  }
+  return sum;
+}
+
+// v += M^-1 * D_row * delta, M^-1 is symmetric so its rows are used instead
+// of its columns. Only the entries of the bodies in the row are written.
+static inline void function_Row_Update(const CompressedMatrix<real>& D_T,
+                                       const CompressedMatrix<real>& M_inv,
+                                       const uint row,
+                                       const real delta,
+                                       DynamicVector<real>& v) {
+  for (CompressedMatrix<real>::ConstIterator it = D_T.begin(row); it != D_T.end(row); ++it) {
+    real scale = it->value() * delta;
+    for (CompressedMatrix<real>::ConstIterator it2 = M_inv.begin(it->index()); it2 != M_inv.end(it->index()); ++it2) {
+      v[it2->index()] += it2->value() * scale;
+    }
+  }
+}
+
+// Diagonal entry of D^T * M^-1 * D for a row of the jacobian
+static inline real function_Row_Diagonal(const CompressedMatrix<real>& D_T,
+                                         const CompressedMatrix<real>& M_inv,
+                                         const uint row) {
+  real sum = 0;
+  for (CompressedMatrix<real>::ConstIterator it = D_T.begin(row); it != D_T.end(row); ++it) {
+    for (CompressedMatrix<real>::ConstIterator it2 = M_inv.begin(it->index()); it2 != M_inv.end(it->index()); ++it2) {
+      sum += it->value() * it2->value() * D_T(row, it2->index());
+    }
+  }
+  return sum;
+}
+
+// Jacobian rows and multiplier indices of a contact for the given solver mode,
+// the normal and the two tangential rows come first followed by the rolling rows
+static inline uint function_Contact_Rows(const uint index,
+                                         const uint num_contacts,
+                                         const SOLVERMODE mode,
+                                         const host_container& host_data,
+                                         const CompressedMatrix<real>** D_T,
+                                         uint* rows,
+                                         uint* ids) {
+  D_T[0] = &host_data.D_n_T;
+  rows[0] = index;
+  ids[0] = index;
+  if (mode == NORMAL) {
+    return 1;
+  }
+  for (int k = 0; k < 2; k++) {
+    D_T[1 + k] = &host_data.D_t_T;
+    rows[1 + k] = index * 2 + k;
+    ids[1 + k] = num_contacts + index * 2 + k;
+  }
+  if (mode == SLIDING) {
+    return 3;
+  }
+  for (int k = 0; k < 3; k++) {
+    D_T[3 + k] = &host_data.D_s_T;
+    rows[3 + k] = index * 3 + k;
+    ids[3 + k] = 3 * num_contacts + index * 3 + k;
+  }
+  return 6;
+}
+
+void ChSolverPGS::ColorContacts() {
+  const custom_vector<int2>& bids = data_manager->host_data.bids_rigid_rigid;
+  const custom_vector<bool>& active = data_manager->host_data.active_rigid;
+  uint num_contacts = data_manager->num_rigid_contacts;
+
+  contact_color.resize(num_contacts);
+  color_contacts.resize(num_contacts);
+  body_colors.resize(data_manager->num_rigid_bodies);
+  color_start.resize(PGS_MAX_COLORS + 2);
+  thrust::fill(body_colors.begin(), body_colors.end(), 0);
+  thrust::fill(color_start.begin(), color_start.end(), 0);
+  num_colors = 0;
+
+  // Greedy coloring, each contact takes the first color not used by either
+  // of its bodies. This pass is sequential but linear in the number of contacts.
+  for (int i = 0; i < num_contacts; i++) {
+    int2 body = bids[i];
+    unsigned long long used = 0;
+    if (active[body.x]) {
+      used |= body_colors[body.x];
+    }
+    if (active[body.y]) {
+      used |= body_colors[body.y];
+    }
+
+    uint color = 0;
+    while (color < PGS_MAX_COLORS && (used & (1ULL << color))) {
+      color++;
+    }
+    if (color < PGS_MAX_COLORS) {
+      if (active[body.x]) {
+        body_colors[body.x] |= 1ULL << color;
+      }
+      if (active[body.y]) {
+        body_colors[body.y] |= 1ULL << color;
+      }
+    }
+    contact_color[i] = color;
+    color_start[color + 1]++;
+    num_colors = std::max(num_colors, color + 1);
+  }
+
+  // Counting sort of the contacts by color, keeps the order of the contacts
+  // within a color so that the solution does not depend on the thread count
+  for (int c = 1; c < PGS_MAX_COLORS + 2; c++) {
+    color_start[c] += color_start[c - 1];
+  }
+  custom_vector<uint> offset = color_start;
+  for (int i = 0; i < num_contacts; i++) {
+    color_contacts[offset[contact_color[i]]++] = i;
+  }
+  color_start.resize(num_colors + 1);
+
+  data_manager->measures.solver.num_colors = num_colors;
+  LOG(TRACE) << "ChSolverPGS::ColorContacts colors: " << num_colors;
+}
+
+real ChSolverPGS::UpdateContact(const uint index, const DynamicVector<real>& mb, DynamicVector<real>& ml) {
+  const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+  const DynamicVector<real>& E = data_manager->host_data.E;
+  uint num_contacts = data_manager->num_rigid_contacts;
+  SOLVERMODE mode = data_manager->settings.solver.local_solver_mode;
+
+  const CompressedMatrix<real>* D_T[6];
+  uint rows[6], ids[6];
+  real old_gamma[6];
+  uint num_rows = function_Contact_Rows(index, num_contacts, mode, data_manager->host_data, D_T, rows, ids);
+  for (uint k = 0; k < num_rows; k++) {
+    old_gamma[k] = ml[ids[k]];
+  }
+
+  // The normal and tangential rows share one step size, as do the rolling rows
+  for (uint start = 0; start < num_rows; start += 3) {
+    uint end = std::min(start + 3, num_rows);
+    real sum_diagonal = 0;
+    for (uint k = start; k < end; k++) {
+      sum_diagonal += diagonal[ids[k]];
+    }
+    if (sum_diagonal <= 0) {
+      continue;
+    }
+    real Dinv = (end - start) / sum_diagonal;
+    for (uint k = start; k < end; k++) {
+      real g = function_Row_Dot(*D_T[k], rows[k], M_invDx) + E[ids[k]] * old_gamma[k] - mb[ids[k]];
+      ml[ids[k]] = old_gamma[k] - Dinv * g;
+    }
+  }
+
+  rigid_rigid->Project_Single(index, ml.data());
+
+  // Propagate the change to the velocities of the two bodies
+  real max_delta = 0;
+  for (uint k = 0; k < num_rows; k++) {
+    real delta = ml[ids[k]] - old_gamma[k];
+    if (delta != 0) {
+      function_Row_Update(*D_T[k], M_inv, rows[k], delta, M_invDx);
+      max_delta = std::max(max_delta, std::abs(delta));
+    }
+  }
+  return max_delta;
+}
+
 uint ChSolverPGS::SolvePGS(const uint max_iter,
                            const uint size,
                            DynamicVector<real>& mb,
                            DynamicVector<real>& ml) {
-  //  real& residual = data_manager->measures.solver.residual;
-  //  real& objective_value = data_manager->measures.solver.objective_value;
-  //  custom_vector<real>& iter_hist = data_manager->measures.solver.iter_hist;
-  //
-  //  real rmax = 0, flimit, aux;
-  //  diagonal.resize(size, false);
-  //
-  //  for (size_t i = 0; i < size; ++i) {
-  //    const real tmp(data_manager->host_data.Nshur(i, i));
-  //    diagonal[i] = real(1) / tmp;
-  //  }
-  //
-  //  Project(ml.data());
-  //
-  //  for (current_iteration = 0; current_iteration < max_iter; current_iteration++) {
-  //    const size_t N(size / 3);
-  //    size_t j;
-  //    real omega = 1.0;
-  //
-  //    for (size_t i = 0; i < data_manager->num_contacts; ++i) {
-  //      j = i * 3;
-  //      real Dinv = 1.0 / (diagonal[j + 0] + diagonal[j + 1] + diagonal[j + 2]);
-  //
-  //      ml[j + 0] = ml[j + 0] - omega * Dinv * ((row(data_manager->host_data.Nshur, j + 0), ml) - mb[j + 0]);
-  //      ml[j + 1] = ml[j + 1] - omega * Dinv * ((row(data_manager->host_data.Nshur, j + 1), ml) - mb[j + 1]);
-  //      ml[j + 2] = ml[j + 2] - omega * Dinv * ((row(data_manager->host_data.Nshur, j + 2), ml) - mb[j + 2]);
-  //
-  //      Project_Single(i, ml.data());
-  //    }
-  //    residual = Res4Blaze(ml, mb);
-  //    objective_value = GetObjective(ml, mb);
-  //    AtIterationEnd(residual, objective_value);
-  //  }
-  //
-  //  return current_iteration;
-  return 0;
+  real& residual = data_manager->measures.solver.residual;
+  real& objective_value = data_manager->measures.solver.objective_value;
+
+  const CompressedMatrix<real>& D_b_T = data_manager->host_data.D_b_T;
+  const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+  const DynamicVector<real>& E = data_manager->host_data.E;
+  SOLVERMODE mode = data_manager->settings.solver.local_solver_mode;
+
+  uint num_contacts = data_manager->num_rigid_contacts;
+  uint num_unilaterals = data_manager->num_unilaterals;
+  uint num_bilaterals = data_manager->num_bilaterals;
+
+  ColorContacts();
+
+  diagonal.resize(size, false);
+  reset(diagonal);
+  contact_delta.resize(num_contacts);
+
+#pragma omp parallel for
+  for (int i = 0; i < num_contacts; i++) {
+    const CompressedMatrix<real>* D_T[6];
+    uint rows[6], ids[6];
+    uint num_rows = function_Contact_Rows(i, num_contacts, mode, data_manager->host_data, D_T, rows, ids);
+    for (uint k = 0; k < num_rows; k++) {
+      diagonal[ids[k]] = function_Row_Diagonal(*D_T[k], M_inv, rows[k]) + E[ids[k]];
+    }
+  }
+#pragma omp parallel for
+  for (int i = 0; i < num_bilaterals; i++) {
+    diagonal[num_unilaterals + i] = function_Row_Diagonal(D_b_T, M_inv, i) + E[num_unilaterals + i];
+  }
+
+  Project(ml.data());
+
+  // M_invDx = M^-1 * D * ml for the constraints used in this solve
+  ConstSubVectorType ml_b = blaze::subvector(ml, num_unilaterals, num_bilaterals);
+  ConstSubVectorType ml_n = blaze::subvector(ml, 0, num_contacts);
+  M_invDx = data_manager->host_data.M_invD_b * ml_b + data_manager->host_data.M_invD_n * ml_n;
+  if (mode == SLIDING || mode == SPINNING) {
+    M_invDx += data_manager->host_data.M_invD_t * blaze::subvector(ml, num_contacts, num_contacts * 2);
+  }
+  if (mode == SPINNING) {
+    M_invDx += data_manager->host_data.M_invD_s * blaze::subvector(ml, num_contacts * 3, num_contacts * 3);
+  }
+
+  for (current_iteration = 0; current_iteration < max_iter; current_iteration++) {
+    // Contacts in the same color do not share a body and are updated in
+    // parallel, the last color is sequential if the colors ran out
+    for (int c = 0; c < num_colors; c++) {
+#pragma omp parallel for if (c < PGS_MAX_COLORS)
+      for (int k = color_start[c]; k < color_start[c + 1]; k++) {
+        uint index = color_contacts[k];
+        contact_delta[index] = UpdateContact(index, mb, ml);
+      }
+    }
+
+    // The bilaterals can share bodies in any pattern, update them in sequence
+    real max_delta = num_contacts > 0 ? Thrust_Max(contact_delta) : 0;
+    for (int i = 0; i < num_bilaterals; i++) {
+      uint id = num_unilaterals + i;
+      if (diagonal[id] <= 0) {
+        continue;
+      }
+      real g = function_Row_Dot(D_b_T, i, M_invDx) + E[id] * ml[id] - mb[id];
+      real delta = -g / diagonal[id];
+      ml[id] += delta;
+      function_Row_Update(D_b_T, M_inv, i, delta, M_invDx);
+      max_delta = std::max(max_delta, std::abs(delta));
+    }
+
+    residual = max_delta;
+    objective_value = 0;
+    AtIterationEnd(residual, objective_value);
+
+    if (residual < data_manager->settings.solver.tol_speed) {
+      break;
+    }
+  }
+
+  return current_iteration;
 }
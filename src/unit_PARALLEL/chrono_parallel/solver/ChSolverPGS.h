@@ -12,7 +12,11 @@
 // Authors: Hammad Mazhar
 // =============================================================================
 //
-// Implementation of an iterative Conjugate Gradient solver.
+// Implementation of a projected Gauss-Seidel solver. The contacts are colored
+// so that no two contacts with the same color act on the same body, the
+// contacts in one color are then updated in parallel. The velocity change
+// M^-1*D*gamma is kept up to date after every contact update so that each
+// update sees the latest values of the contacts before it.
 // =============================================================================
 
 #ifndef CHSOLVERPGS_H
@@ -37,14 +41,32 @@ class CH_PARALLEL_API ChSolverPGS : public ChSolverParallel {
     data_manager->system_timer.stop("ChSolverParallel_Solve");
   }
 
-  // Solve using an iterative projected gradient method
+  // The contact updates read the rows of D_n_T, D_t_T and D_s_T
+  bool RequiresAssembledJacobian() const { return true; }
+
+  // Solve using an iterative projected gauss-seidel method
   uint SolvePGS(const uint max_iter,            // Maximum number of iterations
                 const uint size,                // Number of unknowns
                 DynamicVector<real>& b,  // Rhs vector
                 DynamicVector<real>& x   // The vector of unknowns
                 );
 
+  // Greedy coloring of the contact graph, contacts with fixed bodies do not
+  // conflict through that body because its velocity is never updated
+  void ColorContacts();
+  // Update the multipliers of a single contact and the velocity change
+  real UpdateContact(const uint index, const DynamicVector<real>& b, DynamicVector<real>& x);
+
   DynamicVector<real> diagonal;
+  // Velocity change due to the current multipliers, M^-1*D*x
+  DynamicVector<real> M_invDx;
+
+  custom_vector<uint> contact_color;   // Color of each contact
+  custom_vector<uint> color_contacts;  // Contact indices sorted by color
+  custom_vector<uint> color_start;     // Offset of each color in color_contacts
+  custom_vector<unsigned long long> body_colors;  // Colors used by the contacts of each body, one bit per color
+  custom_vector<real> contact_delta;   // Largest change of the multipliers of each contact in the last sweep
+  uint num_colors;
 };
 }
 
@@ -7,18 +7,19 @@ ChSolverParallel::ChSolverParallel() {
   current_iteration = 0;
   rigid_rigid = NULL;
   bilateral = NULL;
+  timer_shur_product = timer_project = -1;
 }
 
 void ChSolverParallel::Project(real* gamma) {
-  data_manager->system_timer.start("ChSolverParallel_Project");
+  data_manager->system_timer.start(timer_project);
   rigid_rigid->Project(gamma);
-  data_manager->system_timer.stop("ChSolverParallel_Project");
+  data_manager->system_timer.stop(timer_project);
 }
 
 void ChSolverParallel::Project_Single(int index, real* gamma) {
-  data_manager->system_timer.start("ChSolverParallel_Project");
+  data_manager->system_timer.start(timer_project);
   rigid_rigid->Project_Single(index, gamma);
-  data_manager->system_timer.stop("ChSolverParallel_Project");
+  data_manager->system_timer.stop(timer_project);
 }
 //=================================================================================================================================
 
@@ -33,7 +34,7 @@ void ChSolverParallel::ComputeSRhs(custom_vector<real>& gamma,
 }
 
 void ChSolverParallel::ShurProduct(const DynamicVector<real>& x, DynamicVector<real>& output) {
-  data_manager->system_timer.start("ShurProduct");
+  data_manager->system_timer.start(timer_shur_product);
 
   const CompressedMatrix<real>& D_n_T = data_manager->host_data.D_n_T;
   const CompressedMatrix<real>& D_t_T = data_manager->host_data.D_t_T;
@@ -59,16 +60,23 @@ void ChSolverParallel::ShurProduct(const DynamicVector<real>& x, DynamicVector<r
   ConstSubVectorType x_n = blaze::subvector(x, 0, num_contacts);
   ConstSubVectorType E_n = blaze::subvector(E, 0, num_contacts);
 
+  if (data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+    ShurProductMatrixFree(x, output);
+    data_manager->system_timer.stop(timer_shur_product);
+    return;
+  }
+
   switch (data_manager->settings.solver.local_solver_mode) {
     case BILATERAL: {
-      o_b = D_b_T * (M_invD_b * x_b) + E_b * x_b;
+      M_invD_x = M_invD_b * x_b;
+      o_b = D_b_T * M_invD_x + E_b * x_b;
 
     } break;
 
     case NORMAL: {
-      DynamicVector<real> tmp = M_invD_b * x_b + M_invD_n * x_n;
-      o_b = D_b_T * tmp + E_b * x_b;
-      o_n = D_n_T * tmp + E_n * x_n;
+      M_invD_x = M_invD_b * x_b + M_invD_n * x_n;
+      o_b = D_b_T * M_invD_x + E_b * x_b;
+      o_n = D_n_T * M_invD_x + E_n * x_n;
 
     } break;
 
@@ -77,10 +85,10 @@ void ChSolverParallel::ShurProduct(const DynamicVector<real>& x, DynamicVector<r
       ConstSubVectorType x_t = blaze::subvector(x, num_contacts, num_contacts * 2);
       ConstSubVectorType E_t = blaze::subvector(E, num_contacts, num_contacts * 2);
 
-      DynamicVector<real> tmp = M_invD_b * x_b + M_invD_n * x_n + M_invD_t * x_t;
-      o_b = D_b_T * tmp + E_b * x_b;
-      o_n = D_n_T * tmp + E_n * x_n;
-      o_t = D_t_T * tmp + E_t * x_t;
+      M_invD_x = M_invD_b * x_b + M_invD_n * x_n + M_invD_t * x_t;
+      o_b = D_b_T * M_invD_x + E_b * x_b;
+      o_n = D_n_T * M_invD_x + E_n * x_n;
+      o_t = D_t_T * M_invD_x + E_t * x_t;
 
     } break;
 
@@ -93,16 +101,57 @@ void ChSolverParallel::ShurProduct(const DynamicVector<real>& x, DynamicVector<r
       ConstSubVectorType x_s = blaze::subvector(x, num_contacts * 3, num_contacts * 3);
       ConstSubVectorType E_s = blaze::subvector(E, num_contacts * 3, num_contacts * 3);
 
-      DynamicVector<real> tmp = M_invD_b * x_b + M_invD_n * x_n + M_invD_t * x_t + M_invD_s * x_s;
-      o_b = D_b_T * tmp + E_b * x_b;
-      o_n = D_n_T * tmp + E_n * x_n;
-      o_t = D_t_T * tmp + E_t * x_t;
-      o_s = D_s_T * tmp + E_s * x_s;
+      M_invD_x = M_invD_b * x_b + M_invD_n * x_n + M_invD_t * x_t + M_invD_s * x_s;
+      o_b = D_b_T * M_invD_x + E_b * x_b;
+      o_n = D_n_T * M_invD_x + E_n * x_n;
+      o_t = D_t_T * M_invD_x + E_t * x_t;
+      o_s = D_s_T * M_invD_x + E_s * x_s;
 
     } break;
   }
 
-  data_manager->system_timer.stop("ShurProduct");
+  data_manager->system_timer.stop(timer_shur_product);
+}
+
+void ChSolverParallel::ShurProductMatrixFree(const DynamicVector<real>& x, DynamicVector<real>& output) {
+  const CompressedMatrix<real>& D_b_T = data_manager->host_data.D_b_T;
+  const CompressedMatrix<real>& M_invD_b = data_manager->host_data.M_invD_b;
+  const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+  const DynamicVector<real>& E = data_manager->host_data.E;
+  SOLVERMODE local_solver_mode = data_manager->settings.solver.local_solver_mode;
+
+  uint num_contacts = data_manager->num_rigid_contacts;
+  uint num_unilaterals = data_manager->num_unilaterals;
+  uint num_bilaterals = data_manager->num_bilaterals;
+
+  SubVectorType o_b = blaze::subvector(output, num_unilaterals, num_bilaterals);
+  ConstSubVectorType x_b = blaze::subvector(x, num_unilaterals, num_bilaterals);
+  ConstSubVectorType E_b = blaze::subvector(E, num_unilaterals, num_bilaterals);
+
+  if (local_solver_mode == BILATERAL) {
+    o_b = D_b_T * (M_invD_b * x_b) + E_b * x_b;
+    return;
+  }
+
+  // M_invD_x = M_inv * D * x, then output = D^T * M_invD_x + E * x
+  rigid_rigid->Apply_D(local_solver_mode, x, D_x);
+  M_invD_x = M_invD_b * x_b + M_inv * D_x;
+  rigid_rigid->Apply_D_T(local_solver_mode, M_invD_x, output);
+  o_b = D_b_T * M_invD_x + E_b * x_b;
+
+  SubVectorType o_n = blaze::subvector(output, 0, num_contacts);
+  o_n += blaze::subvector(E, 0, num_contacts) * blaze::subvector(x, 0, num_contacts);
+
+  if (local_solver_mode == SLIDING || local_solver_mode == SPINNING) {
+    SubVectorType o_t = blaze::subvector(output, num_contacts, num_contacts * 2);
+    o_t += blaze::subvector(E, num_contacts, num_contacts * 2) * blaze::subvector(x, num_contacts, num_contacts * 2);
+  }
+
+  if (local_solver_mode == SPINNING) {
+    SubVectorType o_s = blaze::subvector(output, num_contacts * 3, num_contacts * 3);
+    o_s += blaze::subvector(E, num_contacts * 3, num_contacts * 3) *
+           blaze::subvector(x, num_contacts * 3, num_contacts * 3);
+  }
 }
 
 void ChSolverParallel::ShurBilaterals(const DynamicVector<real>& x, DynamicVector<real>& output) {
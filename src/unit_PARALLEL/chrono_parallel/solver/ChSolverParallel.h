@@ -33,7 +33,22 @@ class CH_PARALLEL_API ChSolverParallel {
   ChSolverParallel();
   virtual ~ChSolverParallel() {}
 
-  void Setup(ChParallelDataManager* data_container_) { data_manager = data_container_; }
+  // Called before the jacobians of every step are computed. Solvers that read
+  // the rows of the assembled contact jacobians switch the jacobian storage
+  // back to CSR.
+  void Setup(ChParallelDataManager* data_container_) {
+    data_manager = data_container_;
+    timer_shur_product = data_manager->system_timer.AddTimer("ShurProduct");
+    timer_project = data_manager->system_timer.AddTimer("ChSolverParallel_Project");
+    if (RequiresAssembledJacobian() && data_manager->settings.solver.jacobian_storage != JACOBIAN_CSR) {
+      LOG(WARNING) << "This solver needs the assembled contact jacobians, using JACOBIAN_CSR";
+      data_manager->settings.solver.jacobian_storage = JACOBIAN_CSR;
+    }
+  }
+
+  // True for the solvers that do not work through ShurProduct and need the
+  // contact jacobians assembled as sparse matrices
+  virtual bool RequiresAssembledJacobian() const { return false; }
 
   // Project the Lagrange multipliers
   void Project(real* gamma);  // Lagrange Multipliers
@@ -67,6 +82,10 @@ class CH_PARALLEL_API ChSolverParallel {
   void ShurProduct(const DynamicVector<real>& x,  // Vector that will be multiplied by N
                    DynamicVector<real>& AX);      // Output Result
 
+  // Compute the same product as ShurProduct without the assembled contact
+  // jacobians, used with the block and matrix free jacobian storage
+  void ShurProductMatrixFree(const DynamicVector<real>& x, DynamicVector<real>& AX);
+
   // Compute the shur matrix vector product only for the bilaterals (N*x)
   // where N=D^T*M^-1*D
   void ShurBilaterals(const DynamicVector<real>& x, DynamicVector<real>& output);
@@ -115,6 +134,17 @@ class CH_PARALLEL_API ChSolverParallel {
   ChConstraintRigidRigid* rigid_rigid;
   ChConstraintBilateral* bilateral;
 
+  // Work vectors of the products with the contact jacobians, kept between calls
+  // so that every iteration reuses their storage
+  DynamicVector<real> M_invD_x;    // M^-1 * D * x for the vector x passed to ShurProduct
+  // Only used when the contact jacobians are not assembled
+  DynamicVector<real> D_x;         // D * x
+  DynamicVector<real> D_T_M_invk;  // D^T * M^-1 * k, used to update the rhs
+
+  // Handles of the timers used in every iteration
+  int timer_shur_product;
+  int timer_project;
+
   // Pointer to the system's data manager
   ChParallelDataManager* data_manager;
 };
@@ -0,0 +1,123 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the compressed sparse row matrix
+//   ChCSRMatrix against the same operations done
+//   with the ChSparseMatrix and dense matrices.
+//
+///////////////////////////////////////////////////
+
+#include <cmath>
+
+#include "core/ChCSRMatrix.h"
+#include "core/ChLog.h"
+
+using namespace chrono;
+
+bool CompareMatrices(ChMatrix<>& a, ChMatrix<>& b, const char* name) {
+    bool passing = a.GetRows() == b.GetRows() && a.GetColumns() == b.GetColumns();
+    for (int i = 0; passing && i < a.GetRows(); i++) {
+        for (int j = 0; passing && j < a.GetColumns(); j++)
+            passing = std::fabs(a(i, j) - b(i, j)) < 1e-12;
+    }
+    GetLog() << name << ": " << (passing ? "PASSED" : "FAILED") << "\n";
+    return passing;
+}
+
+int main(int argc, char* argv[]) {
+    bool passing = true;
+    int n_rows = 30;
+    int n_cols = 20;
+
+    // Fill the same random blocks in a dense, a linked-list and a CSR matrix,
+    // both setting and summing values, in random order and with overlaps
+    ChMatrixDynamic<> dense(n_rows, n_cols);
+    ChSparseMatrix linked(n_rows, n_cols);
+    ChCSRMatrix csr(n_rows, n_cols);
+
+    srand(1);
+    for (int n = 0; n < 40; n++) {
+        ChMatrixDynamic<> block(1 + rand() % 4, 1 + rand() % 4);
+        block.FillRandom(-1, 1);
+        int insrow = rand() % (n_rows - block.GetRows());
+        int inscol = rand() % (n_cols - block.GetColumns());
+        if (n % 3 == 0) {
+            dense.PasteSumMatrix(&block, insrow, inscol);
+            linked.PasteSumMatrix(&block, insrow, inscol);
+            csr.PasteSumMatrix(&block, insrow, inscol);
+        } else {
+            dense.PasteMatrix(&block, insrow, inscol);
+            linked.PasteMatrix(&block, insrow, inscol);
+            csr.PasteMatrix(&block, insrow, inscol);
+        }
+        // read in the middle of the assembly, so that some of the elements are
+        // changed in place and some are merged as triplets
+        if (n == 20)
+            csr.Compress();
+    }
+
+    ChMatrixDynamic<> from_linked;
+    ChMatrixDynamic<> from_csr;
+    linked.CopyToMatrix(&from_linked);
+    csr.CopyToMatrix(&from_csr);
+    passing &= CompareMatrices(from_linked, dense, "Linked-list assembly");
+    passing &= CompareMatrices(from_csr, dense, "CSR assembly");
+
+    // Conversion from the linked-list matrix
+    ChCSRMatrix converted;
+    converted.CopyFromMatrix(&linked);
+    ChMatrixDynamic<> from_converted;
+    converted.CopyToMatrix(&from_converted);
+    passing &= CompareMatrices(from_converted, dense, "CSR conversion");
+
+    // Products y = A*x and y = A'*x
+    ChMatrixDynamic<> x(n_cols, 1);
+    ChMatrixDynamic<> xt(n_rows, 1);
+    x.FillRandom(-1, 1);
+    xt.FillRandom(-1, 1);
+    ChMatrixDynamic<> y_dense(n_rows, 1);
+    ChMatrixDynamic<> yt_dense(n_cols, 1);
+    y_dense.MatrMultiply(dense, x);
+    yt_dense.MatrTMultiply(dense, xt);
+    ChMatrixDynamic<> y_csr;
+    ChMatrixDynamic<> yt_csr;
+    csr.MatrMultiply(x, y_csr);
+    csr.MatrTMultiply(xt, yt_csr);
+    passing &= CompareMatrices(y_csr, y_dense, "CSR product");
+    passing &= CompareMatrices(yt_csr, yt_dense, "CSR transposed product");
+
+    // Transpose, i.e. CSC format
+    ChCSRMatrix transp;
+    csr.Transpose(transp);
+    ChMatrixDynamic<> from_transp;
+    ChMatrixDynamic<> dense_transp;
+    transp.CopyToMatrix(&from_transp);
+    dense_transp.CopyFromMatrixT(dense);
+    passing &= CompareMatrices(from_transp, dense_transp, "CSR transpose");
+
+    // Refill with the same pattern, no new elements are stored
+    int nnz = csr.GetNNZ();
+    csr.ResetBlocks(n_rows, n_cols);
+    for (int i = 0; i < n_rows; i++) {
+        for (int j = 0; j < n_cols; j++) {
+            if (dense(i, j))
+                csr.SetElement(i, j, 2 * dense(i, j));
+        }
+    }
+    dense.MatrScale(2);
+    csr.CopyToMatrix(&from_csr);
+    passing &= CompareMatrices(from_csr, dense, "CSR refill");
+    passing &= (csr.GetNNZ() == nnz);
+
+    return passing ? 0 : 1;
+}
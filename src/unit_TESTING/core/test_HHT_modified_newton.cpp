@@ -0,0 +1,103 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the modified Newton iterations of the
+//   HHT timestepper: a chain of pendulums must move
+//   as with the full Newton method, with fewer
+//   factorizations of the sparse direct solver.
+//
+///////////////////////////////////////////////////
+
+#include "physics/ChSystem.h"
+#include "physics/ChBodyEasy.h"
+#include "physics/ChLinkLock.h"
+#include "timestepper/ChTimestepper.h"
+#include "core/ChLog.h"
+
+using namespace chrono;
+
+// Create a chain of pendulums, starting horizontal, with revolute joints
+void CreateChain(ChSystem& msystem, std::vector<ChSharedPtr<ChBody> >& bodies, int n_bodies) {
+    ChSharedPtr<ChBody> ground(new ChBody);
+    ground->SetBodyFixed(true);
+    msystem.AddBody(ground);
+
+    ChSharedPtr<ChBody> previous = ground;
+    for (int i = 1; i <= n_bodies; i++) {
+        ChSharedPtr<ChBodyEasyBox> body(new ChBodyEasyBox(1, 0.1, 0.1, 1000, false, false));
+        body->SetPos(ChVector<>(i, 0, 0));
+        msystem.AddBody(body);
+        bodies.push_back(body);
+
+        ChSharedPtr<ChLinkLockRevolute> joint(new ChLinkLockRevolute);
+        joint->Initialize(previous, body, ChCoordsys<>(ChVector<>(i - 0.5, 0, 0)));
+        msystem.AddLink(joint);
+        previous = body;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool passing = true;
+    int n_bodies = 5;
+    int n_steps = 100;
+    double dt = 0.01;
+
+    ChSystem system_full;
+    ChSystem system_modified;
+    std::vector<ChSharedPtr<ChBody> > bodies_full;
+    std::vector<ChSharedPtr<ChBody> > bodies_modified;
+    CreateChain(system_full, bodies_full, n_bodies);
+    CreateChain(system_modified, bodies_modified, n_bodies);
+
+    ChSystem* systems[2] = {&system_full, &system_modified};
+    for (int is = 0; is < 2; is++) {
+        systems[is]->SetLcpSolverType(ChSystem::LCP_DIRECT_SPARSE);
+        systems[is]->SetIntegrationType(ChSystem::INT_HHT);
+        ChSharedPtr<ChTimestepperHHT> mystepper = systems[is]->GetTimestepper().DynamicCastTo<ChTimestepperHHT>();
+        mystepper->SetMaxiters(20);
+        mystepper->SetTolerance(1e-9);
+        mystepper->SetModifiedNewton(is == 1);
+    }
+
+    ChSharedPtr<ChTimestepperHHT> stepper_full = system_full.GetTimestepper().DynamicCastTo<ChTimestepperHHT>();
+    ChSharedPtr<ChTimestepperHHT> stepper_modified = system_modified.GetTimestepper().DynamicCastTo<ChTimestepperHHT>();
+
+    int setups_full = 0;
+    int setups_modified = 0;
+    int iterations_modified = 0;
+    for (int n = 0; n < n_steps; n++) {
+        system_full.DoStepDynamics(dt);
+        system_modified.DoStepDynamics(dt);
+        setups_full += stepper_full->GetNumSetups();
+        setups_modified += stepper_modified->GetNumSetups();
+        iterations_modified += stepper_modified->GetNumIterations();
+        passing &= stepper_modified->GetNumIterations() < 20;
+    }
+
+    double max_diff = 0;
+    for (int i = 0; i < n_bodies; i++)
+        max_diff = ChMax(max_diff, (bodies_full[i]->GetPos() - bodies_modified[i]->GetPos()).Length());
+
+    GetLog() << "Full Newton: " << setups_full << " factorizations\n";
+    GetLog() << "Modified Newton: " << setups_modified << " factorizations, " << iterations_modified
+             << " iterations\n";
+    GetLog() << "Max position difference: " << max_diff << "\n";
+
+    passing &= max_diff < 1e-6;
+    passing &= setups_modified < setups_full;
+    passing &= setups_modified < iterations_modified;
+
+    GetLog() << "HHT modified Newton: " << (passing ? "PASSED" : "FAILED") << "\n";
+
+    return passing ? 0 : 1;
+}
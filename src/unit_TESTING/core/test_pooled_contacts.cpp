@@ -0,0 +1,90 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the contact container with pooled
+//   storage ChContactContainerPooled: a layer of
+//   spheres on a plane, some of them with rolling
+//   friction, must move exactly as with the default
+//   ChContactContainer.
+//
+///////////////////////////////////////////////////
+
+#include "physics/ChSystem.h"
+#include "physics/ChBodyEasy.h"
+#include "physics/ChContactContainerPooled.h"
+#include "core/ChLog.h"
+
+using namespace chrono;
+
+// Create a layer of touching spheres on a fixed box
+void CreateLayer(ChSystem& msystem, std::vector<ChSharedPtr<ChBody> >& bodies, int n_side) {
+    ChSharedPtr<ChBodyEasyBox> ground(new ChBodyEasyBox(2 * n_side, 1, 2 * n_side, 1000, true, false));
+    ground->SetPos(ChVector<>(0, -0.5, 0));
+    ground->SetBodyFixed(true);
+    ground->GetMaterialSurface()->SetRollingFriction(0.01f);
+    msystem.AddBody(ground);
+
+    for (int ix = 0; ix < n_side; ix++) {
+        for (int iz = 0; iz < n_side; iz++) {
+            ChSharedPtr<ChBodyEasySphere> sphere(new ChBodyEasySphere(0.5, 1000, true, false));
+            sphere->SetPos(ChVector<>(ix - n_side / 2.0, 0.49, iz - n_side / 2.0 + 0.01 * ix));
+            sphere->SetPos_dt(ChVector<>(0.1 * iz, 0, 0));
+            sphere->GetMaterialSurface()->SetFriction(0.4f);
+            if (ix % 2)
+                sphere->GetMaterialSurface()->SetRollingFriction(0.01f);
+            msystem.AddBody(sphere);
+            bodies.push_back(sphere);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool passing = true;
+    int n_side = 16;
+    int n_steps = 20;
+
+    ChSystem system_list;
+    ChSystem system_pooled;
+    std::vector<ChSharedPtr<ChBody> > bodies_list;
+    std::vector<ChSharedPtr<ChBody> > bodies_pooled;
+    CreateLayer(system_list, bodies_list, n_side);
+    CreateLayer(system_pooled, bodies_pooled, n_side);
+
+    ChContactContainerPooled* mpooled = new ChContactContainerPooled;
+    system_pooled.ChangeContactContainer(mpooled);
+
+    for (int n = 0; n < n_steps; n++) {
+        system_list.DoStepDynamics(0.005);
+        system_pooled.DoStepDynamics(0.005);
+        passing &= system_list.GetNcontacts() == system_pooled.GetNcontacts();
+    }
+
+    double max_diff = 0;
+    for (unsigned int i = 0; i < bodies_list.size(); i++)
+        max_diff = ChMax(max_diff, (bodies_list[i]->GetPos() - bodies_pooled[i]->GetPos()).Length());
+
+    GetLog() << "Contacts: " << mpooled->GetNcontactsSliding() << " sliding, " << mpooled->GetNcontactsRolling()
+             << " rolling\n";
+    GetLog() << "Max position difference: " << max_diff << "\n";
+
+    // both pools in use, enough contacts to initialize them in parallel, and same
+    // results of the default container
+    passing &= system_pooled.GetNcontacts() > CH_CONTACTS_PARALLEL;
+    passing &= mpooled->GetNcontactsSliding() > 0;
+    passing &= mpooled->GetNcontactsRolling() > 0;
+    passing &= max_diff == 0;
+
+    GetLog() << "Pooled contact container: " << (passing ? "PASSED" : "FAILED") << "\n";
+
+    return passing ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the parallel contact reporting of the
+//   Bullet collision system: a layer of spheres
+//   on a plane must move exactly as when the
+//   contacts are reported serially (forced by
+//   setting a narrowphase callback).
+//
+///////////////////////////////////////////////////
+
+#include "physics/ChSystem.h"
+#include "physics/ChBodyEasy.h"
+#include "physics/ChContactContainerBase.h"
+#include "collision/ChCCollisionSystem.h"
+#include "core/ChLog.h"
+
+using namespace chrono;
+
+// A narrowphase callback that does nothing: its presence makes the
+// collision system report the contacts with a single thread
+class ChNoopCallback : public collision::ChNarrowPhaseCallback {
+  public:
+    virtual void NarrowCallback(const collision::ChCollisionInfo& mcontactinfo) {}
+};
+
+// Create a layer of touching spheres on a fixed box
+void CreateLayer(ChSystem& msystem, std::vector<ChSharedPtr<ChBody> >& bodies, int n_side) {
+    ChSharedPtr<ChBodyEasyBox> ground(new ChBodyEasyBox(2 * n_side, 1, 2 * n_side, 1000, true, false));
+    ground->SetPos(ChVector<>(0, -0.5, 0));
+    ground->SetBodyFixed(true);
+    msystem.AddBody(ground);
+
+    for (int ix = 0; ix < n_side; ix++) {
+        for (int iz = 0; iz < n_side; iz++) {
+            ChSharedPtr<ChBodyEasySphere> sphere(new ChBodyEasySphere(0.5, 1000, true, false));
+            sphere->SetPos(ChVector<>(ix - n_side / 2.0, 0.49, iz - n_side / 2.0 + 0.01 * ix));
+            sphere->GetMaterialSurface()->SetFriction(0.4f);
+            msystem.AddBody(sphere);
+            bodies.push_back(sphere);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool passing = true;
+    int n_side = 24;
+    int n_steps = 10;
+
+    ChSystem system_parallel;
+    ChSystem system_serial;
+    std::vector<ChSharedPtr<ChBody> > bodies_parallel;
+    std::vector<ChSharedPtr<ChBody> > bodies_serial;
+    CreateLayer(system_parallel, bodies_parallel, n_side);
+    CreateLayer(system_serial, bodies_serial, n_side);
+
+    ChNoopCallback mcallback;
+    system_serial.GetCollisionSystem()->SetNarrowPhaseCallback(&mcallback);
+
+    int min_contacts = 1 << 30;
+    for (int n = 0; n < n_steps; n++) {
+        system_parallel.DoStepDynamics(0.005);
+        system_serial.DoStepDynamics(0.005);
+        passing &= system_parallel.GetNcontacts() == system_serial.GetNcontacts();
+        min_contacts = ChMin(min_contacts, system_parallel.GetNcontacts());
+    }
+
+    double max_diff = 0;
+    for (unsigned int i = 0; i < bodies_parallel.size(); i++)
+        max_diff = ChMax(max_diff, (bodies_parallel[i]->GetPos() - bodies_serial[i]->GetPos()).Length());
+
+    GetLog() << "Contacts: " << system_parallel.GetNcontacts() << "\n";
+    GetLog() << "Max position difference: " << max_diff << "\n";
+
+    // enough contacts to use the parallel path, and same results of the serial one
+    passing &= min_contacts > CH_CONTACTS_PARALLEL;
+    passing &= max_diff == 0;
+
+    GetLog() << "Parallel contact reporting: " << (passing ? "PASSED" : "FAILED") << "\n";
+
+    return passing ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+//
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2013 Project Chrono
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file at the top level of the distribution
+// and at http://projectchrono.org/license-chrono.txt.
+//
+
+///////////////////////////////////////////////////
+//
+//   Test of the sparse direct solver
+//   ChLcpSparseDirectSolver on a chain of bodies
+//   with bilateral constraints and stiffness blocks:
+//   the residual of the KKT system must vanish and
+//   the symbolic factorization must be reused.
+//
+///////////////////////////////////////////////////
+
+#include "lcp/ChLcpSparseDirectSolver.h"
+#include "lcp/ChLcpVariablesBodyOwnMass.h"
+#include "lcp/ChLcpConstraintTwoBodies.h"
+#include "lcp/ChLcpKblockGeneric.h"
+#include "core/ChLog.h"
+
+using namespace chrono;
+
+// Norm of the residual Z*x-d of the KKT system, with the unknowns
+// x={q;-l} currently stored in the variables and constraints
+double Residual(ChLcpSystemDescriptor& mdescriptor) {
+    ChMatrixDynamic<> x;
+    ChMatrixDynamic<> d;
+    ChMatrixDynamic<> Zx;
+    mdescriptor.FromUnknownsToVector(x);
+    mdescriptor.BuildDiVector(d);
+    mdescriptor.SystemProduct(Zx, &x);
+    Zx.MatrDec(d);
+    return Zx.NormInf();
+}
+
+int main(int argc, char* argv[]) {
+    bool passing = true;
+    int n_bodies = 50;
+
+    ChLcpSystemDescriptor mdescriptor;
+    mdescriptor.BeginInsertion();
+
+    ChMatrix33<> minertia;
+    minertia.FillDiag(6);
+
+    srand(1);
+    std::vector<ChLcpVariablesBodyOwnMass*> vars;
+    std::vector<ChLcpConstraintTwoBodies*> constraints;
+    std::vector<ChLcpKblockGeneric*> stiffness;
+    for (int i = 0; i < n_bodies; i++) {
+        vars.push_back(new ChLcpVariablesBodyOwnMass);
+        vars[i]->SetBodyMass(5);
+        vars[i]->SetBodyInertia(minertia);
+        vars[i]->Get_fb().FillRandom(-3, 5);
+        mdescriptor.InsertVariables(vars[i]);
+        if (i == 0)
+            continue;
+
+        // two independent constraints between each couple of bodies, one of them
+        // with compliance
+        for (int j = 0; j < 2; j++) {
+            ChLcpConstraintTwoBodies* mc = new ChLcpConstraintTwoBodies(vars[i - 1], vars[i]);
+            mc->Set_b_i(j + 1);
+            mc->Get_Cq_a()->FillRandom(-1, 1);
+            mc->Get_Cq_b()->FillRandom(-1, 1);
+            mc->Set_cfm_i(j * 0.1);
+            mdescriptor.InsertConstraint(mc);
+            constraints.push_back(mc);
+        }
+
+        // a symmetric stiffness block between every other couple of bodies
+        if (i % 2 == 0) {
+            ChLcpKblockGeneric* mk = new ChLcpKblockGeneric;
+            std::vector<ChLcpVariables*> mvars;
+            mvars.push_back(vars[i - 1]);
+            mvars.push_back(vars[i]);
+            mk->SetVariables(mvars);
+            ChMatrixDynamic<> mtempA = *mk->Get_K();
+            mtempA.FillRandom(-0.3, 0.3);
+            ChMatrixDynamic<> mtempB;
+            mtempB.CopyFromMatrixT(mtempA);
+            *mk->Get_K() = -mtempA * mtempB;
+            mdescriptor.InsertKblock(mk);
+            stiffness.push_back(mk);
+        }
+    }
+
+    // the first body is fixed
+    vars[0]->SetDisabled(true);
+
+    mdescriptor.EndInsertion();
+
+    ChLcpSparseDirectSolver msolver;
+    msolver.Solve(mdescriptor);
+
+    double residual = Residual(mdescriptor);
+    GetLog() << "Residual after the first solution: " << residual << "\n";
+    passing &= residual < 1e-9;
+    passing &= msolver.GetNumPerturbedPivots() == 0;
+
+    // Same sparsity, different values: only the numeric factorization is redone
+    for (int i = 0; i < n_bodies; i++)
+        vars[i]->Get_fb().FillRandom(-1, 1);
+    for (unsigned int ic = 0; ic < constraints.size(); ic++)
+        constraints[ic]->Get_Cq_b()->MatrScale(1.5);
+    msolver.Solve(mdescriptor);
+
+    residual = Residual(mdescriptor);
+    GetLog() << "Residual after the second solution: " << residual << "\n";
+    passing &= residual < 1e-9;
+    passing &= msolver.GetNumSymbolicFactorizations() == 1;
+    passing &= msolver.GetNumNumericFactorizations() == 2;
+
+    // A new active body changes the sparsity: the ordering is computed again
+    vars[0]->SetDisabled(false);
+    mdescriptor.UpdateCountsAndOffsets();
+    msolver.Solve(mdescriptor);
+
+    residual = Residual(mdescriptor);
+    GetLog() << "Residual after the third solution: " << residual << "\n";
+    passing &= residual < 1e-9;
+    passing &= msolver.GetNumSymbolicFactorizations() == 2;
+
+    GetLog() << "Sparse direct solver: " << (passing ? "PASSED" : "FAILED") << "\n";
+
+    for (unsigned int i = 0; i < vars.size(); i++)
+        delete vars[i];
+    for (unsigned int i = 0; i < constraints.size(); i++)
+        delete constraints[i];
+    for (unsigned int i = 0; i < stiffness.size(); i++)
+        delete stiffness[i];
+
+    return passing ? 0 : 1;
+}
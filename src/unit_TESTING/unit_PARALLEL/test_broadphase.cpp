@@ -0,0 +1,110 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test to compare the list of contacts generated by the
+// different broadphase modes against the default uniform grid broadphase.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-3;
+int num_steps = 200;
+
+// Both systems must report exactly the same list of shape pairs in contact
+bool ComparePairs(ChSystemParallel* system_A, ChSystemParallel* system_B) {
+  const host_vector<long long>& pairs_A = system_A->data_manager->host_data.pair_rigid_rigid;
+  const host_vector<long long>& pairs_B = system_B->data_manager->host_data.pair_rigid_rigid;
+
+  if (pairs_A.size() != pairs_B.size()) {
+    cout << "Number of pairs " << pairs_A.size() << " does not equal " << pairs_B.size() << endl;
+    return false;
+  }
+  for (int i = 0; i < pairs_A.size(); i++) {
+    if (pairs_A[i] != pairs_B[i]) {
+      cout << "Pair " << i << ": " << pairs_A[i] << " does not equal " << pairs_B[i] << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Step a system using the default grid broadphase alongside a system using the
+// broadphase configured by the caller and compare the contacts at every step.
+bool TestBroadphase(const std::string& name, ChSystemParallelDVI* system) {
+  ChSystemParallelDVI* reference = CreateGranularSystem();
+  bool passing = true;
+
+  for (int i = 0; i < num_steps && passing; i++) {
+    reference->DoStepDynamics(time_step);
+    system->DoStepDynamics(time_step);
+    passing = ComparePairs(reference, system);
+  }
+
+  cout << name << ": " << (passing ? "PASSED" : "FAILED") << endl;
+
+  delete reference;
+  delete system;
+  return passing;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+  bool passing = true;
+
+  {
+    ChSystemParallelDVI* system = CreateGranularSystem();
+    system->GetSettings()->collision.incremental_broadphase = true;
+    passing &= TestBroadphase("Incremental grid", system);
+  }
+  {
+    // The grid is rebuilt at every step, the bin lists are compacted in place
+    ChSystemParallelDVI* system = CreateGranularSystem();
+    system->GetSettings()->collision.incremental_broadphase = false;
+    system->GetSettings()->collision.single_pass_broadphase = true;
+    passing &= TestBroadphase("Single pass grid", system);
+  }
+  {
+    ChSystemParallelDVI* system = CreateGranularSystem();
+    system->GetSettings()->collision.incremental_broadphase = true;
+    system->GetSettings()->collision.single_pass_broadphase = true;
+    passing &= TestBroadphase("Single pass incremental grid", system);
+  }
+  {
+    ChSystemParallelDVI* system = CreateGranularSystem();
+    system->GetSettings()->collision.broadphase_algorithm = BROADPHASE_SAP;
+    passing &= TestBroadphase("Sweep and prune", system);
+  }
+  {
+    ChSystemParallelDVI* system = CreateGranularSystem();
+    system->GetSettings()->collision.broadphase_algorithm = BROADPHASE_HIERARCHICAL_GRID;
+    passing &= TestBroadphase("Hierarchical grid", system);
+  }
+
+  return passing ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for the DEM contact history. Clumps of four spheres
+// rest on a plate with gravity tilted along X, below the friction limit. With
+// the contact history (MULTI_STEP) the tangential springs hold the clumps in
+// place, without it (ONE_STEP) only the damping resists and the clumps creep.
+// The plate is added last, so all its contacts belong to the body with the
+// largest index, more than the 20 a body could keep before the history was
+// keyed by shape pair. Every step the history table must hold exactly one
+// entry per touching contact.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 5000;
+int settle_steps = 1000;
+
+double radius = 0.05;  // [m] radius of the spheres of a clump
+
+ChSystemParallelDEM* CreateSystem(TANGENTIALDISPLACEMENTMODE mode, std::vector<ChSharedBodyPtr>& clumps) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->Set_G_acc(ChVector<>(2, 0, -9.81));
+  system->GetSettings()->solver.tangential_displ_mode = mode;
+
+  double mass = 1;
+  for (int i = 0; i < 9; i++) {
+    ChSharedBodyPtr clump = CreateBody(system, 0.5f);
+    clump->SetMass(mass);
+    clump->SetInertiaXX(mass * radius * radius * ChVector<>(1, 1, 1));
+    clump->SetPos(ChVector<>(0.3 * (i % 3 - 1), 0.3 * (i / 3 - 1), radius - 0.001));
+    clump->SetCollide(true);
+    clump->GetCollisionModel()->ClearModel();
+    utils::AddSphereGeometry(clump.get_ptr(), radius, ChVector<>(radius, radius, 0));
+    utils::AddSphereGeometry(clump.get_ptr(), radius, ChVector<>(-radius, radius, 0));
+    utils::AddSphereGeometry(clump.get_ptr(), radius, ChVector<>(radius, -radius, 0));
+    utils::AddSphereGeometry(clump.get_ptr(), radius, ChVector<>(-radius, -radius, 0));
+    clump->GetCollisionModel()->BuildModel();
+    system->AddBody(clump);
+    clumps.push_back(clump);
+  }
+
+  AddPlate(system, 0.5f);
+
+  return system;
+}
+
+// Every entry of the history table is a touching contact, found once, and
+// every touching contact has an entry. Returns the number of entries.
+int CheckHistoryTable(ChSystemParallelDEM* system) {
+  const host_container& host_data = system->data_manager->host_data;
+  uint num_contacts = system->data_manager->num_rigid_contacts;
+
+  std::set<std::pair<long long, int> > touching;
+  int occurrence = 0;
+  for (uint i = 0; i < num_contacts; i++) {
+    occurrence = (i > 0 && host_data.pair_rigid_rigid[i] == host_data.pair_rigid_rigid[i - 1]) ? occurrence + 1 : 0;
+    if (host_data.dpth_rigid_rigid[i] < 0) {
+      touching.insert(std::make_pair(host_data.pair_rigid_rigid[i], occurrence));
+    }
+  }
+
+  std::set<std::pair<long long, int> > entries;
+  for (uint slot = 0; slot < host_data.shear_pair.size(); slot++) {
+    if (host_data.shear_pair[slot] == -1) {
+      continue;
+    }
+    std::pair<long long, int> key(host_data.shear_pair[slot], host_data.shear_occurrence[slot]);
+    StrictEqual(int(entries.count(key)), 0);
+    StrictEqual(int(touching.count(key)), 1);
+    entries.insert(key);
+  }
+
+  StrictEqual(int(entries.size()), int(touching.size()));
+  return entries.size();
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  std::vector<ChSharedBodyPtr> clumps_history, clumps_one_step;
+  ChSystemParallelDEM* system_history = CreateSystem(MULTI_STEP, clumps_history);
+  ChSystemParallelDEM* system_one_step = CreateSystem(ONE_STEP, clumps_one_step);
+
+  std::vector<double> start_history(clumps_history.size());
+  std::vector<double> start_one_step(clumps_one_step.size());
+  int num_entries = 0;
+
+  for (int step = 0; step < num_steps; step++) {
+    if (step == settle_steps) {
+      for (int i = 0; i < clumps_history.size(); i++) {
+        start_history[i] = clumps_history[i]->GetPos().x;
+        start_one_step[i] = clumps_one_step[i]->GetPos().x;
+      }
+    }
+
+    system_history->DoStepDynamics(time_step);
+    system_one_step->DoStepDynamics(time_step);
+    num_entries = CheckHistoryTable(system_history);
+  }
+
+  // All four spheres of every clump touch the plate
+  StrictEqual(num_entries, 4 * int(clumps_history.size()));
+
+  // Largest creep of a clump held by the history, smallest creep without it
+  double creep_history = 0;
+  double creep_one_step = 1e10;
+  for (int i = 0; i < clumps_history.size(); i++) {
+    creep_history = std::max(creep_history, std::abs(clumps_history[i]->GetPos().x - start_history[i]));
+    creep_one_step = std::min(creep_one_step, std::abs(clumps_one_step[i]->GetPos().x - start_one_step[i]));
+  }
+  cout << "Creep with history: " << creep_history << ", without history: " << creep_one_step << endl;
+
+  StrictEqual(int(creep_one_step > 1e-3), 1);
+  StrictEqual(int(creep_history < 0.1 * creep_one_step), 1);
+
+  cout << "Contact history: PASSED" << endl;
+
+  delete system_history;
+  delete system_one_step;
+  return 0;
+}
@@ -0,0 +1,171 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for the NUMA data placement settings. Balls are
+// dropped on a plate, more balls are added midway through the simulation so
+// that the data is moved again. The system with first touch and thread pinning
+// enabled must produce the same positions as the default system. With two
+// threads every thread must be pinned to a single processor, and get the
+// processors of the process back when the pinning is turned off.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 1000;
+int add_step = 500;
+
+double radius = 0.1;  // [m] radius of the falling balls
+
+void AddBalls(ChSystemParallel* system, double height, std::vector<ChSharedBodyPtr>& balls) {
+  for (int i = 0; i < 9; i++) {
+    balls.push_back(AddBall(system, radius, 0.5f, ChVector<>(0.25 * (i % 3 - 1), 0.25 * (i / 3 - 1), height)));
+  }
+}
+
+ChSystemParallelDEM* CreateSystem(bool placement, std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->GetSettings()->numa_first_touch = placement;
+  system->GetSettings()->thread_affinity = placement ? AFFINITY_SCATTER : AFFINITY_NONE;
+
+  AddPlate(system, 0.5f);
+  AddBalls(system, 0.3, balls);
+  return system;
+}
+
+#ifdef __linux__
+// Processors of every thread of a team of num_threads threads
+std::vector<cpu_set_t> GetThreadMasks(int num_threads) {
+  std::vector<cpu_set_t> masks(num_threads);
+#pragma omp parallel num_threads(num_threads)
+  {
+    int thread = omp_get_thread_num();
+    CPU_ZERO(&masks[thread]);
+    sched_getaffinity(0, sizeof(cpu_set_t), &masks[thread]);
+  }
+  return masks;
+}
+
+// Every thread runs on a single processor of the process, different ones if
+// there are enough processors
+void CheckPinned(const std::vector<cpu_set_t>& masks, cpu_set_t& process) {
+  for (int i = 0; i < masks.size(); i++) {
+    cpu_set_t mask = masks[i];
+    StrictEqual(CPU_COUNT(&mask), 1);
+    CPU_AND(&mask, &mask, &process);
+    StrictEqual(CPU_COUNT(&mask), 1);
+  }
+  if (CPU_COUNT(&process) >= masks.size()) {
+    for (int i = 0; i < masks.size(); i++) {
+      for (int j = i + 1; j < masks.size(); j++) {
+        cpu_set_t both;
+        CPU_AND(&both, &masks[i], &masks[j]);
+        StrictEqual(CPU_COUNT(&both), 0);
+      }
+    }
+  }
+}
+
+// Every thread runs on the processors of the process
+void CheckRestored(const std::vector<cpu_set_t>& masks, cpu_set_t& process) {
+  for (int i = 0; i < masks.size(); i++) {
+    StrictEqual(CPU_EQUAL(&masks[i], &process) ? 1 : 0, 1);
+  }
+}
+
+void TestPinning() {
+  int num_threads = 2;
+  omp_set_num_threads(num_threads);
+
+  cpu_set_t process;
+  CPU_ZERO(&process);
+  sched_getaffinity(0, sizeof(cpu_set_t), &process);
+
+  std::vector<ChSharedBodyPtr> balls;
+  ChSystemParallelDEM* system = CreateSystem(true, balls);
+  system->GetSettings()->max_threads = num_threads;
+
+  system->DoStepDynamics(time_step);
+  CheckPinned(GetThreadMasks(num_threads), process);
+
+  system->GetSettings()->thread_affinity = AFFINITY_COMPACT;
+  system->DoStepDynamics(time_step);
+  CheckPinned(GetThreadMasks(num_threads), process);
+
+  system->GetSettings()->thread_affinity = AFFINITY_NONE;
+  system->DoStepDynamics(time_step);
+  CheckRestored(GetThreadMasks(num_threads), process);
+
+  // Pinned again, deleting the system also gives the processors back
+  system->GetSettings()->thread_affinity = AFFINITY_SCATTER;
+  system->DoStepDynamics(time_step);
+  CheckPinned(GetThreadMasks(num_threads), process);
+  delete system;
+  CheckRestored(GetThreadMasks(num_threads), process);
+
+  cout << "Thread pinning: PASSED" << endl;
+}
+#endif
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  std::vector<ChSharedBodyPtr> balls_default, balls_placed;
+  ChSystemParallelDEM* system_default = CreateSystem(false, balls_default);
+  ChSystemParallelDEM* system_placed = CreateSystem(true, balls_placed);
+
+  for (int step = 0; step < num_steps; step++) {
+    if (step == add_step) {
+      AddBalls(system_default, 0.6, balls_default);
+      AddBalls(system_placed, 0.6, balls_placed);
+    }
+
+    system_default->DoStepDynamics(time_step);
+    system_placed->DoStepDynamics(time_step);
+
+    for (int i = 0; i < balls_default.size(); i++) {
+      WeakEqual(ToReal3(balls_placed[i]->GetPos()), ToReal3(balls_default[i]->GetPos()), 1e-10);
+    }
+  }
+
+  cout << "Data placement: PASSED" << endl;
+
+  delete system_default;
+  delete system_placed;
+
+#ifdef __linux__
+  TestPinning();
+#endif
+  return 0;
+}
@@ -0,0 +1,99 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for stepping an ensemble of systems. Small piles of
+// balls with different friction coefficients are stepped through an ensemble
+// and one after the other, both must produce the same results.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChEnsembleParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 500;
+int num_systems = 6;
+
+double radius = 0.1;  // [m] radius of the falling balls
+
+ChSystemParallelDEM* CreateSystem(float friction, std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+
+  AddPlate(system, friction, ChVector<>(2, 2, 0.1), ChVector<>(0, 0, 0), Q_from_AngY(0.2));
+  for (int i = 0; i < 8; i++) {
+    ChVector<> pos(0.25 * (i % 2), 0.25 * (i / 2 % 2), 0.3 + 0.25 * (i / 4));
+    balls.push_back(AddBall(system, radius, friction, pos));
+  }
+
+  return system;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  ChEnsembleParallel ensemble;
+  ensemble.SetNumWorkers(2);
+
+  std::vector<ChSystemParallelDEM*> references(num_systems);
+  std::vector<std::vector<ChSharedBodyPtr> > balls(num_systems), reference_balls(num_systems);
+  for (int i = 0; i < num_systems; i++) {
+    float friction = 0.1f * (i + 1);
+    references[i] = CreateSystem(friction, reference_balls[i]);
+    ensemble.AddSystem(CreateSystem(friction, balls[i]));
+  }
+
+  // The ensemble is stepped in two calls to check that the records accumulate
+  ensemble.DoStepDynamics(time_step, num_steps / 2);
+  ensemble.DoStepDynamics(time_step, num_steps - num_steps / 2);
+  for (int i = 0; i < num_systems; i++) {
+    for (int step = 0; step < num_steps; step++) {
+      references[i]->DoStepDynamics(time_step);
+    }
+  }
+
+  for (int i = 0; i < num_systems; i++) {
+    for (int j = 0; j < balls[i].size(); j++) {
+      WeakEqual(ToReal3(balls[i][j]->GetPos()), ToReal3(reference_balls[i][j]->GetPos()), 1e-10);
+      WeakEqual(ToReal3(balls[i][j]->GetPos_dt()), ToReal3(reference_balls[i][j]->GetPos_dt()), 1e-10);
+    }
+
+    const EnsembleRecord& record = ensemble.GetRecord(i);
+    StrictEqual(record.num_steps, num_steps);
+    StrictEqual(int(record.num_bodies), int(references[i]->data_manager->num_rigid_bodies));
+    StrictEqual(int(record.num_contacts), references[i]->GetNumContacts());
+    WeakEqual(real(record.sim_time), real(references[i]->GetChTime()), 1e-10);
+  }
+
+  ensemble.PrintReport();
+
+  for (int i = 0; i < num_systems; i++) {
+    delete ensemble.GetSystem(i);
+    delete references[i];
+  }
+  return 0;
+}
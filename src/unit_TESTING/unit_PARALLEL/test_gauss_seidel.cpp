@@ -0,0 +1,96 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for the colored Gauss-Seidel solver. Columns of
+// balls resting on a fixed plate must stay at rest, which requires the
+// solver to propagate the weight of the balls down each column.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-3;
+int num_steps = 500;
+int num_threads = 4;
+double test_tolerance = 1e-2;
+
+double radius = 0.1;  // [m] radius of the balls
+int num_layers = 5;   // Number of balls in each column
+
+ChSystemParallelDVI* CreateSystem() {
+  ChSystemParallelDVI* system = new ChSystemParallelDVI();
+  InitializeSystem(system);
+  system->ChangeSolverType(GAUSS_SEIDEL);
+  system->GetSettings()->solver.solver_mode = SLIDING;
+  system->GetSettings()->solver.max_iteration_normal = 0;
+  system->GetSettings()->solver.max_iteration_sliding = 100;
+  system->GetSettings()->solver.max_iteration_spinning = 0;
+  system->GetSettings()->solver.tol_speed = 1e-6;
+  system->GetSettings()->collision.collision_envelope = 0.01;
+  system->GetSettings()->max_threads = num_threads;
+
+  AddPlate(system, 0.5f);
+  for (int ix = -1; ix < 2; ix++) {
+    for (int iy = -1; iy < 2; iy++) {
+      for (int iz = 0; iz < num_layers; iz++) {
+        AddBall(system, radius, 0.5f, ChVector<>(0.5 * ix, 0.5 * iy, radius + 2 * radius * iz));
+      }
+    }
+  }
+
+  return system;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(num_threads);
+
+  ChSystemParallelDVI* system = CreateSystem();
+
+  for (int i = 0; i < num_steps; i++) {
+    system->DoStepDynamics(time_step);
+  }
+
+  // Neighboring contacts in a column share a ball so at least two colors are
+  // needed, the contacts with the fixed plate do not add any conflicts
+  uint num_colors = system->data_manager->measures.solver.num_colors;
+  cout << "Number of colors: " << num_colors << endl;
+  StrictEqual((int)(num_colors >= 2 && num_colors <= 3), 1);
+
+  for (int i = 0; i < system->Get_bodylist()->size(); i++) {
+    ChBody* body = system->Get_bodylist()->at(i);
+    if (body->GetBodyFixed()) {
+      continue;
+    }
+    int layer = body->GetIdentifier() % num_layers;
+    WeakEqual(body->GetPos().z, radius + 2 * radius * layer, test_tolerance);
+    WeakEqual(body->GetPos_dt().Length(), 0, test_tolerance);
+  }
+
+  delete system;
+  return 0;
+}
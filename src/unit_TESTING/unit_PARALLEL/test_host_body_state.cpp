@@ -0,0 +1,157 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for keeping the state of the bodies in the data
+// manager. A pile of balls is dropped on a tilted plate once with the state
+// kept in the ChBody objects and once with the state kept in the data manager,
+// both runs must produce the same positions, rotations and velocities.
+// A layer of balls is then put to sleep on a flat plate with the state kept in
+// the data manager, the sleeping balls must not move.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 2000;
+int num_settle_steps = 10000;
+int num_sleep_steps = 2000;
+
+double radius = 0.1;  // [m] radius of the falling balls
+
+ChSystemParallelDEM* CreateSystem(bool host_body_state, std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->GetSettings()->host_body_state = host_body_state;
+
+  // The plate is tilted so that the balls roll
+  AddPlate(system, 0.5f, ChVector<>(2, 2, 0.1), ChVector<>(0, 0, 0), Q_from_AngY(0.2));
+  for (int i = 0; i < 8; i++) {
+    ChVector<> pos(0.25 * (i % 2), 0.25 * (i / 2 % 2), 0.3 + 0.25 * (i / 4));
+    ChSharedBodyPtr ball = CreateBall(system, radius, 0.5f, pos);
+    ball->SetWvel_loc(ChVector<>(0, 1, 0));
+    system->AddBody(ball);
+    balls.push_back(ball);
+  }
+
+  return system;
+}
+
+// A layer of balls resting on a flat plate, with sleeping enabled and the state
+// kept in the data manager
+ChSystemParallelDEM* CreateSleepingSystem(std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->GetSettings()->host_body_state = true;
+  system->GetSettings()->sleep.use_sleeping = true;
+  system->GetSettings()->sleep.min_speed = 1e-2;
+  system->GetSettings()->sleep.min_wvel = 1e-1;
+  system->GetSettings()->sleep.sleep_time = 0.1;
+
+  AddPlate(system, 0.5f, ChVector<>(2, 2, 0.1));
+  for (int i = 0; i < 4; i++) {
+    balls.push_back(AddBall(system, radius, 0.5f, ChVector<>(0.25 * (i % 2), 0.25 * (i / 2), radius + 0.01)));
+  }
+
+  return system;
+}
+
+// The speeds of a sleeping body kept in the data manager are cleared, so the
+// body does not drift while it sleeps
+void TestSleeping() {
+  std::vector<ChSharedBodyPtr> balls;
+  ChSystemParallelDEM* system = CreateSleepingSystem(balls);
+  const custom_vector<real3>& pos_rigid = system->data_manager->host_data.pos_rigid;
+  const custom_vector<real3>& vel_rigid = system->data_manager->host_data.vel_rigid;
+  const custom_vector<real3>& omg_rigid = system->data_manager->host_data.omg_rigid;
+
+  for (int step = 0; step < num_settle_steps; step++) {
+    system->DoStepDynamics(time_step);
+  }
+
+  std::vector<real3> pos_asleep;
+  for (int i = 0; i < balls.size(); i++) {
+    StrictEqual(int(balls[i]->GetSleeping()), 1);
+    pos_asleep.push_back(pos_rigid[balls[i]->GetId()]);
+  }
+
+  for (int step = 0; step < num_sleep_steps; step++) {
+    system->DoStepDynamics(time_step);
+  }
+
+  system->SyncBodies();
+
+  for (int i = 0; i < balls.size(); i++) {
+    int id = balls[i]->GetId();
+    StrictEqual(int(balls[i]->GetSleeping()), 1);
+    StrictEqual(pos_rigid[id], pos_asleep[i]);
+    StrictEqual(vel_rigid[id], R3(0));
+    StrictEqual(omg_rigid[id], R3(0));
+    StrictEqual(ToReal3(balls[i]->GetPos()), pos_asleep[i]);
+    StrictEqual(ToReal3(balls[i]->GetPos_dt()), R3(0));
+  }
+
+  cout << "Host body state, sleeping: PASSED" << endl;
+
+  delete system;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  std::vector<ChSharedBodyPtr> balls_body, balls_host;
+  ChSystemParallelDEM* system_body = CreateSystem(false, balls_body);
+  ChSystemParallelDEM* system_host = CreateSystem(true, balls_host);
+
+  for (int step = 0; step < num_steps; step++) {
+    system_body->DoStepDynamics(time_step);
+    system_host->DoStepDynamics(time_step);
+  }
+
+  // The ChBody objects are only updated on request
+  system_host->SyncBodies();
+
+  for (int i = 0; i < balls_body.size(); i++) {
+    WeakEqual(ToReal3(balls_host[i]->GetPos()), ToReal3(balls_body[i]->GetPos()), 1e-6);
+    WeakEqual(ToReal3(balls_host[i]->GetPos_dt()), ToReal3(balls_body[i]->GetPos_dt()), 1e-6);
+    WeakEqual(ToReal3(balls_host[i]->GetWvel_loc()), ToReal3(balls_body[i]->GetWvel_loc()), 1e-6);
+    ChQuaternion<> rot_host = balls_host[i]->GetRot();
+    ChQuaternion<> rot_body = balls_body[i]->GetRot();
+    WeakEqual(R4(rot_host.e0, rot_host.e1, rot_host.e2, rot_host.e3),
+              R4(rot_body.e0, rot_body.e1, rot_body.e2, rot_body.e3), 1e-6);
+  }
+
+  cout << "Host body state: PASSED" << endl;
+
+  delete system_body;
+  delete system_host;
+
+  TestSleeping();
+
+  return 0;
+}
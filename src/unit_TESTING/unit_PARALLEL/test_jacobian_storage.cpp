@@ -0,0 +1,85 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test to compare the DVI solution obtained with the
+// block and matrix free contact jacobian storage against the one obtained
+// with the assembled sparse contact jacobians.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-3;
+int num_steps = 50;
+double test_tolerance = 1e-5;
+
+// Step a system using the assembled jacobians alongside a system using the
+// given jacobian storage and compare the velocities and impulses at every step.
+bool TestJacobianStorage(SOLVERMODE mode, JACOBIANSTORAGE storage) {
+  ChSystemParallelDVI* reference = CreateGranularSystem();
+  ChSystemParallelDVI* system = CreateGranularSystem();
+  reference->GetSettings()->solver.solver_mode = mode;
+  system->GetSettings()->solver.solver_mode = mode;
+  system->GetSettings()->solver.jacobian_storage = storage;
+
+  for (int i = 0; i < num_steps; i++) {
+    reference->DoStepDynamics(time_step);
+    system->DoStepDynamics(time_step);
+
+    const DynamicVector<real>& gamma_A = reference->data_manager->host_data.gamma;
+    const DynamicVector<real>& gamma_B = system->data_manager->host_data.gamma;
+    const DynamicVector<real>& v_A = reference->data_manager->host_data.v;
+    const DynamicVector<real>& v_B = system->data_manager->host_data.v;
+
+    StrictEqual((int)gamma_A.size(), (int)gamma_B.size());
+    for (int k = 0; k < gamma_A.size(); k++) {
+      WeakEqual(gamma_A[k], gamma_B[k], test_tolerance);
+    }
+    for (int k = 0; k < v_A.size(); k++) {
+      WeakEqual(v_A[k], v_B[k], test_tolerance);
+    }
+  }
+
+  delete reference;
+  delete system;
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  TestJacobianStorage(NORMAL, JACOBIAN_BLOCK);
+  TestJacobianStorage(SLIDING, JACOBIAN_BLOCK);
+  TestJacobianStorage(SPINNING, JACOBIAN_BLOCK);
+
+  TestJacobianStorage(NORMAL, JACOBIAN_MATRIX_FREE);
+  TestJacobianStorage(SLIDING, JACOBIAN_MATRIX_FREE);
+  TestJacobianStorage(SPINNING, JACOBIAN_MATRIX_FREE);
+
+  return 0;
+}
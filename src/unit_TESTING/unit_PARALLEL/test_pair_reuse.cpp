@@ -0,0 +1,86 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for the reuse of the broadphase pairs. A pile of
+// balls is dropped on a plate once with the broadphase run at every step and
+// once with the list of pairs reused until a ball moves past the skin, both
+// runs must generate the same contacts and produce the same positions.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 2000;
+
+double radius = 0.1;  // [m] radius of the falling balls
+double skin = 0.02;   // [m] distance the bounding boxes are grown by
+
+ChSystemParallelDEM* CreateSystem(double pair_reuse_skin, std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->GetSettings()->solver.tangential_displ_mode = MULTI_STEP;
+  system->GetSettings()->collision.pair_reuse_skin = pair_reuse_skin;
+
+  AddPlate(system, 0.4f);
+  for (int i = 0; i < 27; i++) {
+    ChVector<> pos(0.15 * (i % 3 - 1), 0.15 * (i / 3 % 3 - 1), 0.3 * (i / 9) + radius + 0.01 * (i % 2));
+    balls.push_back(AddBall(system, radius, 0.4f, pos));
+  }
+
+  return system;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  std::vector<ChSharedBodyPtr> balls_reference, balls_reuse;
+  ChSystemParallelDEM* reference = CreateSystem(0, balls_reference);
+  ChSystemParallelDEM* system = CreateSystem(skin, balls_reuse);
+
+  int reused_steps = 0;
+  for (int step = 0; step < num_steps; step++) {
+    reference->DoStepDynamics(time_step);
+    system->DoStepDynamics(time_step);
+    reused_steps += (system->data_manager->measures.collision.pairs_reused > 0);
+
+    StrictEqual(int(system->data_manager->num_rigid_contacts), int(reference->data_manager->num_rigid_contacts));
+    for (int i = 0; i < balls_reference.size(); i++) {
+      WeakEqual(ToReal3(balls_reuse[i]->GetPos()), ToReal3(balls_reference[i]->GetPos()), 1e-6);
+    }
+  }
+
+  // The reference system never reuses its pairs
+  cout << "Steps that reused the pairs: " << reused_steps << " of " << num_steps << endl;
+  StrictEqual(int(reference->data_manager->measures.collision.pairs_reused), 0);
+  StrictEqual(int(reused_steps > 0), 1);
+
+  delete reference;
+  delete system;
+  return 0;
+}
@@ -0,0 +1,106 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for the per phase thread tuning. The tuning is fed
+// synthetic phase times that only depend on the number of threads of the phase,
+// every phase must settle on the number of threads with the lowest time, with
+// the expected number of changes, and stay there when it explores again.
+//
+// =============================================================================
+
+#include <cmath>
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+int num_steps = 2000;
+int start_threads = 8;
+
+// Time of each phase with the given number of threads:
+// update: fastest with 4 threads
+// broadphase: fastest with 12 threads
+// narrowphase: the same with any number of threads
+// solver: faster with more threads, up to max_threads
+double PhaseTime(int phase, int threads) {
+  switch (phase) {
+    case PHASE_UPDATE:
+      return 1 + std::abs(threads - 4);
+    case PHASE_BROADPHASE:
+      return 1 + std::abs(threads - 12);
+    case PHASE_NARROWPHASE:
+      return 1;
+    default:
+      return 1 + (16 - threads);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(start_threads);
+
+  ChSystemParallelDVI* system = new ChSystemParallelDVI();
+  system->GetSettings()->min_threads = 1;
+  system->GetSettings()->max_threads = 16;
+  system->GetSettings()->tuning_window = 5;
+  system->GetSettings()->tuning_hold = 50;
+
+  const thread_measures& measures = system->data_manager->measures.threads;
+
+  // Accepted changes: update 8-6-4, broadphase 8-10-12, solver 8-10-12-14-16
+  int expected_threads[NUM_THREAD_PHASES] = {4, 12, 8, 16};
+  int expected_changes = 2 + 2 + 0 + 4;
+
+  int num_settled[NUM_THREAD_PHASES] = {0, 0, 0, 0};
+  bool was_settled[NUM_THREAD_PHASES] = {false, false, false, false};
+
+  for (int step = 0; step < num_steps; step++) {
+    double time[NUM_THREAD_PHASES];
+    for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+      int threads = measures.num_threads[p] == 0 ? start_threads : measures.num_threads[p];
+      time[p] = PhaseTime(p, threads);
+    }
+    system->UpdatePhaseThreads(time);
+
+    for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+      // A settled phase always uses its best number of threads, whichever trial
+      // it explored before
+      if (measures.settled[p]) {
+        StrictEqual(measures.num_threads[p], expected_threads[p]);
+        num_settled[p] += !was_settled[p];
+      }
+      was_settled[p] = measures.settled[p];
+    }
+  }
+
+  // Every phase settled again after exploring, without accepting a neighbouring
+  // number of threads on the way
+  for (int p = 0; p < NUM_THREAD_PHASES; p++) {
+    StrictEqual(num_settled[p] > 2 ? 1 : 0, 1);
+  }
+  StrictEqual(int(measures.num_changes), expected_changes);
+
+  system->PrintThreadReport();
+  cout << "Phase thread tuning: PASSED" << endl;
+
+  delete system;
+  return 0;
+}
@@ -0,0 +1,114 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for the removal of bodies from a parallel system.
+// Two piles of balls settle on two plates far apart from each other, the
+// bodies of one of the piles are interleaved with the bodies of the other one.
+// Midway through the simulation the second pile is removed and the first pile
+// must keep moving exactly like in a system that never contained the second.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 1000;
+int remove_step = 500;
+
+double radius = 0.1;     // [m] radius of the falling balls
+double offset_B = 10.0;  // [m] distance between the two piles
+
+ChSharedBodyPtr CreatePlate(ChSystemParallel* system, double x) {
+  ChSharedBodyPtr plate = AddPlate(system, 0.4f, ChVector<>(1, 1, 0.1), ChVector<>(x, 0, 0));
+  plate->SetMass(1000);
+  return plate;
+}
+
+ChSystemParallelDEM* CreateSystem() {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->GetSettings()->solver.tangential_displ_mode = MULTI_STEP;
+  return system;
+}
+
+// Position of the i-th ball of a pile, relative to its plate
+ChVector<> BallPosition(int i) {
+  return ChVector<>(0.15 * (i % 3 - 1), 0.15 * (i / 3 % 3 - 1), 0.3 * (i / 9) + radius + 0.01 * (i % 2));
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+  int num_balls = 27;
+
+  // The reference system only holds the first pile
+  ChSystemParallelDEM* reference = CreateSystem();
+  std::vector<ChSharedBodyPtr> reference_balls;
+  CreatePlate(reference, 0);
+  for (int i = 0; i < num_balls; i++) {
+    reference_balls.push_back(AddBall(reference, radius, 0.4f, BallPosition(i)));
+  }
+
+  // The bodies of the second pile are interleaved with those of the first one
+  ChSystemParallelDEM* system = CreateSystem();
+  std::vector<ChSharedBodyPtr> balls_A, bodies_B;
+  CreatePlate(system, 0);
+  bodies_B.push_back(CreatePlate(system, offset_B));
+  for (int i = 0; i < num_balls; i++) {
+    balls_A.push_back(AddBall(system, radius, 0.4f, BallPosition(i)));
+    bodies_B.push_back(AddBall(system, radius, 0.4f, BallPosition(i) + ChVector<>(offset_B, 0, 0)));
+  }
+
+  for (int step = 0; step < num_steps; step++) {
+    if (step == remove_step) {
+      for (int i = 0; i < bodies_B.size(); i++) {
+        system->RemoveBody(bodies_B[i]);
+      }
+    }
+
+    reference->DoStepDynamics(time_step);
+    system->DoStepDynamics(time_step);
+
+    for (int i = 0; i < num_balls; i++) {
+      WeakEqual(ToReal3(balls_A[i]->GetPos()), ToReal3(reference_balls[i]->GetPos()), 1e-10);
+    }
+  }
+
+  // After the removal both systems hold the same bodies and shapes
+  StrictEqual(system->GetNumBodies(), reference->GetNumBodies());
+  StrictEqual(int(system->data_manager->num_rigid_shapes), int(reference->data_manager->num_rigid_shapes));
+  for (int i = 0; i < num_balls; i++) {
+    StrictEqual(balls_A[i]->GetId(), reference_balls[i]->GetId());
+    StrictEqual(int(bodies_B[i]->GetSystem() == 0), 1);
+  }
+  StrictEqual(int(system->data_manager->host_data.shear_pair.size()),
+              int(reference->data_manager->host_data.shear_pair.size()));
+
+  delete reference;
+  delete system;
+  return 0;
+}
@@ -0,0 +1,110 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for sorting the bodies along a space filling curve.
+// Balls added in a random order slide down a tilted plate with contact history.
+// The system that reorders its bodies every few steps must produce the same
+// motion as a system that keeps the insertion order, and the stable ids must
+// keep pointing to the same bodies.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-4;
+int num_steps = 1000;
+
+double radius = 0.1;  // [m] radius of the falling balls
+
+ChSystemParallelDEM* CreateSystem(SPACEFILLINGCURVE curve, int frequency, std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDEM* system = new ChSystemParallelDEM();
+  InitializeSystem(system);
+  system->GetSettings()->solver.tangential_displ_mode = MULTI_STEP;
+  system->GetSettings()->reorder_frequency = frequency;
+  system->GetSettings()->reorder_curve = curve;
+
+  // The balls are placed on a 4x4 grid in a random order, they do not touch
+  // each other so the contact force on each ball does not depend on the order
+  std::vector<int> cells(16);
+  for (int i = 0; i < 16; i++) {
+    cells[i] = i;
+  }
+  srand(1);
+  std::random_shuffle(cells.begin(), cells.end());
+
+  for (int i = 0; i < 16; i++) {
+    ChVector<> pos(0.3 * (cells[i] % 4) - 0.45, 0.3 * (cells[i] / 4) - 0.45, radius + 0.01);
+    balls.push_back(AddBall(system, radius, 0.5f, pos));
+  }
+
+  // The plate is added last, sorting moves it in the middle of the balls
+  AddPlate(system, 0.5f, ChVector<>(2, 2, 0.1), ChVector<>(0, 0, 0), Q_from_AngY(0.2));
+
+  return system;
+}
+
+bool TestReorder(const std::string& name, SPACEFILLINGCURVE curve) {
+  std::vector<ChSharedBodyPtr> balls_reference, balls;
+  ChSystemParallelDEM* reference = CreateSystem(curve, 0, balls_reference);
+  ChSystemParallelDEM* system = CreateSystem(curve, 10, balls);
+
+  for (int step = 0; step < num_steps; step++) {
+    reference->DoStepDynamics(time_step);
+    system->DoStepDynamics(time_step);
+
+    for (int i = 0; i < balls.size(); i++) {
+      WeakEqual(ToReal3(balls[i]->GetPos()), ToReal3(balls_reference[i]->GetPos()), 1e-10);
+      WeakEqual(ToReal3(balls[i]->GetWvel_loc()), ToReal3(balls_reference[i]->GetWvel_loc()), 1e-10);
+    }
+  }
+
+  // The stable id of a body is its insertion order
+  int num_moved = 0;
+  for (int i = 0; i < balls.size(); i++) {
+    int index = balls[i]->GetId();
+    StrictEqual(system->GetBodyIndex(i), index);
+    StrictEqual(int(system->GetBodyStableId(index)), i);
+    num_moved += (index != i);
+  }
+  StrictEqual(int(num_moved > 0), 1);
+
+  cout << name << ": PASSED" << endl;
+
+  delete reference;
+  delete system;
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  TestReorder("Morton curve", CURVE_MORTON);
+  TestReorder("Hilbert curve", CURVE_HILBERT);
+
+  return 0;
+}
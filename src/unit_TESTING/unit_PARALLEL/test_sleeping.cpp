@@ -0,0 +1,115 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for sleeping bodies. A layer of balls settles on a
+// fixed plate and must be put to sleep, then a ball dropped on the layer must
+// wake up the whole layer, which fell asleep as a single island. Once
+// everything is at rest again all the balls must be sleeping. Removing the
+// plate must then wake up all the balls, which fall.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-3;
+double time_settle = 1.5;
+
+double radius = 0.1;  // [m] radius of the balls
+
+int CountSleeping(const std::vector<ChSharedBodyPtr>& balls) {
+  int count = 0;
+  for (int i = 0; i < balls.size(); i++) {
+    count += balls[i]->GetSleeping();
+  }
+  return count;
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  ChSystemParallelDVI* system = new ChSystemParallelDVI();
+  InitializeSystem(system);
+  system->GetSettings()->solver.solver_mode = SLIDING;
+  system->GetSettings()->solver.max_iteration_sliding = 50;
+  system->GetSettings()->collision.collision_envelope = 0.01;
+  system->GetSettings()->sleep.use_sleeping = true;
+  system->GetSettings()->sleep.min_speed = 1e-2;
+  system->GetSettings()->sleep.min_wvel = 1e-1;
+  system->GetSettings()->sleep.sleep_time = 0.2;
+
+  ChSharedBodyPtr plate = AddPlate(system, 0.5f);
+
+  std::vector<ChSharedBodyPtr> balls;
+  AddBallLayer(system, radius, 0.5f, balls);
+
+  while (system->GetChTime() < time_settle) {
+    system->DoStepDynamics(time_step);
+  }
+
+  cout << "Sleeping after settling: " << CountSleeping(balls) << " of " << balls.size() << endl;
+  StrictEqual(CountSleeping(balls), int(balls.size()));
+  StrictEqual(int(system->data_manager->measures.sleep.num_sleeping), int(balls.size()));
+
+  // Drop a ball in the hollow between the center ball and three of its neighbors
+  ChSharedBodyPtr center = balls[4];
+  balls.push_back(AddBall(system, radius, 0.5f, center->GetPos() + ChVector<>(radius, radius, 4 * radius)));
+
+  bool woken = false;
+  bool layer_woken = false;
+  while (system->GetChTime() < 2 * time_settle) {
+    system->DoStepDynamics(time_step);
+    woken |= !center->GetSleeping();
+    layer_woken |= CountSleeping(std::vector<ChSharedBodyPtr>(balls.begin(), balls.end() - 1)) == 0;
+  }
+
+  cout << "Center ball woken up: " << woken << ", whole layer: " << layer_woken << endl;
+  cout << "Sleeping at the end: " << CountSleeping(balls) << " of " << balls.size() << endl;
+  StrictEqual(int(woken), 1);
+  StrictEqual(int(layer_woken), 1);
+  StrictEqual(CountSleeping(balls), int(balls.size()));
+
+  // The plate never moves and the balls stay on top of it
+  for (int i = 0; i < balls.size(); i++) {
+    StrictEqual(int(balls[i]->GetPos().z > 0), 1);
+  }
+
+  // Without their support the balls wake up and fall below the plate level
+  system->RemoveBody(plate);
+  while (system->GetChTime() < 2 * time_settle + 0.3) {
+    system->DoStepDynamics(time_step);
+  }
+
+  cout << "Sleeping after removing the plate: " << CountSleeping(balls) << " of " << balls.size() << endl;
+  StrictEqual(CountSleeping(balls), 0);
+  for (int i = 0; i < balls.size(); i++) {
+    StrictEqual(int(balls[i]->GetPos().z < 0), 1);
+  }
+
+  delete system;
+  return 0;
+}
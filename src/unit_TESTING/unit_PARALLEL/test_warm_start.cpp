@@ -0,0 +1,138 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit test for warm starting the DVI solver. A layer of balls
+// settles on a plate once with the solver started from zero and once started
+// from the impulses of the previous step, both runs must produce the same
+// positions and the warm started run must need fewer iterations. A step without
+// iterations then checks that every contact starts from the impulses of the
+// same pair of shapes in the previous step.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#include <map>
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+#include "unit_testing_scenes.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+using std::cout;
+using std::endl;
+
+// -----------------------------------------------------------------------------
+// Global problem definitions
+// -----------------------------------------------------------------------------
+double time_step = 1e-3;
+int num_steps = 1000;
+
+double radius = 0.1;  // [m] radius of the balls
+
+ChSystemParallelDVI* CreateSystem(bool warm_start, std::vector<ChSharedBodyPtr>& balls) {
+  ChSystemParallelDVI* system = new ChSystemParallelDVI();
+  InitializeSystem(system);
+  system->GetSettings()->solver.solver_mode = SLIDING;
+  system->GetSettings()->solver.max_iteration_sliding = 200;
+  system->GetSettings()->solver.warm_start = warm_start;
+  system->GetSettings()->collision.collision_envelope = 0.01;
+
+  AddPlate(system, 0.5f);
+  AddBallLayer(system, radius, 0.5f, balls);
+
+  return system;
+}
+
+// Step without solver iterations, the impulses of every contact must be the
+// ones of the same pair of shapes in the previous step, or zero for a new pair.
+// Pairs with several contact points are matched in order.
+void TestMatching(ChSystemParallelDVI* system) {
+  ChParallelDataManager* data_manager = system->data_manager;
+  custom_vector<long long> previous_pairs = data_manager->host_data.pair_rigid_rigid;
+  DynamicVector<real> previous_gamma = data_manager->host_data.gamma;
+  uint num_previous = data_manager->num_rigid_contacts;
+
+  std::map<long long, std::vector<uint> > previous_index;
+  for (uint j = 0; j < num_previous; j++) {
+    previous_index[previous_pairs[j]].push_back(j);
+  }
+
+  system->GetSettings()->solver.max_iteration_sliding = 0;
+  system->DoStepDynamics(time_step);
+
+  const custom_vector<long long>& pairs = data_manager->host_data.pair_rigid_rigid;
+  const DynamicVector<real>& gamma = data_manager->host_data.gamma;
+  uint num_contacts = data_manager->num_rigid_contacts;
+
+  std::map<long long, uint> occurrence;
+  int num_matched = 0;
+  for (uint i = 0; i < num_contacts; i++) {
+    uint k = occurrence[pairs[i]]++;
+    real normal = 0, tangent_u = 0, tangent_v = 0;
+    if (previous_index.count(pairs[i]) && k < previous_index[pairs[i]].size()) {
+      uint j = previous_index[pairs[i]][k];
+      normal = previous_gamma[j];
+      tangent_u = previous_gamma[num_previous + j * 2 + 0];
+      tangent_v = previous_gamma[num_previous + j * 2 + 1];
+      num_matched++;
+    }
+    StrictEqual(gamma[i], normal);
+    StrictEqual(gamma[num_contacts + i * 2 + 0], tangent_u);
+    StrictEqual(gamma[num_contacts + i * 2 + 1], tangent_v);
+  }
+
+  // The layer is at rest, all its contacts were already there
+  StrictEqual(int(data_manager->measures.solver.warm_started_contacts), num_matched);
+  StrictEqual(num_matched, int(num_contacts));
+  StrictEqual(int(num_contacts > 0), 1);
+}
+
+int main(int argc, char* argv[]) {
+  omp_set_num_threads(1);
+
+  std::vector<ChSharedBodyPtr> balls_cold, balls_warm;
+  ChSystemParallelDVI* system_cold = CreateSystem(false, balls_cold);
+  ChSystemParallelDVI* system_warm = CreateSystem(true, balls_warm);
+
+  // Iterations of the second half of the run, once the layer is at rest
+  int iterations_cold = 0;
+  int iterations_warm = 0;
+  for (int step = 0; step < num_steps; step++) {
+    system_cold->DoStepDynamics(time_step);
+    system_warm->DoStepDynamics(time_step);
+    if (step >= num_steps / 2) {
+      iterations_cold += system_cold->data_manager->measures.solver.maxd_hist.size();
+      iterations_warm += system_warm->data_manager->measures.solver.maxd_hist.size();
+    }
+  }
+
+  for (int i = 0; i < balls_cold.size(); i++) {
+    WeakEqual(ToReal3(balls_warm[i]->GetPos()), ToReal3(balls_cold[i]->GetPos()), 1e-3);
+  }
+  cout << "Iterations at rest: " << iterations_warm << " warm started, " << iterations_cold << " from zero" << endl;
+  StrictEqual(int(system_cold->data_manager->measures.solver.warm_started_contacts), 0);
+  StrictEqual(int(iterations_warm < iterations_cold), 1);
+
+  TestMatching(system_warm);
+
+  cout << "Warm start: PASSED" << endl;
+
+  delete system_cold;
+  delete system_warm;
+  return 0;
+}
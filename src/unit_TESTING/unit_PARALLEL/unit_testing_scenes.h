@@ -0,0 +1,163 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Hammad Mazhar
+// =============================================================================
+//
+// ChronoParallel unit testing scenes shared by the system tests: plates, balls
+// and a container filled with granular material. The bodies use the contact
+// method of the system they are created for.
+// The global reference frame has Z up.
+// All units SI (CGS, i.e., centimeter - gram - second)
+//
+// =============================================================================
+
+#ifndef UNIT_TESTING_SCENES_H
+#define UNIT_TESTING_SCENES_H
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "chrono_utils/ChUtilsCreators.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Settings common to all of the test systems: gravity along -Z, a 10x10x10
+// grid and a single thread without thread tuning
+void InitializeSystem(ChSystemParallel* system) {
+  system->Set_G_acc(ChVector<>(0, 0, -9.81));
+  system->GetSettings()->collision.bins_per_axis = I3(10, 10, 10);
+  system->GetSettings()->max_threads = 1;
+  system->GetSettings()->perform_thread_tuning = false;
+}
+
+// Body using the contact method of the system, not added to the system
+ChSharedBodyPtr CreateBody(ChSystemParallel* system, float friction) {
+  ChBody::ContactMethod method = system->GetContactMethod();
+  ChSharedBodyPtr body(new ChBody(new ChCollisionModelParallel, method));
+  if (method == ChBody::DEM) {
+    body->GetMaterialSurfaceDEM()->SetFriction(friction);
+  } else {
+    ChSharedPtr<ChMaterialSurface> mat(new ChMaterialSurface);
+    mat->SetFriction(friction);
+    body->SetMaterialSurface(mat);
+  }
+  return body;
+}
+
+// Fixed box with half dimensions hdim, the top face of the box goes through
+// the position of the plate
+ChSharedBodyPtr AddPlate(ChSystemParallel* system,
+                         float friction,
+                         const ChVector<>& hdim = ChVector<>(1, 1, 0.1),
+                         const ChVector<>& pos = ChVector<>(0, 0, 0),
+                         const ChQuaternion<>& rot = QUNIT) {
+  ChSharedBodyPtr plate = CreateBody(system, friction);
+  plate->SetPos(pos);
+  plate->SetRot(rot);
+  plate->SetBodyFixed(true);
+  plate->SetCollide(true);
+
+  plate->GetCollisionModel()->ClearModel();
+  utils::AddBoxGeometry(plate.get_ptr(), hdim, ChVector<>(0, 0, -hdim.z));
+  plate->GetCollisionModel()->BuildModel();
+
+  system->AddBody(plate);
+  return plate;
+}
+
+// Ball of unit mass, not added to the system so that its initial state can
+// still be changed when the state of the bodies is kept in the data manager
+ChSharedBodyPtr CreateBall(ChSystemParallel* system, double radius, float friction, const ChVector<>& pos) {
+  double mass = 1;
+  ChSharedBodyPtr ball = CreateBody(system, friction);
+  ball->SetMass(mass);
+  ball->SetInertiaXX((2.0 / 5.0) * mass * radius * radius * ChVector<>(1, 1, 1));
+  ball->SetPos(pos);
+  ball->SetCollide(true);
+
+  ball->GetCollisionModel()->ClearModel();
+  utils::AddSphereGeometry(ball.get_ptr(), radius);
+  ball->GetCollisionModel()->BuildModel();
+
+  return ball;
+}
+
+ChSharedBodyPtr AddBall(ChSystemParallel* system, double radius, float friction, const ChVector<>& pos) {
+  ChSharedBodyPtr ball = CreateBall(system, radius, friction, pos);
+  system->AddBody(ball);
+  return ball;
+}
+
+// Single 3x3 layer of balls just above z = 0, each ball touching its neighbors
+void AddBallLayer(ChSystemParallel* system, double radius, float friction, std::vector<ChSharedBodyPtr>& balls) {
+  for (int ix = -1; ix <= 1; ix++) {
+    for (int iy = -1; iy <= 1; iy++) {
+      balls.push_back(AddBall(system, radius, friction, ChVector<>(2 * radius * ix, 2 * radius * iy, radius + 0.01)));
+    }
+  }
+}
+
+// Box open at the top with half dimensions hdim and walls of half thickness
+// hthick, the floor of the box is at z = 0
+void CreateContainer(ChSystemParallel* system, const ChVector<>& hdim, double hthick) {
+  ChSharedBodyPtr container = CreateBody(system, 0.3f);
+  container->SetIdentifier(-1);
+  container->SetBodyFixed(true);
+  container->SetCollide(true);
+  container->SetMass(10000.0);
+
+  double hdimX = hdim.x, hdimY = hdim.y, hdimZ = hdim.z;
+  container->GetCollisionModel()->ClearModel();
+  utils::AddBoxGeometry(container.get_ptr(), ChVector<>(hdimX, hdimY, hthick), ChVector<>(0, 0, -hthick));
+  utils::AddBoxGeometry(container.get_ptr(), ChVector<>(hthick, hdimY, hdimZ), ChVector<>(-hdimX - hthick, 0, hdimZ));
+  utils::AddBoxGeometry(container.get_ptr(), ChVector<>(hthick, hdimY, hdimZ), ChVector<>(hdimX + hthick, 0, hdimZ));
+  utils::AddBoxGeometry(container.get_ptr(), ChVector<>(hdimX, hthick, hdimZ), ChVector<>(0, -hdimY - hthick, hdimZ));
+  utils::AddBoxGeometry(container.get_ptr(), ChVector<>(hdimX, hthick, hdimZ), ChVector<>(0, hdimY + hthick, hdimZ));
+  container->GetCollisionModel()->BuildModel();
+
+  system->AddBody(container);
+}
+
+// 5x5x5 block of balls 0.35 apart, slightly perturbed with a fixed seed
+void CreateGranularMaterial(ChSystemParallel* system, double radius) {
+  int ballId = 0;
+  srand(1);
+
+  for (int ix = -2; ix < 3; ix++) {
+    for (int iy = -2; iy < 3; iy++) {
+      for (int iz = 0; iz < 5; iz++) {
+        ChVector<> rnd(rand() % 1000 / 100000.0, rand() % 1000 / 100000.0, rand() % 1000 / 100000.0);
+        ChVector<> pos(0.35 * ix, 0.35 * iy, 0.35 * iz + radius);
+
+        ChSharedBodyPtr ball = CreateBall(system, radius, 0.5f, pos + rnd);
+        ball->SetIdentifier(ballId++);
+        system->AddBody(ball);
+      }
+    }
+  }
+}
+
+// DVI system with balls of radius 0.15 falling in a 2x2x2 container
+ChSystemParallelDVI* CreateGranularSystem() {
+  ChSystemParallelDVI* system = new ChSystemParallelDVI();
+  InitializeSystem(system);
+  system->GetSettings()->solver.solver_mode = SLIDING;
+  system->GetSettings()->solver.max_iteration_sliding = 25;
+  system->GetSettings()->collision.collision_envelope = 0.01;
+
+  CreateContainer(system, ChVector<>(1, 1, 1), 0.05);
+  CreateGranularMaterial(system, 0.15);
+
+  return system;
+}
+
+#endif